@@ -0,0 +1,477 @@
+// Native microbenchmarks of the NetLink core, without node in the way: loopback
+// TCP throughput and round trips, UDP datagrams per second, SmartBuffer::read
+// growth, SocketGroup::listen dispatch, and accepting connections. Each one runs
+// for a fixed time and the results come out as a single JSON document on
+// stdout, to be kept and compared between builds.
+//
+// build: node-gyp rebuild --nl_bench=true
+// usage: build/Release/netlink_bench [seconds=1] [benchmark...]
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <sys/resource.h>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "netlink/exception.h"
+#include "netlink/latency.h"
+#include "netlink/smart_buffer.h"
+#include "netlink/socket.h"
+#include "netlink/socket_group.h"
+
+#define HOST "127.0.0.1"
+#define TCP_PORT 40407
+#define UDP_SENDER_PORT 40408
+#define UDP_RECEIVER_PORT 40409
+#define ACCEPT_PORT 40410
+
+// one benchmark's results, in the order they are printed
+using Result = std::vector<std::pair<std::string, double>>;
+
+struct Benchmark
+{
+    const char *name;
+    std::function<Result(double)> run;
+};
+
+unsigned long long now()
+{
+    return NL::LatencyHistogram::now();
+}
+
+unsigned long long deadline(double seconds)
+{
+    return now() + static_cast<unsigned long long>(seconds * 1e9);
+}
+
+double per_second(double count, unsigned long long nanosec)
+{
+    return nanosec ? count * 1e9 / nanosec : 0;
+}
+
+void read_exactly(NL::Socket &socket, char *buffer, size_t size)
+{
+    size_t got = 0;
+    while (got < size)
+    {
+        int status = socket.read(buffer + got, size - got);
+        if (status <= 0)
+        {
+            throw NL::Exception(NL::Exception::ERROR_READ, "read_exactly: disconnected");
+        }
+        got += status;
+    }
+}
+
+Result tcp_throughput(double seconds)
+{
+    const size_t chunk = 65536;
+
+    NL::Socket server(TCP_PORT, NL::TCP, NL::IP4, HOST);
+    std::unique_ptr<NL::Socket> client(new NL::Socket(HOST, TCP_PORT, NL::TCP, NL::IP4));
+    std::unique_ptr<NL::Socket> accepted(server.accept());
+
+    std::atomic<bool> stop(false);
+    std::thread sender([&] {
+        std::vector<char> data(chunk, 1);
+        while (!stop.load(std::memory_order_relaxed))
+        {
+            client->send(data.data(), data.size());
+        }
+        client->disconnect();
+    });
+
+    std::vector<char> buffer(chunk);
+    double received = 0;
+    unsigned long long start = now();
+    unsigned long long end = deadline(seconds);
+    while (now() < end)
+    {
+        received += accepted->read(buffer.data(), buffer.size());
+    }
+    unsigned long long elapsed = now() - start;
+
+    // drain until the sender sees the flag and hangs up
+    stop = true;
+    while (accepted->read(buffer.data(), buffer.size()) > 0)
+    {
+    }
+    sender.join();
+
+    return {
+        {"chunkBytes", chunk},
+        {"mbPerSec", per_second(received, elapsed) / 1e6},
+    };
+}
+
+Result tcp_ping_pong(double seconds)
+{
+    const size_t size = 64;
+
+    NL::Socket server(TCP_PORT, NL::TCP, NL::IP4, HOST);
+    std::unique_ptr<NL::Socket> client(new NL::Socket(HOST, TCP_PORT, NL::TCP, NL::IP4));
+    std::unique_ptr<NL::Socket> accepted(server.accept());
+
+    std::thread echo([&] {
+        char message[size];
+        try
+        {
+            for (;;)
+            {
+                read_exactly(*accepted, message, size);
+                accepted->send(message, size);
+            }
+        }
+        catch (NL::Exception &)
+        {
+            // the client hung up
+        }
+    });
+
+    NL::LatencyHistogram histogram;
+    char message[size] = {};
+    unsigned long long start = now();
+    unsigned long long end = deadline(seconds);
+    while (now() < end)
+    {
+        unsigned long long sent = now();
+        client->send(message, size);
+        read_exactly(*client, message, size);
+        histogram.record(now() - sent);
+    }
+    unsigned long long elapsed = now() - start;
+
+    client->disconnect();
+    echo.join();
+
+    return {
+        {"messageBytes", size},
+        {"roundTripsPerSec", per_second(histogram.count(), elapsed)},
+        {"p50Ns", histogram.percentile(50)},
+        {"p99Ns", histogram.percentile(99)},
+        {"p999Ns", histogram.percentile(99.9)},
+    };
+}
+
+Result udp_datagrams(double seconds)
+{
+    // each batch is sent and then read back, so none are dropped for a full
+    // receive buffer and the two calls are timed apart
+    const size_t size = 64;
+    const unsigned batch = 64;
+
+    NL::Socket sender(UDP_SENDER_PORT, NL::UDP, NL::IP4, HOST);
+    NL::Socket receiver(UDP_RECEIVER_PORT, NL::UDP, NL::IP4, HOST);
+    receiver.blocking(false);
+
+    char datagram[size] = {};
+    std::string host_from;
+    unsigned port_from;
+    double sent = 0;
+    double received = 0;
+    unsigned long long sending = 0;
+    unsigned long long receiving = 0;
+
+    unsigned long long end = deadline(seconds);
+    while (now() < end)
+    {
+        unsigned long long start = now();
+        for (unsigned i = 0; i < batch; i++)
+        {
+            sender.sendTo(datagram, size, HOST, UDP_RECEIVER_PORT);
+        }
+        sent += batch;
+
+        unsigned long long middle = now();
+        while (receiver.readFrom(datagram, size, &host_from, &port_from) > 0)
+        {
+            received++;
+        }
+        receiving += now() - middle;
+        sending += middle - start;
+    }
+
+    return {
+        {"datagramBytes", size},
+        {"sendToPerSec", per_second(sent, sending)},
+        {"readFromPerSec", per_second(received, receiving)},
+        {"deliveredPercent", sent ? received / sent * 100 : 0},
+    };
+}
+
+Result smart_buffer_read(double seconds)
+{
+    // messages of each size are gathered in a SmartBuffer, either a new one per
+    // message that grows from the default size, or one kept and cleared. The
+    // next message is only sent once the last one is read, so the buffer holds
+    // a single message
+    const size_t sizes[] = {4096, 65536, 1048576};
+    Result result;
+
+    for (size_t size : sizes)
+    {
+        for (bool reuse : {false, true})
+        {
+            NL::Socket *first;
+            NL::Socket *second;
+            NL::Socket::unixPair(&first, &second);
+            std::unique_ptr<NL::Socket> writer(first);
+            std::unique_ptr<NL::Socket> reader(second);
+
+            std::atomic<unsigned> requested(0);
+            std::atomic<bool> stop(false);
+            std::thread sender([&] {
+                std::vector<char> data(size, 1);
+                for (unsigned sent = 0; !stop; sent++)
+                {
+                    while (requested == sent && !stop)
+                    {
+                        std::this_thread::yield();
+                    }
+                    if (!stop)
+                    {
+                        writer->send(data.data(), data.size());
+                    }
+                }
+            });
+
+            NL::SmartBuffer kept;
+            double messages = 0;
+            size_t capacity = 0;
+            unsigned long long start = now();
+            unsigned long long end = deadline(seconds / 6);
+            while (now() < end)
+            {
+                NL::SmartBuffer fresh;
+                NL::SmartBuffer &buffer = reuse ? kept : fresh;
+                requested++;
+                while (buffer.size() < size)
+                {
+                    buffer.read(reader.get());
+                }
+                capacity = buffer.capacity();
+                buffer.clear();
+                messages++;
+            }
+            unsigned long long elapsed = now() - start;
+
+            stop = true;
+            sender.join();
+
+            std::string key = (reuse ? "reused" : "fresh") + std::to_string(size);
+            result.push_back({key + "MbPerSec", per_second(messages * size, elapsed) / 1e6});
+            result.push_back({key + "Capacity", capacity});
+        }
+    }
+
+    return result;
+}
+
+class ReadOne : public NL::SocketGroupCmd
+{
+    void exec(NL::Socket *socket, NL::SocketGroup *group, void *reference)
+    {
+        char byte;
+        socket->read(&byte, 1);
+    }
+};
+
+Result group_listen(double seconds)
+{
+    // all but one socket of the group stay idle, the cost is finding the one
+    // that is readable, with each backend
+    const unsigned counts[] = {10, 1000, 10000};
+    const std::pair<const char *, NL::GroupBackend> backends[] = {
+        {"select", NL::GROUP_SELECT},
+        {"poll", NL::GROUP_POLL},
+    };
+    Result result;
+
+    for (unsigned count : counts)
+    {
+        NL::Socket *first;
+        NL::Socket *second;
+        NL::Socket::unixPair(&first, &second);
+        std::unique_ptr<NL::Socket> writer(first);
+        std::unique_ptr<NL::Socket> reader(second);
+
+        std::vector<std::unique_ptr<NL::Socket>> idle;
+        for (unsigned i = 1; i < count; i++)
+        {
+            idle.emplace_back(new NL::Socket(0, NL::UDP, NL::IP4, HOST));
+        }
+
+        for (const auto &backend : backends)
+        {
+            std::string key = backend.first + std::to_string(count);
+
+            NL::SocketGroup group(backend.second);
+            ReadOne read_one;
+            group.setCmdOnRead(&read_one);
+            group.add(reader.get());
+            for (auto &socket : idle)
+            {
+                group.add(socket.get());
+            }
+
+            try
+            {
+                // throws before anything is sent if the backend can not take them
+                group.listen(0);
+            }
+            catch (NL::Exception &)
+            {
+                result.push_back({key + "Skipped", 1});
+                continue;
+            }
+
+            double listens = 0;
+            unsigned long long start = now();
+            unsigned long long end = deadline(seconds / 6);
+            while (now() < end)
+            {
+                writer->send("x", 1);
+                group.listen(0);
+                listens++;
+            }
+            unsigned long long elapsed = now() - start;
+
+            result.push_back({key + "Ns", listens ? elapsed / listens : 0});
+        }
+    }
+
+    return result;
+}
+
+Result accept_rate(double seconds)
+{
+    // clients connect in batches the listen queue holds, then are accepted;
+    // capped so the closed ones do not use up the ephemeral ports
+    const unsigned batch = 64;
+    const double cap = 16384;
+
+    NL::Socket server(ACCEPT_PORT, NL::TCP, NL::IP4, HOST, batch);
+
+    double connections = 0;
+    unsigned long long connecting = 0;
+    unsigned long long accepting = 0;
+
+    unsigned long long end = deadline(seconds);
+    while (now() < end && connections < cap)
+    {
+        std::vector<std::unique_ptr<NL::Socket>> clients;
+        std::vector<std::unique_ptr<NL::Socket>> accepted;
+
+        unsigned long long start = now();
+        for (unsigned i = 0; i < batch; i++)
+        {
+            clients.emplace_back(new NL::Socket(HOST, ACCEPT_PORT, NL::TCP, NL::IP4));
+        }
+
+        unsigned long long middle = now();
+        for (unsigned i = 0; i < batch; i++)
+        {
+            accepted.emplace_back(server.accept());
+        }
+        accepting += now() - middle;
+        connecting += middle - start;
+        connections += batch;
+    }
+
+    return {
+        {"connectsPerSec", per_second(connections, connecting)},
+        {"acceptsPerSec", per_second(connections, accepting)},
+    };
+}
+
+std::string json_string(const std::string &str)
+{
+    std::string quoted = "\"";
+    for (char c : str)
+    {
+        if (c == '"' || c == '\\')
+        {
+            quoted += '\\';
+        }
+        quoted += (c < 0x20) ? ' ' : c;
+    }
+
+    return quoted + "\"";
+}
+
+void raise_file_limit()
+{
+    // for the largest socket groups
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max)
+    {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const Benchmark benchmarks[] = {
+        {"tcp_throughput", tcp_throughput},
+        {"tcp_ping_pong", tcp_ping_pong},
+        {"udp_datagrams", udp_datagrams},
+        {"smart_buffer_read", smart_buffer_read},
+        {"group_listen", group_listen},
+        {"accept_rate", accept_rate},
+    };
+
+    double seconds = argc > 1 ? std::atof(argv[1]) : 0;
+    if (seconds <= 0)
+    {
+        seconds = 1;
+    }
+
+    raise_file_limit();
+
+    std::ostringstream out;
+    out.precision(10);
+    out << "{\"seconds\":" << seconds << ",\"benchmarks\":[";
+
+    bool first = true;
+    for (const Benchmark &benchmark : benchmarks)
+    {
+        bool selected = argc <= 2;
+        for (int i = 2; i < argc; i++)
+        {
+            selected = selected || std::strcmp(argv[i], benchmark.name) == 0;
+        }
+        if (!selected)
+        {
+            continue;
+        }
+
+        out << (first ? "" : ",") << "{\"name\":" << json_string(benchmark.name);
+        first = false;
+
+        try
+        {
+            for (const auto &value : benchmark.run(seconds))
+            {
+                out << "," << json_string(value.first) << ":" << value.second;
+            }
+        }
+        catch (NL::Exception &err)
+        {
+            out << ",\"error\":" << json_string(err.msg());
+        }
+
+        out << "}";
+    }
+
+    out << "]}";
+    std::cout << out.str() << std::endl;
+
+    return 0;
+}
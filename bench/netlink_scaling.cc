@@ -0,0 +1,310 @@
+// Connection scaling of the NetLink core: opens up to 100k loopback connections
+// to one server and, at every tenfold step from 100, measures how fast they are
+// accepted, the memory each idle one takes, and for a SocketGroup of all the
+// accepted sockets, with each backend that can wait for them, the p99 time to
+// wake up for one that became readable and the CPU time per readable socket
+// when 1% of them are. The results come out as a single JSON document.
+//
+// The file descriptor limit is raised to its hard limit, each connection taking
+// two, and clients connect from several loopback addresses so the ephemeral
+// ports of one do not run out. Where a limit is hit, it stops and says so.
+//
+// build: node-gyp rebuild --nl_bench=true
+// usage: build/Release/netlink_scaling [maxConnections=100000]
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <vector>
+#include "netlink/exception.h"
+#include "netlink/latency.h"
+#include "netlink/socket.h"
+#include "netlink/socket_group.h"
+
+#define HOST "127.0.0.1"
+#define PORT 40414
+#define BATCH 256
+#define SOURCE_ADDRESSES 8
+#define WAKEUPS 200
+#define ACTIVE_ROUNDS 20
+
+struct Backend
+{
+    const char *name;
+    NL::GroupBackend backend;
+};
+
+const Backend backends[] = {
+    {"select", NL::GROUP_SELECT},
+    {"poll", NL::GROUP_POLL},
+};
+
+class ReadOne : public NL::SocketGroupCmd
+{
+public:
+    unsigned reads = 0;
+
+    void exec(NL::Socket *socket, NL::SocketGroup *group, void *reference)
+    {
+        char byte;
+        socket->read(&byte, 1);
+        reads++;
+    }
+};
+
+unsigned long long cpu_time()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000000ULL +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1000ULL;
+}
+
+double resident_bytes()
+{
+    std::ifstream statm("/proc/self/statm");
+    double size = 0, resident = 0;
+    statm >> size >> resident;
+    return resident * sysconf(_SC_PAGESIZE);
+}
+
+double kernel_bytes()
+{
+    // idle sockets have no buffers, what they take is in the kernel's slab
+    // caches, shared by the whole system
+    std::ifstream meminfo("/proc/meminfo");
+    std::string word;
+    while (meminfo >> word)
+    {
+        if (word == "Slab:")
+        {
+            double kilobytes = 0;
+            meminfo >> kilobytes;
+            return kilobytes * 1024;
+        }
+    }
+
+    return 0;
+}
+
+std::string json_string(const std::string &str)
+{
+    std::string quoted = "\"";
+    for (char c : str)
+    {
+        if (c == '"' || c == '\\')
+        {
+            quoted += '\\';
+        }
+        quoted += (c < 0x20) ? ' ' : c;
+    }
+
+    return quoted + "\"";
+}
+
+rlim_t raise_file_limit()
+{
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0)
+    {
+        return 0;
+    }
+    if (limit.rlim_cur < limit.rlim_max)
+    {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    return limit.rlim_cur;
+}
+
+// times waking up for one readable socket, from the send of its peer to its
+// read in the callback. The send is from this thread, so it is how long
+// listen() takes to find it among all the others
+void measure_wakeups(NL::SocketGroup &group, ReadOne &read_one,
+                     std::vector<std::unique_ptr<NL::Socket>> &clients,
+                     std::ostringstream &out)
+{
+    NL::LatencyHistogram histogram;
+    for (unsigned i = 0; i < WAKEUPS; i++)
+    {
+        NL::Socket &client = *clients[std::rand() % clients.size()];
+        unsigned reads = read_one.reads;
+
+        unsigned long long start = NL::LatencyHistogram::now();
+        client.send("x", 1);
+        while (read_one.reads == reads)
+        {
+            group.listen(0);
+        }
+        histogram.record(NL::LatencyHistogram::now() - start);
+    }
+
+    out << ",\"wakeupP50Ns\":" << histogram.percentile(50)
+        << ",\"wakeupP99Ns\":" << histogram.percentile(99);
+}
+
+// CPU time of the dispatching when 1% of the sockets are readable at once
+void measure_active(NL::SocketGroup &group, ReadOne &read_one,
+                    std::vector<std::unique_ptr<NL::Socket>> &clients,
+                    std::ostringstream &out)
+{
+    size_t active = clients.size() / 100 ? clients.size() / 100 : 1;
+    unsigned long long cpu = 0;
+
+    for (unsigned round = 0; round < ACTIVE_ROUNDS; round++)
+    {
+        size_t first = std::rand() % clients.size();
+        for (size_t i = 0; i < active; i++)
+        {
+            clients[(first + i) % clients.size()]->send("x", 1);
+        }
+
+        unsigned long long start = cpu_time();
+        unsigned target = read_one.reads + active;
+        while (read_one.reads < target)
+        {
+            group.listen(0);
+        }
+        cpu += cpu_time() - start;
+    }
+
+    out << ",\"activeSockets\":" << active
+        << ",\"cpuNsPerActive\":" << cpu / (double)(active * ACTIVE_ROUNDS);
+}
+
+int main(int argc, char *argv[])
+{
+    size_t max_connections = argc > 1 ? std::atol(argv[1]) : 0;
+    if (!max_connections)
+    {
+        max_connections = 100000;
+    }
+
+    rlim_t file_limit = raise_file_limit();
+
+    NL::ConnectOptions options;
+    for (unsigned i = 1; i <= SOURCE_ADDRESSES; i++)
+    {
+        options.hostsFrom.push_back("127.0.0." + std::to_string(i));
+    }
+
+    std::ostringstream out;
+    out.precision(10);
+    out << "{\"maxConnections\":" << max_connections
+        << ",\"fileLimit\":" << file_limit << ",\"steps\":[";
+
+    std::vector<std::unique_ptr<NL::Socket>> clients;
+    std::vector<std::unique_ptr<NL::Socket>> accepted;
+    std::string stopped;
+
+    try
+    {
+        NL::Socket server(PORT, NL::TCP, NL::IP4, HOST, BATCH);
+
+        double base_resident = resident_bytes();
+        double base_kernel = kernel_bytes();
+        bool first_step = true;
+
+        for (size_t step = 100; step <= max_connections && stopped.empty(); step *= 10)
+        {
+            unsigned long long accepting = 0;
+            size_t opened = clients.size();
+
+            try
+            {
+                while (clients.size() < step)
+                {
+                    size_t batch = std::min((size_t)BATCH, step - clients.size());
+                    for (size_t i = 0; i < batch; i++)
+                    {
+                        clients.emplace_back(new NL::Socket(HOST, PORT, options, NL::IP4));
+                    }
+
+                    unsigned long long start = NL::LatencyHistogram::now();
+                    while (accepted.size() < clients.size())
+                    {
+                        NL::Socket *socket;
+                        NL::IOResult result = server.tryAccept(&socket);
+                        if (result.status != NL::IO_DONE)
+                        {
+                            throw NL::Exception(NL::Exception::ERROR_CONNECT_SOCKET,
+                                                "could not accept: " + std::string(strerror(result.error)));
+                        }
+                        accepted.emplace_back(socket);
+                    }
+                    accepting += NL::LatencyHistogram::now() - start;
+                }
+            }
+            catch (NL::Exception &err)
+            {
+                stopped = err.msg();
+                // the unaccepted ones are of no use
+                clients.resize(accepted.size());
+            }
+
+            size_t connections = accepted.size();
+            if (connections == opened)
+            {
+                break;
+            }
+
+            out << (first_step ? "" : ",") << "{\"connections\":" << connections
+                << ",\"acceptsPerSec\":" << (accepting ? (connections - opened) * 1e9 / accepting : 0)
+                << ",\"residentBytesPerConnection\":" << (resident_bytes() - base_resident) / connections
+                << ",\"kernelBytesPerConnection\":" << (kernel_bytes() - base_kernel) / connections;
+            first_step = false;
+
+            for (const Backend &backend : backends)
+            {
+                out << "," << json_string(backend.name) << ":{";
+
+                NL::SocketGroup group(backend.backend);
+                ReadOne read_one;
+                group.setCmdOnRead(&read_one);
+                for (auto &socket : accepted)
+                {
+                    group.add(socket.get());
+                }
+
+                try
+                {
+                    out << "\"sockets\":" << group.size();
+                    // throws before anything is sent if the backend can not take them
+                    group.listen(0);
+                    measure_wakeups(group, read_one, clients, out);
+                    measure_active(group, read_one, clients, out);
+                }
+                catch (NL::Exception &err)
+                {
+                    out << ",\"error\":" << json_string(err.msg());
+                }
+
+                out << "}";
+            }
+
+            out << "}";
+        }
+    }
+    catch (NL::Exception &err)
+    {
+        stopped = err.msg();
+    }
+
+    out << "]";
+    if (!stopped.empty())
+    {
+        out << ",\"stopped\":" << json_string(stopped);
+    }
+    out << "}";
+    std::cout << out.str() << std::endl;
+
+    return 0;
+}
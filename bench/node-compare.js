@@ -0,0 +1,241 @@
+// Measures round trips through the whole JS to C++ path, argument parsing and
+// Buffer creation included, against node's own net and dgram as a baseline. A
+// forked process runs net/dgram echo servers on loopback, like the ones of the
+// tests, and each client sends a message and waits for all of it to come back,
+// for message sizes from 16 bytes to 1 MB, UDP ones up to the largest datagram.
+//
+// Allocations are the bytes of JS heap and Buffer memory allocated for each
+// round trip, from a separate run as sampling them slows the calls down.
+//
+// usage: node bench/node-compare.js [seconds=0.5] [sizes=16,256,...,1048576]
+
+const { fork } = require("child_process");
+const { createConnection, createServer } = require("net");
+const { createSocket } = require("dgram");
+const { SocketClientTCP, SocketUDP, WOULD_BLOCK } = require("../lib");
+
+const HOST = "127.0.0.1";
+const TCP_PORT = 40411;
+const UDP_PORT = 40412;
+const UDP_CLIENT_PORT = 40413;
+const MAX_DATAGRAM = 65507;
+const ALLOCATION_ROUND_TRIPS = 200;
+
+function echo() {
+    const server = createServer((socket) => {
+        // echo what arrived right away, not once the last part is acknowledged
+        socket.setNoDelay(true);
+        socket.on("data", (data) => socket.write(data));
+        socket.on("error", () => socket.destroy());
+    });
+    const udp = createSocket("udp4");
+    udp.on("message", (data, remote) =>
+        udp.send(data, remote.port, remote.address),
+    );
+
+    server.listen(TCP_PORT, HOST, () =>
+        udp.bind(UDP_PORT, HOST, () => process.send("listening")),
+    );
+    process.on("disconnect", () => process.exit());
+}
+
+// one round trip of each client, returning once the whole echo arrived
+const clients = {
+    tcp: {
+        netlinkwrapper(blocking) {
+            const socket = new SocketClientTCP(TCP_PORT, HOST);
+            socket.isBlocking = blocking;
+
+            return {
+                roundTrip(message) {
+                    let received = 0;
+                    if (blocking) {
+                        socket.send(message);
+                        while (received < message.length) {
+                            received += socket.receive().length;
+                        }
+                        return;
+                    }
+
+                    // send and receive in turns, so neither side fills up
+                    let sent = 0;
+                    while (received < message.length) {
+                        if (sent < message.length) {
+                            const result = socket.trySend(
+                                message.subarray(sent),
+                            );
+                            if (result !== WOULD_BLOCK) {
+                                sent += result;
+                            }
+                        }
+                        const data = socket.tryReceive();
+                        if (data !== WOULD_BLOCK) {
+                            received += data.length;
+                        }
+                    }
+                },
+                close: () => socket.disconnect(),
+            };
+        },
+        async net() {
+            const socket = createConnection(TCP_PORT, HOST);
+            await new Promise((resolve) => socket.once("connect", resolve));
+
+            return {
+                roundTrip: (message) =>
+                    new Promise((resolve) => {
+                        let received = 0;
+                        const onData = (data) => {
+                            received += data.length;
+                            if (received >= message.length) {
+                                socket.off("data", onData);
+                                resolve();
+                            }
+                        };
+                        socket.on("data", onData);
+                        socket.write(message);
+                    }),
+                close: () => socket.destroy(),
+            };
+        },
+    },
+    udp: {
+        netlinkwrapper(blocking) {
+            const socket = new SocketUDP(UDP_CLIENT_PORT, HOST);
+            socket.isBlocking = blocking;
+
+            return {
+                roundTrip(message) {
+                    if (blocking) {
+                        socket.sendTo(HOST, UDP_PORT, message);
+                        socket.receiveFrom();
+                        return;
+                    }
+
+                    while (
+                        socket.trySendTo(HOST, UDP_PORT, message) ===
+                        WOULD_BLOCK
+                    ) {
+                        // the send buffer is full
+                    }
+                    while (!socket.receiveFrom()) {
+                        // not back yet
+                    }
+                },
+                close: () => socket.disconnect(),
+            };
+        },
+        async dgram() {
+            const socket = createSocket("udp4");
+            await new Promise((resolve) => socket.bind(0, HOST, resolve));
+
+            return {
+                roundTrip: (message) =>
+                    new Promise((resolve) => {
+                        socket.once("message", resolve);
+                        socket.send(message, UDP_PORT, HOST);
+                    }),
+                close: () => socket.close(),
+            };
+        },
+    },
+};
+
+function allocated() {
+    const usage = process.memoryUsage();
+    return usage.heapUsed + usage.arrayBuffers;
+}
+
+function percentile(sorted, ratio) {
+    const index = Math.floor(sorted.length * ratio);
+    return sorted[Math.min(sorted.length - 1, index)];
+}
+
+async function measure(protocol, client, mode, size, seconds) {
+    const create = clients[protocol][client];
+    const socket = await create(mode === "blocking");
+    const message = Buffer.alloc(size, 1);
+
+    const times = [];
+    const start = process.hrtime.bigint();
+    const end = start + BigInt(Math.round(seconds * 1e9));
+    for (let now = start; now < end; ) {
+        await socket.roundTrip(message);
+        const after = process.hrtime.bigint();
+        times.push(Number(after - now) / 1000);
+        now = after;
+    }
+    const elapsed = Number(process.hrtime.bigint() - start) / 1e9;
+
+    // a collection shows as less memory, so only growth is summed
+    let allocations = 0;
+    for (let i = 0; i < ALLOCATION_ROUND_TRIPS; i++) {
+        const before = allocated();
+        await socket.roundTrip(message);
+        allocations += Math.max(0, allocated() - before);
+    }
+
+    socket.close();
+
+    // the first round trips warm things up
+    const sorted = Float64Array.from(
+        times.slice(Math.floor(times.length / 10)),
+    ).sort();
+
+    return {
+        protocol,
+        client,
+        mode,
+        size,
+        "ops/s": Math.round(times.length / elapsed),
+        "MB/s": ((times.length * size) / elapsed / 1e6).toFixed(1),
+        "p99 us": percentile(sorted, 0.99).toFixed(1),
+        "alloc B/op": Math.round(allocations / ALLOCATION_ROUND_TRIPS),
+    };
+}
+
+async function main() {
+    const seconds = Number(process.argv[2]) || 0.5;
+    const sizes = process.argv[3]
+        ? process.argv[3].split(",").map(Number)
+        : [16, 256, 4096, 65536, 1048576];
+
+    const child = fork(__filename, ["echo"]);
+    await new Promise((resolve) => child.once("message", resolve));
+
+    console.log(`${seconds}s of round trips to loopback echo servers:`);
+    const results = [];
+    for (const protocol of ["tcp", "udp"]) {
+        const protocolSizes =
+            protocol === "tcp"
+                ? sizes
+                : sizes
+                      .map((size) => Math.min(size, MAX_DATAGRAM))
+                      .filter((size, i, all) => all.indexOf(size) === i);
+        for (const size of protocolSizes) {
+            for (const client of Object.keys(clients[protocol])) {
+                const modes =
+                    client === "netlinkwrapper"
+                        ? ["blocking", "non-blocking"]
+                        : ["async"];
+                for (const mode of modes) {
+                    results.push(
+                        await measure(protocol, client, mode, size, seconds),
+                    );
+                }
+            }
+        }
+    }
+    console.table(results);
+
+    child.disconnect();
+}
+
+if (process.argv[2] === "echo") {
+    echo();
+} else {
+    main().catch((err) => {
+        console.error(err);
+        process.exitCode = 1;
+    });
+}
@@ -0,0 +1,89 @@
+// Measures loopback UDP throughput of sendTo/receiveFrom, one datagram per
+// call, against segmentation and receive offload: sendSegmentsTo() hands the
+// kernel a batch of datagrams at once and receiveSegments() gets them back
+// coalesced. Each batch is sent and then received, so none are dropped for a
+// full receive buffer and the cost of the calls is what gets measured.
+//
+// usage: node bench/udp-gso.js [seconds=2] [segmentSize=1400]
+
+const { SocketUDP } = require("../lib");
+
+const HOST = "127.0.0.1";
+const SENDER_PORT = 40405;
+const RECEIVER_PORT = 40406;
+// what one send with segmentation offload takes, well within the default
+// receive buffer
+const BATCH_BYTES = 60000;
+const BATCH_DATAGRAMS = 64;
+
+function measure(mode, seconds, segmentSize) {
+    const sender = new SocketUDP(SENDER_PORT, HOST);
+    const receiver = new SocketUDP(RECEIVER_PORT, HOST);
+    receiver.isBlocking = false;
+    receiver.isReceiveOffload = mode === "offload";
+
+    const segments = Math.max(
+        1,
+        Math.min(BATCH_DATAGRAMS, Math.floor(BATCH_BYTES / segmentSize)),
+    );
+    const batch = Buffer.alloc(segments * segmentSize, 1);
+    const datagrams = [];
+    for (let i = 0; i < segments; i++) {
+        datagrams.push(batch.subarray(i * segmentSize, (i + 1) * segmentSize));
+    }
+
+    let sent = 0;
+    let received = 0;
+    let reads = 0;
+    const start = process.hrtime.bigint();
+    const end = start + BigInt(seconds * 1e9);
+
+    while (process.hrtime.bigint() < end) {
+        if (mode === "offload") {
+            sender.sendSegmentsTo(HOST, RECEIVER_PORT, batch, segmentSize);
+        } else {
+            for (const datagram of datagrams) {
+                sender.sendTo(HOST, RECEIVER_PORT, datagram);
+            }
+        }
+        sent += batch.length;
+
+        for (;;) {
+            const read =
+                mode === "offload"
+                    ? receiver.receiveSegments()
+                    : receiver.receiveFrom();
+            if (!read) {
+                break;
+            }
+            received += read.data.length;
+            reads++;
+        }
+    }
+
+    const elapsed = Number(process.hrtime.bigint() - start) / 1e9;
+    sender.disconnect();
+    receiver.disconnect();
+
+    return {
+        mode,
+        "MB/s": (received / elapsed / 1e6).toFixed(1),
+        "datagrams/s": Math.round(received / segmentSize / elapsed),
+        "bytes/read": Math.round(received / reads),
+        "delivered %": ((received / sent) * 100).toFixed(1),
+    };
+}
+
+function main() {
+    const seconds = Number(process.argv[2]) || 2;
+    const segmentSize = Number(process.argv[3]) || 1400;
+
+    console.log(`${seconds}s of ${segmentSize} bytes datagrams over loopback:`);
+    const results = [];
+    for (const mode of ["plain", "offload"]) {
+        results.push(measure(mode, seconds, segmentSize));
+    }
+    console.table(results);
+}
+
+main();
@@ -0,0 +1,106 @@
+// Measures the round trip latency of loopback TCP against Unix domain sockets.
+// A forked echo process sends back every message, one round trip at a time.
+//
+// usage: node bench/unix-latency.js [roundTrips=20000] [messageSize=64]
+
+const { fork } = require("child_process");
+const { existsSync, unlinkSync } = require("fs");
+const { tmpdir } = require("os");
+const { join } = require("path");
+const {
+    SocketClientTCP,
+    SocketServerTCP,
+    SocketClientUnix,
+    SocketServerUnix,
+} = require("../lib");
+
+const TCP_PORT = 40404;
+const UNIX_PATH = join(tmpdir(), `netlinkwrapper-bench-${process.pid}.sock`);
+
+function echo(transport, path) {
+    const server =
+        transport === "tcp"
+            ? new SocketServerTCP(TCP_PORT, "127.0.0.1")
+            : new SocketServerUnix(path);
+    process.send("listening");
+
+    const client = server.accept();
+    for (;;) {
+        const data = client.receive();
+        if (!data) {
+            break; // the benchmark disconnected
+        }
+        client.send(data);
+    }
+
+    client.disconnect();
+    server.disconnect();
+}
+
+function percentile(sorted, ratio) {
+    const index = Math.floor(sorted.length * ratio);
+    return sorted[Math.min(sorted.length - 1, index)];
+}
+
+async function measure(transport, roundTrips, messageSize) {
+    const child = fork(__filename, ["echo", transport, UNIX_PATH]);
+    await new Promise((resolve) => child.once("message", resolve));
+
+    const client =
+        transport === "tcp"
+            ? new SocketClientTCP(TCP_PORT, "127.0.0.1")
+            : new SocketClientUnix(UNIX_PATH);
+    const message = Buffer.alloc(messageSize, 1);
+    const times = new Float64Array(roundTrips);
+
+    for (let i = 0; i < roundTrips; i++) {
+        const start = process.hrtime.bigint();
+        client.send(message);
+        for (let received = 0; received < messageSize; ) {
+            received += client.receive().length;
+        }
+        times[i] = Number(process.hrtime.bigint() - start) / 1000;
+    }
+
+    client.disconnect();
+    await new Promise((resolve) => child.once("exit", resolve));
+
+    // the first round trips warm things up
+    const sorted = times.slice(Math.floor(roundTrips / 10)).sort();
+    const mean = sorted.reduce((sum, time) => sum + time, 0) / sorted.length;
+
+    return {
+        transport,
+        mean: mean.toFixed(2),
+        p50: percentile(sorted, 0.5).toFixed(2),
+        p99: percentile(sorted, 0.99).toFixed(2),
+        p999: percentile(sorted, 0.999).toFixed(2),
+    };
+}
+
+async function main() {
+    const roundTrips = Number(process.argv[2]) || 20000;
+    const messageSize = Number(process.argv[3]) || 64;
+
+    if (existsSync(UNIX_PATH)) {
+        unlinkSync(UNIX_PATH);
+    }
+
+    console.log(
+        `${roundTrips} round trips of ${messageSize} bytes, in microseconds:`,
+    );
+    const results = [];
+    for (const transport of ["tcp", "unix"]) {
+        results.push(await measure(transport, roundTrips, messageSize));
+    }
+    console.table(results);
+}
+
+if (process.argv[2] === "echo") {
+    echo(process.argv[3], process.argv[4]);
+} else {
+    main().catch((err) => {
+        console.error(err);
+        process.exitCode = 1;
+    });
+}
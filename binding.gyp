@@ -1,11 +1,24 @@
 {
+  "variables": {
+    # native benchmarks of the NetLink core: node-gyp rebuild --nl_bench=true
+    "nl_bench%": "false",
+    # native tests of what the JS API can not reach: node-gyp rebuild --nl_tests=true
+    "nl_tests%": "false"
+  },
   "targets": [
     {
       "target_name": "netlinksocket",
+      "variables": {
+        # USDT probes for bpftrace/perf, needs sys/sdt.h: node-gyp rebuild --nl_usdt=true
+        "nl_usdt%": "false"
+      },
       "sources": [
         "src/netlinksocket.cc",
         "src/netlinkwrapper.cc",
         "src/netlink/core.cc",
+        "src/netlink/flight_recorder.cc",
+        "src/netlink/latency.cc",
+        "src/netlink/resolver.cc",
         "src/netlink/smart_buffer.cc",
         "src/netlink/socket.cc",
         "src/netlink/socket_group.cc",
@@ -25,6 +38,11 @@
                 "GCC_ENABLE_CPP_EXCEPTIONS": "YES"
             }
           }
+        ],
+        [
+          'nl_usdt=="true" and OS=="linux"', {
+            "defines": [ "NL_USDT" ]
+          }
         ]
       ],
       "include_dirs" : [
@@ -37,5 +55,93 @@
         }
       }
     }
+  ],
+  "conditions": [
+    [
+      'nl_bench=="true" and OS!="win"', {
+        "targets": [
+          {
+            "target_name": "netlink_bench",
+            "type": "executable",
+            "sources": [
+              "bench/netlink_bench.cc",
+              "src/netlink/core.cc",
+              "src/netlink/flight_recorder.cc",
+              "src/netlink/latency.cc",
+              "src/netlink/resolver.cc",
+              "src/netlink/smart_buffer.cc",
+              "src/netlink/socket.cc",
+              "src/netlink/socket_group.cc",
+              "src/netlink/util.cc"
+            ],
+            "include_dirs": [ "src" ],
+            "cflags": [ "-fexceptions" ],
+            "cflags_cc": [ "-fexceptions" ],
+            "cflags!": [ "-fno-exceptions" ],
+            "cflags_cc!": [ "-fno-exceptions" ],
+            "ldflags": [ "-pthread" ],
+            "xcode_settings": {
+                "GCC_ENABLE_CPP_EXCEPTIONS": "YES"
+            }
+          },
+          {
+            "target_name": "netlink_scaling",
+            "type": "executable",
+            "sources": [
+              "bench/netlink_scaling.cc",
+              "src/netlink/core.cc",
+              "src/netlink/flight_recorder.cc",
+              "src/netlink/latency.cc",
+              "src/netlink/resolver.cc",
+              "src/netlink/smart_buffer.cc",
+              "src/netlink/socket.cc",
+              "src/netlink/socket_group.cc",
+              "src/netlink/util.cc"
+            ],
+            "include_dirs": [ "src" ],
+            "cflags": [ "-fexceptions" ],
+            "cflags_cc": [ "-fexceptions" ],
+            "cflags!": [ "-fno-exceptions" ],
+            "cflags_cc!": [ "-fno-exceptions" ],
+            "ldflags": [ "-pthread" ],
+            "xcode_settings": {
+                "GCC_ENABLE_CPP_EXCEPTIONS": "YES"
+            }
+          }
+        ]
+      }
+    ],
+    [
+      'nl_tests=="true" and OS!="win"', {
+        "targets": [
+          {
+            "target_name": "netlink_tests",
+            "type": "executable",
+            "sources": [
+              "test/native/main.cc",
+              "test/native/resolver.test.cc",
+              "test/native/socket_group.test.cc",
+              "src/netlink/core.cc",
+              "src/netlink/flight_recorder.cc",
+              "src/netlink/latency.cc",
+              "src/netlink/resolver.cc",
+              "src/netlink/smart_buffer.cc",
+              "src/netlink/socket.cc",
+              "src/netlink/socket_group.cc",
+              "src/netlink/util.cc"
+            ],
+            "include_dirs": [ "src" ],
+            "cflags": [ "-fexceptions" ],
+            "cflags_cc": [ "-fexceptions" ],
+            "cflags!": [ "-fno-exceptions" ],
+            "cflags_cc!": [ "-fno-exceptions" ],
+            "ldflags": [ "-pthread" ],
+            "xcode_settings": {
+                "GCC_ENABLE_CPP_EXCEPTIONS": "YES"
+            }
+          }
+        ]
+      }
+    ]
   ]
 }
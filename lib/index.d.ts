@@ -1,5 +1,12 @@
 /// <reference types="node" />
 
+/**
+ * Returned by the `try*` methods of sockets that are not blocking, when
+ * nothing can be done yet. Unlike the errors thrown by the other methods,
+ * this is cheap to check for in loops that poll sockets.
+ */
+export declare const WOULD_BLOCK: unique symbol;
+
 /**
  * The base socket all netlinkwrapper Socket instances inherit from.
  * No instances will ever, or can ever, be directly created from this class.
@@ -11,8 +18,28 @@ export declare abstract class SocketBase {
     /**
      * Disconnects this so. Once this is called the socket is considered
      * "destroyed" and no no longer be used for any form of communication.
+     *
+     * @param mode - How to close the connection. Defaults to "close".
+     * - "close": a plain close. The side that closes first keeps the
+     * connection in the TIME_WAIT state for a while.
+     * - "abort": resets the connection. Unsent data is discarded, but no
+     * TIME_WAIT is left behind, which helps when opening and closing many
+     * short lived connections.
+     * - "graceful": stops sending and waits (up to `timeoutMs`) for the peer
+     * to close its side too, so it surely got all the data.
+     * @param timeoutMs - Milliseconds "graceful" waits for the peer. Defaults
+     * to 1000.
+     */
+    disconnect(mode?: DisconnectMode, timeoutMs?: number): void;
+
+    /**
+     * Returns the memory the operating system has for this socket: its
+     * buffers, what is queued in them, and the packets dropped.
+     *
+     * @returns The Linux `SO_MEMINFO` of the socket, or undefined where it is
+     * not supported (everywhere but Linux).
      */
-    disconnect(): void;
+    memoryInfo(): SocketMemory | undefined;
 
     /**
      * The local port the socket is bound to.
@@ -40,6 +67,13 @@ export declare abstract class SocketBase {
      */
     readonly isDestroyed: boolean;
 
+    /**
+     * The file descriptor (socket handle on Windows) of this socket, such as
+     * to pass it to another process with `SocketClientUnix.sendFd()`. -1 once
+     * destroyed.
+     */
+    readonly fd: number;
+
     /**
      * Flag if the socket is Internet Protocol Version 4 (IPv4).
      */
@@ -49,22 +83,425 @@ export declare abstract class SocketBase {
      * Flag if the socket is Internet Protocol Version 6 (IPv6).
      */
     readonly isIPv6: boolean;
+
+    /**
+     * Counters of what this socket sent, received, and accepted, kept after
+     * it is destroyed. Each read returns a new snapshot.
+     */
+    readonly stats: SocketStats;
+
+    /**
+     * Flag if the time of the blocking calls of this socket is recorded in
+     * `latency`. Off by default, as each socket tracking it keeps ~10 KiB of
+     * histograms. Turning it off discards what was recorded.
+     */
+    isTrackingLatency: boolean;
+
+    /**
+     * How long the blocking calls of this socket took, or undefined when not
+     * `isTrackingLatency`. Each read returns a new snapshot.
+     */
+    readonly latency: Latency | undefined;
+}
+
+/**
+ * Summary of a histogram of how long calls took, in nanoseconds. The
+ * percentiles are within ~6% of the exact values and never above `maxNs`.
+ */
+export interface LatencySummary {
+    /** Calls recorded. */
+    count: number;
+
+    /** Mean time of the calls. */
+    meanNs: number;
+
+    /** Median time of the calls. */
+    p50Ns: number;
+
+    /** 99th percentile of the time of the calls. */
+    p99Ns: number;
+
+    /** 99.9th percentile of the time of the calls. */
+    p999Ns: number;
+
+    /** Longest call. */
+    maxNs: number;
+}
+
+/**
+ * Latency of blocking calls, by kind, of a socket (`SocketBase.latency`) or
+ * of the whole process (`getLatency()`). Calls on non-blocking sockets are
+ * not recorded.
+ */
+export interface Latency {
+    /** Accepting connections. */
+    accept: LatencySummary;
+
+    /** Connecting, only recorded process-wide as it happens on creation. */
+    connect: LatencySummary;
+
+    /** Receiving data. */
+    receive: LatencySummary;
+
+    /** Sending data. */
+    send: LatencySummary;
+}
+
+/**
+ * What the binding itself costs a call, from `getBindingProfile()`: the time
+ * outside of the native I/O, and the copies between JS and native memory.
+ * Times are summed over every call.
+ */
+export interface BindingCallProfile {
+    /** Calls profiled. */
+    calls: number;
+
+    /** Heap copies of arguments, and Buffers returned. */
+    allocations: number;
+
+    /** Bytes copied between JS and native memory, both ways. */
+    bytesCopied: number;
+
+    /** Time parsing and converting the arguments. */
+    parseNs: number;
+
+    /** Time finding the native socket. */
+    unwrapNs: number;
+
+    /** Time in the native I/O call. */
+    nativeNs: number;
+
+    /** Time creating the returned values and Buffers. */
+    convertNs: number;
+
+    /** Time creating and throwing errors. */
+    errorNs: number;
+}
+
+/**
+ * Binding overhead of the I/O calls of every socket, by call.
+ */
+export interface BindingProfile {
+    receive: BindingCallProfile;
+    receiveAllUntil: BindingCallProfile;
+    receiveFrame: BindingCallProfile;
+    receiveFrames: BindingCallProfile;
+    receiveFrom: BindingCallProfile;
+    receiveUntil: BindingCallProfile;
+    send: BindingCallProfile;
+    sendFrame: BindingCallProfile;
+    sendTo: BindingCallProfile;
+    tryReceive: BindingCallProfile;
+    trySend: BindingCallProfile;
+    trySendTo: BindingCallProfile;
+}
+
+/**
+ * Counters of the I/O of a socket (`SocketBase.stats`) or of the whole
+ * process (`getStats()`).
+ */
+export interface SocketStats {
+    /** Bytes sent. */
+    bytesSent: number;
+
+    /** Bytes received. */
+    bytesReceived: number;
+
+    /** Datagrams sent, or successful sends for TCP. */
+    messagesSent: number;
+
+    /** Datagrams received, or reads that returned data for TCP. */
+    messagesReceived: number;
+
+    /** Calls to the operating system to send, receive, or accept. */
+    syscalls: number;
+
+    /** Calls that found a non-blocking socket not ready. */
+    wouldBlock: number;
+
+    /** Sends that took only part of the data, the rest sent by later ones. */
+    partialSends: number;
+
+    /** Connections accepted. */
+    accepts: number;
+
+    /** Calls that failed, besides the would-block ones. */
+    errors: number;
+
+    /**
+     * Datagrams the operating system dropped for a full receive buffer, as
+     * last reported with those received. See `SocketUDP.isCountingDrops`.
+     */
+    drops: number;
+}
+
+/**
+ * What the operating system knows of a TCP connection, the Linux
+ * `struct tcp_info`. See `SocketClientTCP.tcpInfo()`.
+ */
+export interface TcpInfo {
+    /** TCP state, as numbered by Linux: 1 is established. */
+    state: number;
+
+    /** Congestion state: 0 open, 1 disorder, 2 CWR, 3 recovery, 4 loss. */
+    caState: number;
+
+    /** Retransmissions of the current timeout. */
+    retransmits: number;
+
+    /** Zero window probes sent unanswered. */
+    probes: number;
+
+    /** Exponential backoff of the retransmission timeout. */
+    backoff: number;
+
+    /** Retransmission timeout. */
+    rtoUs: number;
+
+    /** Delayed acknowledgement timeout. */
+    atoUs: number;
+
+    /** Maximum segment size sent. */
+    sndMss: number;
+
+    /** Maximum segment size received. */
+    rcvMss: number;
+
+    /** Segments sent and not acknowledged yet. */
+    unacked: number;
+
+    /** Segments selectively acknowledged. */
+    sacked: number;
+
+    /** Segments considered lost. */
+    lost: number;
+
+    /** Segments retransmitted and not acknowledged yet. */
+    retrans: number;
+
+    /** Time since data was last sent. */
+    lastDataSentMs: number;
+
+    /** Time since data was last received. */
+    lastDataReceivedMs: number;
+
+    /** Time since an acknowledgement was last received. */
+    lastAckReceivedMs: number;
+
+    /** Path MTU. */
+    pmtu: number;
+
+    /** Receive window clamp. */
+    rcvSsthresh: number;
+
+    /** Smoothed round trip time. */
+    rttUs: number;
+
+    /** Round trip time variance. */
+    rttVarUs: number;
+
+    /** Slow start threshold, in segments. */
+    sndSsthresh: number;
+
+    /** Congestion window, in segments. */
+    sndCwnd: number;
+
+    /** Maximum segment size advertised. */
+    advMss: number;
+
+    /** Reordering the connection tolerates, in segments. */
+    reordering: number;
+
+    /** Round trip time measured by the receiver. */
+    rcvRttUs: number;
+
+    /** Receive buffer space the window grows to. */
+    rcvSpace: number;
+
+    /** Segments retransmitted over the whole connection. */
+    totalRetrans: number;
+}
+
+/**
+ * The memory the operating system has for a socket, in bytes, the Linux
+ * `SO_MEMINFO`. See `SocketBase.memoryInfo()`.
+ */
+export interface SocketMemory {
+    /** Taken by received data not read yet. */
+    receiveAllocated: number;
+
+    /** Limit of `receiveAllocated`, the receive buffer. */
+    receiveBuffer: number;
+
+    /** Taken by sent data the network has not taken yet. */
+    sendAllocated: number;
+
+    /** Limit of the data queued to be sent, the send buffer. */
+    sendBuffer: number;
+
+    /** Reserved ahead for later data. */
+    forwardAllocated: number;
+
+    /** Taken by data queued to be sent, kept by TCP until acknowledged. */
+    sendQueued: number;
+
+    /** Taken by socket options and control data. */
+    optionMemory: number;
+
+    /** Taken by data received while the socket was in use. */
+    backlog: number;
+
+    /** Packets dropped for the socket. */
+    drops: number;
+}
+
+/**
+ * Diagnostics of one socket from `getDiagnostics()`.
+ */
+export interface SocketDiagnostics {
+    /** The counters of its I/O, as `SocketBase.stats`. */
+    stats: SocketStats;
+
+    /** As `SocketBase.memoryInfo()`, missing when destroyed or unsupported. */
+    memory?: SocketMemory;
+
+    /** As `SocketClientTCP.tcpInfo()`, only for connected TCP sockets. */
+    tcpInfo?: TcpInfo;
+}
+
+/**
+ * Options for how a TCP Client establishes its connection.
+ */
+export interface ConnectOptions {
+    /**
+     * Milliseconds to wait for the connection before an Error is thrown.
+     * Defaults to 0, which waits as long as the operating system does.
+     */
+    connectTimeoutMs?: number;
+
+    /**
+     * Milliseconds a connection attempt is given before the next address of
+     * the host is also tried. Defaults to 250, as RFC 8305 recommends.
+     */
+    attemptDelayMs?: number;
+
+    /**
+     * The local address(es) to connect from. When a list is given, each new
+     * connection takes the next address of the list (round-robin), so many
+     * connections to the same server can be spread over several local IPs.
+     * Defaults to the one the operating system chooses.
+     */
+    hostFrom?: string | string[];
+
+    /**
+     * The local port to connect from. Defaults to 0, which lets the
+     * operating system choose one (when connecting).
+     */
+    portFrom?: number;
+}
+
+/**
+ * How `SocketClientTCP.sendFrame()` and `receiveFrame()` delimit messages:
+ * each one goes after a prefix with its length.
+ */
+export interface FrameFormat {
+    /** Bytes of the length prefix, 1, 2, or 4. Defaults to 4. */
+    prefixBytes?: 1 | 2 | 4;
+
+    /**
+     * If the prefix is little endian. Defaults to false, for big endian
+     * (network order).
+     */
+    littleEndian?: boolean;
+
+    /**
+     * The largest message sent or received, not counting the prefix.
+     * Defaults to 16 MiB.
+     */
+    maxFrameSize?: number;
+}
+
+/**
+ * A remote address for `SocketClientTCP.connectMany()` to connect to.
+ */
+export interface ConnectTarget {
+    /** The port of the address to connect to. */
+    port: number;
+
+    /** The host of the address to connect to. */
+    host: string;
+
+    /** An optional specific IP version to use. Defaults to IPv4. */
+    ipVersion?: "IPv4" | "IPv6";
+}
+
+/**
+ * The outcome of connecting to one `ConnectTarget`. Exactly one of its keys
+ * is set.
+ */
+export interface ConnectResult {
+    /** The connected client, when the connection was made. */
+    socket?: SocketClientTCP;
+
+    /** Why no connection could be made to the target. */
+    error?: Error;
 }
 
 /**
  * Represents a TCP Client connection.
  */
 export declare class SocketClientTCP extends SocketBase {
+    /**
+     * Connects to many remote servers at once. All the connections are
+     * started together and waited on in a single call, instead of one
+     * constructor call after another.
+     *
+     * @param targets - The addresses to connect to.
+     * @param timeoutMs - Milliseconds to wait for all the connections.
+     * Connections still pending by then fail. Defaults to 0, which waits as
+     * long as the operating system does.
+     * @param options - Optional settings for establishing the connections.
+     * All but `connectTimeoutMs` are used, the timeout is `timeoutMs`.
+     * @returns One result for each target, in the same order as `targets`.
+     */
+    static connectMany(
+        targets: ConnectTarget[],
+        timeoutMs?: number,
+        options?: Omit<ConnectOptions, "connectTimeoutMs">,
+    ): ConnectResult[];
+
+    /**
+     * Adopts the file descriptor of a connected TCP socket, such as one
+     * received with `SocketClientUnix.receiveFd()`. The returned socket owns
+     * the descriptor from then on. An Error is thrown, and the descriptor
+     * left alone, if it is not a connected TCP socket.
+     *
+     * @param fd - The file descriptor to adopt.
+     * @returns A TCP client for the connection of the descriptor.
+     */
+    static fromFd(fd: number): SocketClientTCP;
+
     /**
      * Creates, and then attempts to connect to a remote server given an
      * address. If no connection can be made, an Error is thrown.
      *
+     * When the host resolves to several addresses, they are raced as
+     * Happy Eyeballs (RFC 8305) describes: a new connection attempt is
+     * started every `attemptDelayMs` (or as soon as one fails), and the first
+     * one to connect is kept.
+     *
      * @param portTo - The host of the address to connect this TCP client to.
      * @param hostTo - The host of the address to connect this TCP client to.
      * @param ipVersion - An optional specific IP version to use. Defaults to
      * IPv4.
+     * @param options - Optional settings for establishing the connection.
      */
-    constructor(portTo: number, hostTo: string, ipVersion?: "IPv4" | "IPv6");
+    constructor(
+        portTo: number,
+        hostTo: string,
+        ipVersion?: "IPv4" | "IPv6",
+        options?: ConnectOptions,
+    );
 
     /**
      * The target host of the socket.
@@ -76,8 +513,72 @@ export declare class SocketClientTCP extends SocketBase {
      */
     readonly portTo: number;
 
+    /**
+     * The local address this socket connected from, when one was given in
+     * the `hostFrom` or `portFrom` options. Empty string otherwise.
+     */
+    readonly hostFrom: string;
+
+    /**
+     * The number of bytes read by `fill()` that have not been consumed yet.
+     */
+    readonly bufferedSize: number;
+
+    /**
+     * If `sendZeroCopy()` lets the operating system send large Buffers
+     * without copying them (`MSG_ZEROCOPY`). Only supported on Linux,
+     * elsewhere it stays false.
+     */
+    isZeroCopy: boolean;
+
+    /**
+     * If the operating system stamps the data it receives with the time it
+     * arrived, returned by `receiveTimestamped()`. Not supported on Windows,
+     * where it stays false.
+     */
+    isTimestamping: boolean;
+
+    /**
+     * Removes data read by `fill()` from this socket's buffer and returns it.
+     *
+     * @param size - The most bytes to remove. Defaults to all of them.
+     * @returns A Buffer with the removed data, empty if nothing was buffered.
+     */
+    consume(size?: number): Buffer;
+
+    /**
+     * Reads all the data the server has sent so far into this socket's
+     * buffer, without handing it to JavaScript. Use `peek()` and `consume()`
+     * to look at and take the buffered data, such as when waiting on a whole
+     * message to arrive.
+     *
+     * @returns The number of bytes read. If set to blocking this call will
+     * synchronously block until some data is received, otherwise it returns
+     * 0 immediately when there is none.
+     */
+    fill(): number;
+
+    /**
+     * Returns data read by `fill()` without removing it from this socket's
+     * buffer.
+     *
+     * @param size - The most bytes to return. Defaults to all of them.
+     * @returns A Buffer with a copy of the data, empty if nothing was
+     * buffered.
+     */
+    peek(size?: number): Buffer;
+
+    /**
+     * Returns the ids of the `sendZeroCopy()` calls that completed since the
+     * last call, whose Buffers can be modified again. It never blocks.
+     *
+     * @returns The ids, in no particular order.
+     */
+    pollZeroCopy(): number[];
+
     /**
      * Attempts to Receive data from the server and return it as a Buffer.
+     * Data already buffered by `fill()` is returned first, without reading.
      *
      * @returns A Buffer instance with the data read from the connected server.
      * If set to blocking this call will synchronously block until some data
@@ -86,6 +587,84 @@ export declare class SocketClientTCP extends SocketBase {
      */
     receive(): Buffer | undefined;
 
+    /**
+     * Receives the records available, as `receiveUntil()` does each of them,
+     * in a single call.
+     *
+     * @param delimiter - What ends each record, as a string, Buffer, or
+     * Uint8Array.
+     * @param maxBytes - The largest record, not counting the delimiter.
+     * Defaults to 16 MiB.
+     * @returns The records, in order, without their delimiters. If set to
+     * blocking this call will synchronously block until at least one whole
+     * record is received. Empty when not blocking and none arrived yet, or
+     * once the server closed the connection.
+     */
+    receiveAllUntil(
+        delimiter: string | Buffer | Uint8Array,
+        maxBytes?: number,
+    ): Buffer[];
+
+    /**
+     * Receives one whole message sent with `sendFrame()`, or in the same
+     * format. What arrives with it stays in this socket's buffer (see
+     * `fill()`) for the next calls, so many small messages take a single
+     * read. A message bigger than `maxFrameSize` throws an Error, as the
+     * rest of the data can not be delimited anymore.
+     *
+     * @returns A Buffer with the message, without its prefix. If set to
+     * blocking this call will synchronously block until a whole message is
+     * received. Undefined when not blocking and no whole message arrived yet,
+     * or once the server closed the connection.
+     */
+    receiveFrame(): Buffer | undefined;
+
+    /**
+     * Receives the whole messages available, as `receiveFrame()` does each
+     * of them, in a single call.
+     *
+     * @param max - The most messages to return. Defaults to all of them.
+     * @returns The messages, in order. If set to blocking this call will
+     * synchronously block until at least one whole message is received.
+     * Empty when not blocking and none arrived yet, or once the server closed
+     * the connection.
+     */
+    receiveFrames(max?: number): Buffer[];
+
+    /**
+     * Receives data from the server as `receive()` does, along with when it
+     * arrived, to measure how long it waited to be read.
+     *
+     * @returns An object with the data as key `data`. With `isTimestamping`
+     * set, `arrivalNs` is when the last of it arrived, in nanoseconds since
+     * the Unix epoch, and `queuedNs` how long ago that was. Both are missing
+     * for data already buffered by `fill()`. Undefined when not blocking and
+     * there is no data, or once the server closed the connection.
+     */
+    receiveTimestamped():
+        | { data: Buffer; arrivalNs?: bigint; queuedNs?: number }
+        | undefined;
+
+    /**
+     * Receives one record ended by a delimiter, such as a line of a text
+     * protocol. What arrives after it stays in this socket's buffer (see
+     * `fill()`) for the next calls. The delimiter is looked for natively,
+     * many bytes at a time. A record bigger than `maxBytes` throws an Error.
+     *
+     * @param delimiter - What ends the record, as a string, Buffer, or
+     * Uint8Array, such as "\r\n".
+     * @param maxBytes - The largest record, not counting the delimiter.
+     * Defaults to 16 MiB.
+     * @returns A Buffer with the record, without its delimiter. If set to
+     * blocking this call will synchronously block until a whole record is
+     * received. Undefined when not blocking and no whole record arrived yet,
+     * or once the server closed the connection.
+     */
+    receiveUntil(
+        delimiter: string | Buffer | Uint8Array,
+        maxBytes?: number,
+    ): Buffer | undefined;
+
     /**
      * Sends the data to the connected server.
      *
@@ -93,6 +672,75 @@ export declare class SocketClientTCP extends SocketBase {
      * Uint8Array.
      */
     send(data: string | Buffer | Uint8Array): void;
+
+    /**
+     * Sends the data to the connected server as one message, after a prefix
+     * with its length (see `setFrameFormat()`), for `receiveFrame()` to take
+     * whole. The prefix and the data go out in a single vectored send.
+     *
+     * @param data - The message you want to send, as a string, Buffer, or
+     * Uint8Array. An Error is thrown if it is bigger than the prefix or
+     * `maxFrameSize` allow.
+     */
+    sendFrame(data: string | Buffer | Uint8Array): void;
+
+    /**
+     * Sends the data to the connected server as `send()` does, but with
+     * `isZeroCopy` set the operating system reads data of 16 KiB or more
+     * straight from the given Buffer. It must not be modified until
+     * `pollZeroCopy()` returns the id of this send, and is kept alive until
+     * then. Smaller data is copied as usual, and completes right away.
+     *
+     * When it throws after part of the data was sent without copying, this
+     * send still takes the next id, which `pollZeroCopy()` returns once the
+     * operating system is done with the Buffer.
+     *
+     * @param data - The data you want to send, as a Buffer or Uint8Array.
+     * @returns The id of this send, counting from 0 for each socket.
+     */
+    sendZeroCopy(data: Buffer | Uint8Array): number;
+
+    /**
+     * Sets how `sendFrame()`, `receiveFrame()`, and `receiveFrames()`
+     * delimit messages on this socket. By default, with a 4 byte big endian
+     * length prefix, of messages up to 16 MiB.
+     *
+     * @param format - The format of the messages. Options not given take
+     * their defaults.
+     */
+    setFrameFormat(format?: FrameFormat): void;
+
+    /**
+     * Returns what the operating system knows of the connection, to tell why
+     * throughput dropped: round trip time, congestion window, unacknowledged
+     * and retransmitted segments...
+     *
+     * @returns The fields of the Linux `struct tcp_info`, or undefined where
+     * it is not supported (everywhere but Linux).
+     */
+    tcpInfo(): TcpInfo | undefined;
+
+    /**
+     * Receives the data available from the server with a single read, without
+     * throwing when there is none.
+     *
+     * @returns A Buffer with the data read (first the data buffered by
+     * `fill()`, if any). `WOULD_BLOCK` when not blocking and there is no data,
+     * or undefined once the server closed the connection.
+     */
+    tryReceive(): Buffer | typeof WOULD_BLOCK | undefined;
+
+    /**
+     * Sends as much of the data to the connected server as can be sent
+     * without blocking. Unlike `send()`, a full send buffer does not throw.
+     *
+     * @param data - The data you want to send, as a string, Buffer, or
+     * Uint8Array.
+     * @returns The number of bytes sent, which can be less than the size of
+     * `data`, with the rest to be sent later. `WOULD_BLOCK` when not blocking
+     * and nothing could be sent.
+     */
+    trySend(data: string | Buffer | Uint8Array): number | typeof WOULD_BLOCK;
 }
 
 /**
@@ -128,6 +776,16 @@ export declare class SocketServerTCP extends SocketBase {
      */
     accept(): SocketClientTCP | undefined;
 
+    /**
+     * Accepts a new client connection, like `accept()`, but tells apart
+     * having no connection to accept from failing to accept one.
+     *
+     * @returns A new `SocketClientTCP` instance for the connection, or
+     * `WOULD_BLOCK` when not blocking and there is no connection to accept.
+     * Errors accepting a connection are thrown.
+     */
+    tryAccept(): SocketClientTCP | typeof WOULD_BLOCK;
+
     /**
      * Gets the socket local address. Empty string means any bound host.
      */
@@ -161,13 +819,164 @@ export declare class SocketUDP extends SocketBase {
      */
     readonly hostFrom: string;
 
+    /**
+     * The address this socket is connected to with `connect()`. Empty string
+     * when not connected.
+     */
+    readonly hostTo: string;
+
+    /**
+     * The port this socket is connected to with `connect()`. 0 when not
+     * connected.
+     */
+    readonly portTo: number;
+
+    /**
+     * If the operating system reports how many datagrams it dropped for this
+     * socket as its receive buffer was full, counted in `stats.drops` by
+     * `receiveFrom()`, `receiveTimestamped()`, and `receiveSegments()`. Each
+     * datagram carries the count as of when it arrived, so drops show once a
+     * datagram that arrived after them is read. Only supported on Linux,
+     * elsewhere it stays false.
+     */
+    isCountingDrops: boolean;
+
+    /**
+     * If the operating system coalesces the datagrams that arrive together
+     * (UDP generic receive offload), to be read with `receiveSegments()`.
+     * Other reads would get them joined, so only set it when reading with
+     * `receiveSegments()`. Only supported on Linux, elsewhere it stays false.
+     */
+    isReceiveOffload: boolean;
+
+    /**
+     * If the operating system stamps each datagram with the time it arrived,
+     * returned by `receiveFrom()` and `receiveTimestamped()`. Not supported
+     * on Windows, where it stays false.
+     */
+    isTimestamping: boolean;
+
+    /**
+     * Connects this socket to a single remote address. The host is resolved
+     * once, then `send()` and `receive()` exchange datagrams with that
+     * address alone, faster than `sendTo()` and `receiveFrom()` do, as
+     * datagrams from any other address are dropped by the operating system.
+     * Calling it again changes the remote address.
+     *
+     * @param hostTo - The host string to connect to.
+     * @param portTo - The port number to connect to.
+     */
+    connect(hostTo: string, portTo: number): void;
+
+    /**
+     * Receives a datagram from the address this socket is connected to.
+     *
+     * @returns A Buffer with the data of the datagram. If set to blocking this
+     * call will synchronously block until one is received. Otherwise if there
+     * is none, this will return undefined immediately and not block.
+     */
+    receive(): Buffer | undefined;
+
+    /**
+     * Receives a datagram from the address this socket is connected to,
+     * without blocking.
+     *
+     * @returns A Buffer with the data of the datagram, or `WOULD_BLOCK` when
+     * not blocking and there is none.
+     */
+    tryReceive(): Buffer | typeof WOULD_BLOCK;
+
+    /**
+     * Receives a datagram from the address this socket is connected to as
+     * `receive()` does, along with when it arrived.
+     *
+     * @returns An object with the data of the datagram as key `data`. With
+     * `isTimestamping` set, `arrivalNs` is when it arrived, in nanoseconds
+     * since the Unix epoch, and `queuedNs` how long ago that was. Undefined
+     * when not blocking and there is none.
+     */
+    receiveTimestamped():
+        | { data: Buffer; arrivalNs?: bigint; queuedNs?: number }
+        | undefined;
+
+    /**
+     * Sends a datagram to the address this socket is connected to. Throws if
+     * it was not connected with `connect()`.
+     *
+     * @param data - The actual data payload to send. Can be a `string`,
+     * `Buffer`, or `Uint8Array`.
+     */
+    send(data: string | Buffer | Uint8Array): void;
+
+    /**
+     * Sends a datagram to the address this socket is connected to, without
+     * throwing when the socket is not blocking and cannot send it yet.
+     *
+     * @param data - The actual data payload to send. Can be a `string`,
+     * `Buffer`, or `Uint8Array`.
+     * @returns The number of bytes sent, or `WOULD_BLOCK` when the datagram
+     * could not be sent yet.
+     */
+    trySend(data: string | Buffer | Uint8Array): number | typeof WOULD_BLOCK;
+
     /**
      * Receive data from datagrams and returns the data and their address.
      *
      * @returns An object, containing the key `data` as a Buffer of the received
-     * data. The address is present as key `host` and key `port`.
+     * data. The address is present as key `host` and key `port`. With
+     * `isTimestamping` set, `arrivalNs` is when the datagram arrived, in
+     * nanoseconds since the Unix epoch, and `queuedNs` how long ago that was.
      */
-    receiveFrom(): { host: string; port: number; data: Buffer } | undefined;
+    receiveFrom():
+        | {
+              host: string;
+              port: number;
+              data: Buffer;
+              arrivalNs?: bigint;
+              queuedNs?: number;
+          }
+        | undefined;
+
+    /**
+     * Receives datagrams, coalesced when `isReceiveOffload` is set: the
+     * datagrams of a sender that arrived together come back to back in
+     * `data`, each `segmentSize` bytes but the last one, which may be shorter.
+     *
+     * @returns An object with the data, segment size, and address of the
+     * sender, or undefined when not blocking and there is nothing to receive.
+     */
+    receiveSegments():
+        | { host: string; port: number; data: Buffer; segmentSize: number }
+        | undefined;
+
+    /**
+     * Sends data as many datagrams of `segmentSize` bytes, the last one
+     * shorter if needed, to the address this socket is connected to. On
+     * Linux the kernel splits the data (UDP generic segmentation offload),
+     * sending tens of datagrams for the cost of one.
+     *
+     * @param data - The actual data payload to send. Can be a `string`,
+     * `Buffer`, or `Uint8Array`.
+     * @param segmentSize - The size of each datagram.
+     */
+    sendSegments(data: string | Buffer | Uint8Array, segmentSize: number): void;
+
+    /**
+     * Sends data as many datagrams of `segmentSize` bytes to a specific
+     * address, as `sendSegments()` does.
+     *
+     * @param hostTo - The host string to send data to.
+     * @param portTo - The port number to send data to.
+     * @param data - The actual data payload to send. Can be a `string`,
+     * `Buffer`, or `Uint8Array`.
+     * @param segmentSize - The size of each datagram.
+     */
+    sendSegmentsTo(
+        hostTo: string,
+        portTo: number,
+        data: string | Buffer | Uint8Array,
+        segmentSize: number,
+    ): void;
 
     /**
      * Sends to a specific datagram address some data.
@@ -182,4 +991,391 @@ export declare class SocketUDP extends SocketBase {
         portTo: number,
         data: string | Buffer | Uint8Array,
     ): void;
+
+    /**
+     * Sends a datagram to a specific address, without throwing when the
+     * socket is not blocking and cannot send it yet.
+     *
+     * @param hostTo - The host string to send data to.
+     * @param portTo - The port number to send data to.
+     * @param data - The actual data payload to send. Can be a `string`,
+     * `Buffer`, or `Uint8Array`.
+     * @returns The number of bytes sent, or `WOULD_BLOCK` when the datagram
+     * could not be sent yet.
+     */
+    trySendTo(
+        hostTo: string,
+        portTo: number,
+        data: string | Buffer | Uint8Array,
+    ): number | typeof WOULD_BLOCK;
+}
+
+/**
+ * Represents a Unix domain stream socket connection, to a process on the same
+ * host. It sends and receives the same way `SocketClientTCP` does.
+ */
+export declare class SocketClientUnix extends SocketBase {
+    /**
+     * Creates a pair of Unix sockets already connected to each other, such
+     * as to hand one to a child process. Not available on Windows.
+     *
+     * @returns The two sockets. What one sends, the other receives.
+     */
+    static pair(): [SocketClientUnix, SocketClientUnix];
+
+    /**
+     * Creates, and then attempts to connect to a Unix server listening on a
+     * path. If no connection can be made, an Error is thrown.
+     *
+     * @param path - The path the server is bound to. Paths starting with "@"
+     * are names in the abstract namespace (Linux only), which are not files.
+     */
+    constructor(path: string);
+
+    /**
+     * The path of the server this socket connected to. Empty for sockets
+     * from `pair()` and `accept()`.
+     */
+    readonly path: string;
+
+    /**
+     * The number of bytes read by `fill()` that have not been consumed yet.
+     */
+    readonly bufferedSize: number;
+
+    /**
+     * Removes data read by `fill()` from this socket's buffer and returns it.
+     *
+     * @param size - The most bytes to remove. Defaults to all of them.
+     * @returns A Buffer with the removed data, empty if nothing was buffered.
+     */
+    consume(size?: number): Buffer;
+
+    /**
+     * Reads all the data received so far into this socket's buffer, without
+     * handing it to JavaScript.
+     *
+     * @returns The number of bytes read.
+     */
+    fill(): number;
+
+    /**
+     * Returns data read by `fill()` without removing it from this socket's
+     * buffer.
+     *
+     * @param size - The most bytes to return. Defaults to all of them.
+     * @returns A Buffer with a copy of the data, empty if nothing was
+     * buffered.
+     */
+    peek(size?: number): Buffer;
+
+    /**
+     * Attempts to Receive data and return it as a Buffer.
+     *
+     * @returns A Buffer instance with the data read. If set to blocking this
+     * call will synchronously block until some data is received. Otherwise if
+     * there is no data to receive, this will return undefined immediately.
+     */
+    receive(): Buffer | undefined;
+
+    /**
+     * Receives a file descriptor sent by the other end with `sendFd()`. For
+     * a TCP connection, hand it to `SocketClientTCP.fromFd()`. Not available
+     * on Windows.
+     *
+     * @returns The received file descriptor, now owned by this process. If
+     * set to blocking this call will synchronously block until one is
+     * received. Otherwise undefined when there is none. An Error is thrown
+     * when other data was received instead.
+     */
+    receiveFd(): number | undefined;
+
+    /**
+     * Sends the data to the other end of the connection.
+     *
+     * @param data - The data you want to send, as a string, Buffer, or
+     * Uint8Array.
+     */
+    send(data: string | Buffer | Uint8Array): void;
+
+    /**
+     * Sends a file descriptor to the process at the other end, for it to
+     * use as its own, such as to hand accepted connections to worker
+     * processes. Not available on Windows.
+     *
+     * @param fd - The file descriptor to send, which stays open in this
+     * process. Or a socket to hand over: it is then closed in this process
+     * and destroyed, without affecting its connection, which now belongs to
+     * the receiver. An Error is thrown for sockets with data buffered by
+     * `fill()`, which the receiver could not read.
+     */
+    sendFd(fd: number | SocketBase): void;
+
+    /**
+     * Receives the available data with a single read, without throwing when
+     * there is none.
+     *
+     * @returns A Buffer with the data read, `WOULD_BLOCK` when not blocking
+     * and there is no data, or undefined once the connection was closed.
+     */
+    tryReceive(): Buffer | typeof WOULD_BLOCK | undefined;
+
+    /**
+     * Sends as much of the data as can be sent without blocking.
+     *
+     * @param data - The data you want to send, as a string, Buffer, or
+     * Uint8Array.
+     * @returns The number of bytes sent, or `WOULD_BLOCK` when not blocking
+     * and nothing could be sent.
+     */
+    trySend(data: string | Buffer | Uint8Array): number | typeof WOULD_BLOCK;
+}
+
+/**
+ * Represents a Unix domain stream socket server.
+ */
+export declare class SocketServerUnix extends SocketBase {
+    /**
+     * Creates a Unix server listening on a path for new `SocketClientUnix`
+     * connections. The socket file is removed when it is disconnected.
+     *
+     * @param path - The path to bind to, which must not exist yet. Paths
+     * starting with "@" are names in the abstract namespace (Linux only),
+     * which are not files.
+     */
+    constructor(path: string);
+
+    /**
+     * The path this server is bound to.
+     */
+    readonly path: string;
+
+    /**
+     * Accepts a new client connection.
+     *
+     * @returns A new `SocketClientUnix` instance for the connection. If set
+     * to blocking this call will synchronously block until a connection is
+     * made. Otherwise `undefined` is returned when there is none.
+     */
+    accept(): SocketClientUnix | undefined;
+
+    /**
+     * Accepts a new client connection, like `accept()`, but tells apart
+     * having no connection to accept from failing to accept one.
+     *
+     * @returns A new `SocketClientUnix` instance for the connection, or
+     * `WOULD_BLOCK` when not blocking and there is no connection to accept.
+     */
+    tryAccept(): SocketClientUnix | typeof WOULD_BLOCK;
 }
+
+/**
+ * Represents a Unix domain datagram socket. Datagrams are never lost or
+ * reordered between sockets on the same host.
+ */
+export declare class SocketUnixDatagram extends SocketBase {
+    /**
+     * Creates a Unix datagram socket bound to a path.
+     *
+     * @param path - The path to bind to, which must not exist yet. Paths
+     * starting with "@" are names in the abstract namespace (Linux only).
+     * When left undefined, Linux chooses an abstract name, so the socket
+     * can still be replied to.
+     */
+    constructor(path?: string);
+
+    /**
+     * The path this socket is bound to.
+     */
+    readonly path: string;
+
+    /**
+     * Receives a datagram and returns its data and the path it came from.
+     *
+     * @returns An object with the received `data` and the `path` of the
+     * sender (empty when the sender is not bound). When not blocking and
+     * there is no datagram, undefined.
+     */
+    receiveFrom(): { path: string; data: Buffer } | undefined;
+
+    /**
+     * Sends a datagram to the socket bound to a path.
+     *
+     * @param path - The path to send the datagram to.
+     * @param data - The datagram, as a string, Buffer, or Uint8Array.
+     */
+    sendTo(path: string, data: string | Buffer | Uint8Array): void;
+
+    /**
+     * Sends a datagram without throwing when the socket is not blocking and
+     * the receiver's queue is full.
+     *
+     * @param path - The path to send the datagram to.
+     * @param data - The datagram, as a string, Buffer, or Uint8Array.
+     * @returns The number of bytes sent, or `WOULD_BLOCK`.
+     */
+    trySendTo(
+        path: string,
+        data: string | Buffer | Uint8Array,
+    ): number | typeof WOULD_BLOCK;
+}
+
+/**
+ * How a socket is closed. See `SocketBase.disconnect()`.
+ */
+export type DisconnectMode = "close" | "abort" | "graceful";
+
+/**
+ * Disconnects many sockets in a single call. The same as calling
+ * `disconnect()` on each of them, except "graceful" waits for all the peers
+ * together, up to `timeoutMs` in total. Sockets already destroyed are
+ * skipped.
+ *
+ * @param sockets - The sockets to disconnect.
+ * @param mode - How to close the connections. Defaults to "close".
+ * @param timeoutMs - Milliseconds "graceful" waits for the peers. Defaults
+ * to 1000.
+ */
+export declare function disconnectAll(
+    sockets: SocketBase[],
+    mode?: DisconnectMode,
+    timeoutMs?: number,
+): void;
+
+/**
+ * An operation of a socket kept by the flight recorder, see `dumpTrace()`.
+ */
+export interface TraceEvent {
+    /**
+     * When it ended, in nanoseconds since the Unix epoch. Beyond what
+     * `JSON.parse()` keeps exactly, so it is rounded to ~256 ns by it.
+     */
+    timeNs: number;
+
+    /** What the socket did. */
+    op: "accept" | "connect" | "disconnect" | "read" | "send";
+
+    /** The file descriptor of the socket, see `SocketBase.fd`. */
+    fd: number;
+
+    /**
+     * Bytes read or sent, the descriptor of the accepted connection, or how
+     * it disconnected (0 "close", 1 "abort", 2 "graceful"). -1 when it
+     * failed.
+     */
+    result: number;
+
+    /** The native error code when it failed, 0 otherwise. */
+    error: number;
+}
+
+/**
+ * Exports the last 4096 operations of every socket of the process, which are
+ * always recorded: reads, sends, accepts, connections, and disconnections,
+ * from the oldest to the most recent. Recording is cheap enough to never be
+ * turned off, so what led to a stall can be seen after the fact.
+ *
+ * @param format - "json" (the default) for a JSON array of `TraceEvent`s, or
+ * "binary" for a Buffer of 24 bytes per event in the byte order of the
+ * machine: the time as an unsigned 64 bit integer, then the fd, result, op
+ * (0 accept, 1 connect, 2 disconnect, 3 read, 4 send), and error as signed
+ * 32 bit integers.
+ * @returns The events.
+ */
+export declare function dumpTrace(format?: "json"): string;
+export declare function dumpTrace(format: "binary"): Buffer;
+
+/**
+ * Resolves a host name and stores the result in the process-wide DNS cache,
+ * so later sockets connecting or sending to it do not block on the resolver.
+ * The cache is always refreshed, even if the host was already cached.
+ *
+ * IP literals (such as "127.0.0.1" or "::1") never need resolving and are
+ * never cached.
+ *
+ * @param host - The host name to resolve.
+ * @param ipVersion - An optional specific IP version to resolve for. If left
+ * undefined, both IPv4 and IPv6 are resolved.
+ * @returns An array of the addresses the host resolved to.
+ */
+export declare function prewarmDNS(
+    host: string,
+    ipVersion?: "IPv4" | "IPv6",
+): string[];
+
+/**
+ * Removes resolved host names from the process-wide DNS cache.
+ *
+ * @param host - An optional host name to remove. If left undefined, the
+ * entire cache is cleared.
+ */
+export declare function flushDNS(host?: string): void;
+
+/**
+ * Sets how long resolved host names are kept in the process-wide DNS cache.
+ * Defaults to 30 seconds.
+ *
+ * @param milliseconds - The time to live of cached host names. 0 disables
+ * the cache entirely.
+ */
+export declare function setDNSCacheTTL(milliseconds: number): void;
+
+/**
+ * Returns the counters of every socket of the process, including those
+ * already destroyed. They are cheap enough to always be kept.
+ *
+ * @param format - "object" (the default) for a `SocketStats`, or
+ * "prometheus" for the Prometheus text exposition format, with metrics named
+ * `netlinkwrapper_<counter>_total`.
+ * @returns The counters since the process started.
+ */
+export declare function getStats(format?: "object"): SocketStats;
+export declare function getStats(format: "prometheus"): string;
+
+/**
+ * Takes the diagnostics of many sockets in a single call, for instance to
+ * sample every connection of a server periodically.
+ *
+ * @param sockets - The sockets to take the diagnostics of.
+ * @returns One entry per socket, in the same order. Destroyed sockets only
+ * have their `stats`.
+ */
+export declare function getDiagnostics(
+    sockets: SocketBase[],
+): SocketDiagnostics[];
+
+/**
+ * Returns how long the blocking calls of every socket of the process took,
+ * whether they track their own `latency` or not.
+ *
+ * @returns The latency since the process started, or since `resetLatency()`.
+ */
+export declare function getLatency(): Latency;
+
+/**
+ * Clears the process-wide latency histograms of `getLatency()`. The ones of
+ * sockets are not affected.
+ */
+export declare function resetLatency(): void;
+
+/**
+ * Enables or disables the profiling of the binding overhead of I/O calls,
+ * off by default. While off, it costs calls a single check.
+ *
+ * @param enabled - True to profile the calls from now on.
+ */
+export declare function setBindingProfiling(enabled: boolean): void;
+
+/**
+ * Returns where the time of the I/O calls profiled by `setBindingProfiling()`
+ * went, and what they allocated and copied.
+ *
+ * @returns The profile since profiling started, or since
+ * `resetBindingProfile()`.
+ */
+export declare function getBindingProfile(): BindingProfile;
+
+/**
+ * Clears the profile of `getBindingProfile()`.
+ */
+export declare function resetBindingProfile(): void;
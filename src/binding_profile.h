@@ -0,0 +1,160 @@
+#ifndef BINDING_PROFILE_H
+#define BINDING_PROFILE_H
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include "netlink/latency.h"
+
+// the js calls whose binding overhead is profiled, the I/O ones
+enum class BindingCall
+{
+    Receive,
+    ReceiveAllUntil,
+    ReceiveFrame,
+    ReceiveFrames,
+    ReceiveFrom,
+    ReceiveUntil,
+    Send,
+    SendFrame,
+    SendTo,
+    TryReceive,
+    TrySend,
+    TrySendTo,
+    Count, // not a call, how many there are
+};
+
+// the keys of the BindingCall profiles in js objects
+const char *const binding_calls[] = {"receive", "receiveAllUntil", "receiveFrame", "receiveFrames", "receiveFrom",
+                                       "receiveUntil", "send", "sendFrame", "sendTo", "tryReceive", "trySend",
+                                       "trySendTo"};
+
+// what a call is busy with, in the order they happen
+enum class BindingPhase
+{
+    Parse,   // ArgParser and GetValue::get_value
+    Unwrap,  // ObjectWrap::Unwrap and throw_if_destroyed
+    Native,  // the NL::Socket call
+    Convert, // creating the returned js values and Buffers
+    Error,   // throw_js_error
+    Count,   // not a phase, how many there are
+};
+
+// the keys of the BindingPhase times in js objects
+const char *const binding_phases[] = {"parseNs", "unwrapNs", "nativeNs", "convertNs", "errorNs"};
+
+// totals of one BindingCall, from every thread
+struct BindingCallProfile
+{
+    std::atomic<unsigned long long> calls;
+    std::atomic<unsigned long long> allocations; // heap copies of arguments, and Buffers returned
+    std::atomic<unsigned long long> bytes_copied; // between js and native memory, both ways
+    std::atomic<unsigned long long> phase_ns[static_cast<std::size_t>(BindingPhase::Count)];
+};
+
+// zero-initialized, as static storage
+static BindingCallProfile binding_profiles[static_cast<std::size_t>(BindingCall::Count)];
+static std::atomic<bool> binding_profiling(false);
+
+// times the phases of one js call, and counts what it allocates and copies,
+// into its BindingCallProfile once done. Unless profiling is enabled, it is
+// only a relaxed load.
+class BindingProfiler
+{
+private:
+    BindingCallProfile *profile = nullptr;
+    BindingProfiler *outer = nullptr; // the call that called this one, if any
+    BindingPhase current = BindingPhase::Parse;
+    unsigned long long phase_start = 0;
+    unsigned long long phase_ns[static_cast<std::size_t>(BindingPhase::Count)] = {};
+    unsigned long long allocations = 0;
+    unsigned long long bytes_copied = 0;
+
+    static BindingProfiler *&active()
+    {
+        static thread_local BindingProfiler *profiler = nullptr;
+        return profiler;
+    }
+
+    BindingProfiler(const BindingProfiler &) = delete;
+    BindingProfiler &operator=(const BindingProfiler &) = delete;
+
+public:
+    explicit BindingProfiler(BindingCall call, BindingPhase first = BindingPhase::Parse)
+    {
+        if (!binding_profiling.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        this->profile = &binding_profiles[static_cast<std::size_t>(call)];
+        this->outer = active();
+        active() = this;
+        this->current = first;
+        this->phase_start = NL::LatencyHistogram::now();
+    }
+
+    ~BindingProfiler()
+    {
+        if (!this->profile)
+        {
+            return;
+        }
+
+        this->phase(BindingPhase::Count);
+        active() = this->outer;
+
+        auto relaxed = std::memory_order_relaxed;
+        this->profile->calls.fetch_add(1, relaxed);
+        this->profile->allocations.fetch_add(this->allocations, relaxed);
+        this->profile->bytes_copied.fetch_add(this->bytes_copied, relaxed);
+        for (std::size_t i = 0; i < static_cast<std::size_t>(BindingPhase::Count); i++)
+        {
+            this->profile->phase_ns[i].fetch_add(this->phase_ns[i], relaxed);
+        }
+    }
+
+    // ends the current phase, the time from now on goes to next
+    void phase(BindingPhase next)
+    {
+        if (!this->profile)
+        {
+            return;
+        }
+
+        auto now = NL::LatencyHistogram::now();
+        this->phase_ns[static_cast<std::size_t>(this->current)] += now - this->phase_start;
+        this->phase_start = now;
+        this->current = next;
+    }
+
+    // counts a copy made for the active call, if any is profiled
+    static void copied(std::size_t bytes, bool allocated)
+    {
+        auto profiler = active();
+        if (profiler)
+        {
+            profiler->bytes_copied += bytes;
+            profiler->allocations += allocated ? 1 : 0;
+        }
+    }
+
+    // counts a copy into a std::string, allocated unless it fit inside it
+    static void copied(const std::string &str)
+    {
+        auto inside = reinterpret_cast<const char *>(&str);
+        copied(str.size(), str.data() < inside || str.data() >= inside + sizeof(str));
+    }
+
+    // the active call, if any is profiled, is throwing from now on
+    static void throwing()
+    {
+        auto profiler = active();
+        if (profiler)
+        {
+            profiler->phase(BindingPhase::Error);
+        }
+    }
+};
+
+#endif
@@ -5,6 +5,7 @@
 #include <nan.h>
 #include <node.h>
 #include <sstream>
+#include "binding_profile.h"
 #include "netlinkwrapper.h"
 
 namespace GetValue
@@ -68,6 +69,39 @@ namespace GetValue
         return "";
     }
 
+    template <>
+    std::string get_value(
+        std::uint32_t &value,
+        const v8::Local<v8::Value> &arg,
+        SubType sub_type)
+    {
+        if (!arg->IsNumber())
+        {
+            return "must be a number. " + get_typeof_str(arg);
+        }
+
+        auto isolate = v8::Isolate::GetCurrent();
+        auto as_number = arg->IntegerValue(isolate->GetCurrentContext()).FromJust();
+
+        if (as_number < 0)
+        {
+            std::stringstream ss;
+            ss << as_number << " must not be negative.";
+            return ss.str();
+        }
+
+        if (as_number > UINT32_MAX)
+        {
+            std::stringstream ss;
+            ss << as_number << " beyond max value of "
+               << UINT32_MAX << ".";
+            return ss.str();
+        }
+
+        value = static_cast<std::uint32_t>(as_number);
+        return "";
+    }
+
     template <>
     std::string get_value(
         bool &value,
@@ -84,6 +118,36 @@ namespace GetValue
         return "";
     }
 
+    template <>
+    std::string get_value(
+        v8::Local<v8::Array> &value,
+        const v8::Local<v8::Value> &arg,
+        SubType sub_type)
+    {
+        if (!arg->IsArray())
+        {
+            return "must be an array. " + get_typeof_str(arg);
+        }
+
+        value = arg.As<v8::Array>();
+        return "";
+    }
+
+    template <>
+    std::string get_value(
+        v8::Local<v8::Object> &value,
+        const v8::Local<v8::Value> &arg,
+        SubType sub_type)
+    {
+        if (!arg->IsObject())
+        {
+            return "must be an object. " + get_typeof_str(arg);
+        }
+
+        value = arg.As<v8::Object>();
+        return "";
+    }
+
     template <>
     std::string get_value(
         NL::IPVer &value,
@@ -119,6 +183,115 @@ namespace GetValue
         return "";
     }
 
+    template <>
+    std::string get_value(
+        NL::DisconnectMode &value,
+        const v8::Local<v8::Value> &arg,
+        SubType sub_type)
+    {
+        std::string invalid_string("must be a disconnect mode string either 'close', 'abort' or 'graceful'.");
+        if (!arg->IsString())
+        {
+            std::stringstream ss;
+            ss << invalid_string << " " << get_typeof_str(arg);
+            return ss.str();
+        }
+
+        Nan::Utf8String utf8_string(arg);
+        std::string str(*utf8_string);
+
+        if (str.compare("close") == 0)
+        {
+            value = NL::DisconnectMode::CLOSE;
+        }
+        else if (str.compare("abort") == 0)
+        {
+            value = NL::DisconnectMode::ABORT;
+        }
+        else if (str.compare("graceful") == 0)
+        {
+            value = NL::DisconnectMode::GRACEFUL;
+        }
+        else
+        {
+            std::stringstream ss;
+            ss << invalid_string << " Got: '" << str << "'.";
+            return ss.str();
+        }
+
+        return "";
+    }
+
+    template <>
+    std::string get_value(
+        StatsFormat &value,
+        const v8::Local<v8::Value> &arg,
+        SubType sub_type)
+    {
+        std::string invalid_string("must be a stats format string either 'object' or 'prometheus'.");
+        if (!arg->IsString())
+        {
+            std::stringstream ss;
+            ss << invalid_string << " " << get_typeof_str(arg);
+            return ss.str();
+        }
+
+        Nan::Utf8String utf8_string(arg);
+        std::string str(*utf8_string);
+
+        if (str.compare("object") == 0)
+        {
+            value = StatsFormat::Object;
+        }
+        else if (str.compare("prometheus") == 0)
+        {
+            value = StatsFormat::Prometheus;
+        }
+        else
+        {
+            std::stringstream ss;
+            ss << invalid_string << " Got: '" << str << "'.";
+            return ss.str();
+        }
+
+        return "";
+    }
+
+    template <>
+    std::string get_value(
+        TraceFormat &value,
+        const v8::Local<v8::Value> &arg,
+        SubType sub_type)
+    {
+        std::string invalid_string("must be a trace format string either 'json' or 'binary'.");
+        if (!arg->IsString())
+        {
+            std::stringstream ss;
+            ss << invalid_string << " " << get_typeof_str(arg);
+            return ss.str();
+        }
+
+        Nan::Utf8String utf8_string(arg);
+        std::string str(*utf8_string);
+
+        if (str.compare("json") == 0)
+        {
+            value = TraceFormat::Json;
+        }
+        else if (str.compare("binary") == 0)
+        {
+            value = TraceFormat::Binary;
+        }
+        else
+        {
+            std::stringstream ss;
+            ss << invalid_string << " Got: '" << str << "'.";
+            return ss.str();
+        }
+
+        return "";
+    }
+
     template <>
     std::string get_value(
         std::string &value,
@@ -135,6 +308,7 @@ namespace GetValue
         {
             Nan::Utf8String utf8_str(arg);
             value = std::string(*utf8_str);
+            BindingProfiler::copied(utf8_str.length(), false); // encoded to utf8
         }
         else if (arg->IsUint8Array())
         {
@@ -153,6 +327,60 @@ namespace GetValue
             return "must be a string, Buffer, or Uint8Array";
         }
 
+        BindingProfiler::copied(value);
+        return "";
+    }
+
+    template <>
+    std::string get_value(
+        v8::Local<v8::Uint8Array> &value,
+        const v8::Local<v8::Value> &arg,
+        SubType sub_type)
+    {
+        // Buffers are Uint8Arrays too
+        if (!arg->IsUint8Array())
+        {
+            return "must be a Buffer or Uint8Array. " + get_typeof_str(arg);
+        }
+
+        value = arg.As<v8::Uint8Array>();
+        return "";
+    }
+
+    template <>
+    std::string get_value(
+        std::vector<std::string> &value,
+        const v8::Local<v8::Value> &arg,
+        SubType sub_type)
+    {
+        std::vector<std::string> strings;
+
+        if (arg->IsString())
+        {
+            Nan::Utf8String utf8_str(arg);
+            strings.push_back(std::string(*utf8_str));
+        }
+        else if (arg->IsArray())
+        {
+            auto array = arg.As<v8::Array>();
+            for (std::uint32_t i = 0; i < array->Length(); i++)
+            {
+                v8::Local<v8::Value> element;
+                if (!Nan::Get(array, i).ToLocal(&element) || !element->IsString())
+                {
+                    return "must be a string or an array of strings.";
+                }
+
+                Nan::Utf8String utf8_str(element);
+                strings.push_back(std::string(*utf8_str));
+            }
+        }
+        else
+        {
+            return "must be a string or an array of strings. " + get_typeof_str(arg);
+        }
+
+        value.swap(strings);
         return "";
     }
 } // namespace GetValue
@@ -27,9 +27,23 @@
 
 const size_t DEFAULT_LISTEN_QUEUE = 50;
 
+const unsigned DEFAULT_CONNECTION_ATTEMPT_DELAY = 250; // RFC 8305 recommendation
+
+const unsigned DEFAULT_DISCONNECT_TIMEOUT = 1000;
+
+const size_t ZEROCOPY_MIN_SIZE = 16384; // smaller sends are copied, cheaper than pinning their pages
+
+const unsigned DEFAULT_FRAME_PREFIX_SIZE = 4;
+const unsigned DEFAULT_MAX_FRAME_SIZE = 16 * 1024 * 1024;
+
 const size_t DEFAULT_SMARTBUFFER_SIZE = 1024;
 const double DEFAULT_SMARTBUFFER_REALLOC_RATIO = 1.5;
 
+const unsigned DEFAULT_RESOLVER_TTL = 30000;
+const size_t DEFAULT_RESOLVER_CACHE_SIZE = 1024;
+
+const size_t FLIGHT_RECORDER_SIZE = 4096; // events, a power of two: 128 KiB for the whole process
+
 
 
 
@@ -45,6 +45,7 @@
 
     #include <winsock2.h>
     #include <ws2tcpip.h>
+    #include <afunix.h>
 
     // Requires Win7 or Vista
     // Link to Ws2_32.lib library
@@ -61,9 +62,12 @@
     #include <fcntl.h>
     #include <sys/types.h>
     #include <sys/socket.h>
+    #include <sys/un.h>
     #include <unistd.h>
     #include <sys/time.h>
     #include <netdb.h>
+    #include <poll.h>
+    #include <sys/uio.h>
     #include <sys/ioctl.h>
     #include <errno.h>
     #include <unistd.h>
@@ -121,6 +125,35 @@ enum SocketType {
     SERVER      /**< TCP socket which listens for connections or UDP socket without target host*/
 };
 
+
+/**
+* @enum DisconnectMode
+*
+* Defines how a socket is closed.
+*/
+
+enum DisconnectMode {
+
+    CLOSE,      /**< Plain close. Pending data is still sent, and the closing side keeps the connection in TIME_WAIT*/
+    ABORT,      /**< Resets the connection (SO_LINGER with 0 timeout): pending data is discarded and no TIME_WAIT is left behind*/
+    GRACEFUL    /**< Stops sending and reads until the peer closes too (or a timeout expires), then closes*/
+};
+
+
+/**
+* @enum IOStatus
+*
+* Defines the outcome of the non-throwing (try*) operations of Socket.
+*/
+
+enum IOStatus {
+
+    IO_DONE,            /**< The operation completed*/
+    IO_WOULD_BLOCK,     /**< The socket is non-blocking and not ready: nothing, or only part, was done*/
+    IO_CLOSED,          /**< The peer closed the connection*/
+    IO_ERROR            /**< The operation failed with a native error*/
+};
+
 NL_NAMESPACE_END
 
 
@@ -0,0 +1,127 @@
+/*
+    NetLink Sockets: Networking C++ library
+    Copyright 2012 Pedro Francisco Pareja Ruiz (PedroPareja@Gmail.com)
+
+    This file is part of NetLink Sockets.
+
+    NetLink Sockets is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NetLink Sockets is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NetLink Sockets. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "flight_recorder.h"
+
+#include <atomic>
+#include <chrono>
+
+
+NL_NAMESPACE
+
+
+/*
+* An event of the ring. Its fields are atomic as snapshots read them while sockets record:
+* sequence is the position of the event plus one once recorded, 0 while being written.
+*/
+
+struct TraceSlot {
+
+    std::atomic<unsigned long long> sequence;
+    std::atomic<unsigned long long> time;
+    std::atomic<int>                fd;
+    std::atomic<int>                result;
+    std::atomic<int>                op;
+    std::atomic<int>                error;
+};
+
+
+/*
+* The ring of every socket of the process, next being the position of the next event
+*/
+
+static struct {
+
+    std::atomic<unsigned long long> next;
+    TraceSlot                       slots[FLIGHT_RECORDER_SIZE];
+
+} recorder;
+
+
+/**
+* Records an operation of a socket
+*
+* @param op the operation
+* @param fd the socket handler
+* @param result what the call to the OS returned, -1 when it failed
+* @param error the native error code when it failed, 0 otherwise
+*/
+
+void FlightRecorder::record(TraceOp op, int fd, long result, int error) {
+
+    unsigned long long position = recorder.next.fetch_add(1, std::memory_order_relaxed);
+    TraceSlot& slot = recorder.slots[position & (FLIGHT_RECORDER_SIZE - 1)];
+
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.time.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count(), std::memory_order_relaxed);
+    slot.fd.store(fd, std::memory_order_relaxed);
+    slot.result.store((int)result, std::memory_order_relaxed);
+    slot.op.store(op, std::memory_order_relaxed);
+    slot.error.store(error, std::memory_order_relaxed);
+
+    slot.sequence.store(position + 1, std::memory_order_release);
+}
+
+
+/**
+* Gets the events of the ring, from the oldest to the most recent
+*
+* Events being recorded, or overwritten, while reading are left out.
+*
+* @param[out] events Here the function will store the events, replacing what it had
+*/
+
+void FlightRecorder::snapshot(vector<TraceEvent>* events) {
+
+    unsigned long long end = recorder.next.load(std::memory_order_acquire);
+    unsigned long long begin = end > FLIGHT_RECORDER_SIZE ? end - FLIGHT_RECORDER_SIZE : 0;
+
+    events->clear();
+    events->reserve(end - begin);
+
+    for(unsigned long long position = begin; position < end; ++position) {
+
+        const TraceSlot& slot = recorder.slots[position & (FLIGHT_RECORDER_SIZE - 1)];
+
+        if(slot.sequence.load(std::memory_order_acquire) != position + 1)
+            continue;
+
+        TraceEvent event;
+        event.time = slot.time.load(std::memory_order_relaxed);
+        event.fd = slot.fd.load(std::memory_order_relaxed);
+        event.result = slot.result.load(std::memory_order_relaxed);
+        event.op = slot.op.load(std::memory_order_relaxed);
+        event.error = slot.error.load(std::memory_order_relaxed);
+
+        // a new event over this one while copying it would have changed the sequence
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if(slot.sequence.load(std::memory_order_relaxed) == position + 1)
+            events->push_back(event);
+    }
+}
+
+
+NL_NAMESPACE_END
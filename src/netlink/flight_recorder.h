@@ -0,0 +1,91 @@
+/*
+    NetLink Sockets: Networking C++ library
+    Copyright 2012 Pedro Francisco Pareja Ruiz (PedroPareja@Gmail.com)
+
+    This file is part of NetLink Sockets.
+
+    NetLink Sockets is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NetLink Sockets is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NetLink Sockets. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __NL_FLIGHT_RECORDER
+#define __NL_FLIGHT_RECORDER
+
+#include "core.h"
+
+#include <vector>
+
+NL_NAMESPACE
+
+using std::vector;
+
+
+/**
+* @enum TraceOp
+*
+* Defines the socket operations the FlightRecorder records.
+*/
+
+enum TraceOp {
+
+    TRACE_ACCEPT,       /**< Accepting a connection*/
+    TRACE_CONNECT,      /**< Connecting a socket*/
+    TRACE_DISCONNECT,   /**< Closing a socket*/
+    TRACE_READ,         /**< Reading data*/
+    TRACE_SEND          /**< Sending data*/
+};
+
+
+/**
+* @struct TraceEvent flight_recorder.h netlink/flight_recorder.h
+*
+* An operation of a socket recorded by the FlightRecorder, 24 bytes in this order
+*/
+
+struct TraceEvent {
+
+    unsigned long long  time;       /**< When it ended, nanoseconds since the Unix epoch*/
+    int                 fd;         /**< The socket handler*/
+    int                 result;     /**< Bytes read or sent, the handler accepted, the DisconnectMode, or -1 when it failed*/
+    int                 op;         /**< The TraceOp*/
+    int                 error;      /**< The native error code when it failed, 0 otherwise*/
+};
+
+
+/**
+* @class FlightRecorder flight_recorder.h netlink/flight_recorder.h
+*
+* Process-wide ring of the last operations of every socket, for post-mortem analysis
+*
+* Sockets record their reads, sends, accepts, connections and disconnections as they do them.
+* Once full, the oldest events are overwritten. Recording takes an atomic increment and a few
+* relaxed stores without locking, cheap enough to always be on. Snapshots can be taken from
+* any thread while sockets record, skipping the events being overwritten.
+*/
+
+class FlightRecorder {
+
+    public:
+
+        static void record(TraceOp op, int fd, long result, int error);
+        static void snapshot(vector<TraceEvent>* events);
+
+        static size_t capacity();
+};
+
+#include "flight_recorder.inline.h"
+
+NL_NAMESPACE_END
+
+#endif
@@ -0,0 +1,42 @@
+/*
+    NetLink Sockets: Networking C++ library
+    Copyright 2012 Pedro Francisco Pareja Ruiz (PedroPareja@Gmail.com)
+
+    This file is part of NetLink Sockets.
+
+    NetLink Sockets is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NetLink Sockets is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NetLink Sockets. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#ifdef DOXYGEN
+    #include "flight_recorder.h"
+    NL_NAMESPACE
+#endif
+
+
+/**
+* Returns how many events are kept
+*
+* @return the number of events in the ring, FLIGHT_RECORDER_SIZE
+*/
+
+inline size_t FlightRecorder::capacity() {
+
+    return FLIGHT_RECORDER_SIZE;
+}
+
+#ifdef DOXYGEN
+    NL_NAMESPACE_END
+#endif
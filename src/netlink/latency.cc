@@ -0,0 +1,179 @@
+/*
+    NetLink Sockets: Networking C++ library
+    Copyright 2012 Pedro Francisco Pareja Ruiz (PedroPareja@Gmail.com)
+
+    This file is part of NetLink Sockets.
+
+    NetLink Sockets is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NetLink Sockets is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NetLink Sockets. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "latency.h"
+
+#include <chrono>
+#include <math.h>
+
+
+NL_NAMESPACE
+
+
+/*
+* Returns the position of the highest bit set of value, which must not be 0
+*/
+
+static unsigned highestBit(unsigned long long value) {
+
+    #ifdef __GNUC__
+        return 63 - __builtin_clzll(value);
+    #else
+        unsigned bit = 0;
+        while(value >>= 1)
+            bit++;
+        return bit;
+    #endif
+}
+
+
+/**
+* LatencyHistogram constructor, empty
+*/
+
+LatencyHistogram::LatencyHistogram() {
+
+    reset();
+}
+
+
+/*
+* Returns the bucket of a value: values under SUB_BUCKETS have one each, and then each power
+* of two range is split in SUB_BUCKETS of the same width
+*/
+
+unsigned LatencyHistogram::bucket(unsigned long long nanosec) {
+
+    if(nanosec < SUB_BUCKETS)
+        return (unsigned)nanosec;
+
+    unsigned exponent = highestBit(nanosec);
+
+    if(exponent > MAX_EXPONENT)
+        return BUCKETS - 1;
+
+    unsigned shift = exponent - SUB_BUCKET_BITS;
+
+    return (shift + 1) * SUB_BUCKETS + (unsigned)((nanosec >> shift) & (SUB_BUCKETS - 1));
+}
+
+
+/*
+* Returns the highest value that falls in a bucket
+*/
+
+unsigned long long LatencyHistogram::bucketTop(unsigned bucket) {
+
+    if(bucket < SUB_BUCKETS)
+        return bucket;
+
+    unsigned shift = bucket / SUB_BUCKETS - 1;
+    unsigned long long bottom = (unsigned long long)(SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+
+    return bottom + (1ULL << shift) - 1;
+}
+
+
+/**
+* Records a value
+*
+* @param nanosec the value, a duration in nanoseconds
+*/
+
+void LatencyHistogram::record(unsigned long long nanosec) {
+
+    _buckets[bucket(nanosec)].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    _total.fetch_add(nanosec, std::memory_order_relaxed);
+
+    unsigned long long current = _max.load(std::memory_order_relaxed);
+    while(nanosec > current && !_max.compare_exchange_weak(current, nanosec, std::memory_order_relaxed));
+}
+
+
+/**
+* Removes all the values recorded
+*/
+
+void LatencyHistogram::reset() {
+
+    for(unsigned i = 0; i < BUCKETS; ++i)
+        _buckets[i].store(0, std::memory_order_relaxed);
+
+    _count.store(0, std::memory_order_relaxed);
+    _total.store(0, std::memory_order_relaxed);
+    _max.store(0, std::memory_order_relaxed);
+}
+
+
+/**
+* Returns the value below which a percentage of the recorded values fall
+*
+* The value is the top of its bucket, so it may exceed the exact one by 1/16 of it at most,
+* but never the maximum.
+*
+* @param percent the percentage, like 50 for the median or 99.9
+* @return the value, in nanoseconds, 0 when empty
+*/
+
+unsigned long long LatencyHistogram::percentile(double percent) const {
+
+    unsigned long long values = count();
+
+    if(!values)
+        return 0;
+
+    unsigned long long rank = (unsigned long long)ceil(percent / 100 * values);
+
+    if(rank < 1)
+        rank = 1;
+
+    unsigned long long seen = 0;
+
+    for(unsigned i = 0; i < BUCKETS; ++i) {
+
+        seen += _buckets[i].load(std::memory_order_relaxed);
+
+        if(seen >= rank) {
+            unsigned long long top = bucketTop(i);
+            return top < max() ? top : max();
+        }
+    }
+
+    return max();
+}
+
+
+/**
+* Returns the current time, to measure durations
+*
+* @return a monotonic time, in nanoseconds
+*/
+
+unsigned long long LatencyHistogram::now() {
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+NL_NAMESPACE_END
@@ -0,0 +1,99 @@
+/*
+    NetLink Sockets: Networking C++ library
+    Copyright 2012 Pedro Francisco Pareja Ruiz (PedroPareja@Gmail.com)
+
+    This file is part of NetLink Sockets.
+
+    NetLink Sockets is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NetLink Sockets is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NetLink Sockets. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#ifndef __NL_LATENCY
+#define __NL_LATENCY
+
+#include "core.h"
+
+#include <atomic>
+
+NL_NAMESPACE
+
+
+/**
+* @enum LatencyOp
+*
+* Defines the blocking operations whose latency is recorded.
+*/
+
+enum LatencyOp {
+
+    LATENCY_ACCEPT,     /**< Accepting a connection*/
+    LATENCY_CONNECT,    /**< Connecting a TCP client*/
+    LATENCY_RECEIVE,    /**< Reading data*/
+    LATENCY_SEND        /**< Sending data*/
+};
+
+const unsigned LATENCY_OPS = LATENCY_SEND + 1;
+
+
+/**
+* @class LatencyHistogram latency.h netlink/latency.h
+*
+* Histogram of durations in nanoseconds, in the manner of HDR histograms
+*
+* Each power of two range is split in 16 linear buckets, so values are kept within 1/16 of
+* their magnitude, from 1 ns to hours, in a fixed size. Recording is a couple of relaxed
+* atomic increments, safe from any thread, and reading while recording gives a close
+* approximation.
+*/
+
+class LatencyHistogram {
+
+    public:
+
+        LatencyHistogram();
+
+        void record(unsigned long long nanosec);
+        void reset();
+
+        unsigned long long count() const;
+        unsigned long long max() const;
+        unsigned long long mean() const;
+        unsigned long long percentile(double percent) const;
+
+        static unsigned long long now();
+
+    private:
+
+        static const unsigned SUB_BUCKET_BITS = 4;
+        static const unsigned SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+        static const unsigned MAX_EXPONENT = 43;    // ~2.4 hours, longer values are clamped
+        static const unsigned BUCKETS = (MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+
+        static unsigned bucket(unsigned long long nanosec);
+        static unsigned long long bucketTop(unsigned bucket);
+
+        std::atomic<unsigned>           _buckets[BUCKETS];
+        std::atomic<unsigned long long> _count;
+        std::atomic<unsigned long long> _total;
+        std::atomic<unsigned long long> _max;
+
+        LatencyHistogram(const LatencyHistogram&);
+};
+
+#include "latency.inline.h"
+
+NL_NAMESPACE_END
+
+#endif
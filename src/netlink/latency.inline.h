@@ -0,0 +1,67 @@
+/*
+    NetLink Sockets: Networking C++ library
+    Copyright 2012 Pedro Francisco Pareja Ruiz (PedroPareja@Gmail.com)
+
+    This file is part of NetLink Sockets.
+
+    NetLink Sockets is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NetLink Sockets is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NetLink Sockets. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#ifdef DOXYGEN
+    #include "latency.h"
+    NL_NAMESPACE
+#endif
+
+
+/**
+* Returns the number of values recorded
+*
+* @return the number of values
+*/
+
+inline unsigned long long LatencyHistogram::count() const {
+
+    return _count.load(std::memory_order_relaxed);
+}
+
+
+/**
+* Returns the longest value recorded
+*
+* @return the maximum, in nanoseconds, 0 when empty
+*/
+
+inline unsigned long long LatencyHistogram::max() const {
+
+    return _max.load(std::memory_order_relaxed);
+}
+
+
+/**
+* Returns the mean of the values recorded
+*
+* @return the mean, in nanoseconds, 0 when empty
+*/
+
+inline unsigned long long LatencyHistogram::mean() const {
+
+    unsigned long long values = count();
+    return values ? _total.load(std::memory_order_relaxed) / values : 0;
+}
+
+#ifdef DOXYGEN
+    NL_NAMESPACE_END
+#endif
@@ -104,6 +104,9 @@
 
 #include <netlink/socket.h>
 #include <netlink/socket_group.h>
+#include <netlink/resolver.h>
+#include <netlink/latency.h>
+#include <netlink/flight_recorder.h>
 
 
 #endif
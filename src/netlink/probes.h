@@ -0,0 +1,50 @@
+/*
+    NetLink Sockets: Networking C++ library
+    Copyright 2012 Pedro Francisco Pareja Ruiz (PedroPareja@Gmail.com)
+
+    This file is part of NetLink Sockets.
+
+    NetLink Sockets is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NetLink Sockets is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NetLink Sockets. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __NL_PROBES
+#define __NL_PROBES
+
+/*
+* USDT (user statically defined tracing) probes of the provider "netlink", to be traced with
+* bpftrace, perf or SystemTap. They are only compiled in with NL_USDT defined on Linux, which
+* requires sys/sdt.h (systemtap-sdt-dev), and each is then a single nop until a tracer attaches.
+* Otherwise they expand to nothing.
+*
+* Their arguments are integers: the socket handler first for the probes of a socket, then what
+* the probe is about.
+*/
+
+#if defined(NL_USDT) && defined(__linux__)
+
+    #include <sys/sdt.h>
+
+    #define NL_PROBE2(name, a, b)           DTRACE_PROBE2(netlink, name, a, b)
+    #define NL_PROBE3(name, a, b, c)        DTRACE_PROBE3(netlink, name, a, b, c)
+
+#else
+
+    #define NL_PROBE2(name, a, b)
+    #define NL_PROBE3(name, a, b, c)
+
+#endif
+
+
+#endif
@@ -0,0 +1,473 @@
+/*
+    NetLink Sockets: Networking C++ library
+    Copyright 2012 Pedro Francisco Pareja Ruiz (PedroPareja@Gmail.com)
+
+    This file is part of NetLink Sockets.
+
+    NetLink Sockets is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NetLink Sockets is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NetLink Sockets. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "resolver.h"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+
+
+NL_NAMESPACE
+
+
+struct ResolverCacheEntry {
+
+    unsigned long long  expires;    // getMonotonicTime() ms
+    vector<Address>     addresses;
+};
+
+
+typedef std::pair<string, int> ResolverCacheKey; // host and address family
+
+
+static std::mutex                                       cacheMutex;
+static std::map<ResolverCacheKey, ResolverCacheEntry>   cache;
+static std::atomic<unsigned>                            cacheTTL(DEFAULT_RESOLVER_TTL);
+static std::atomic<unsigned long long>                  lookupCount(0);
+
+
+static int getSockType(Protocol protocol, const char* functionName) {
+
+    switch(protocol) {
+
+        case TCP:
+            return SOCK_STREAM;
+
+        case UDP:
+            return SOCK_DGRAM;
+
+        default:
+            throw Exception(Exception::BAD_PROTOCOL, string("Resolver::") + functionName + ": bad protocol");
+    }
+}
+
+
+static int getFamily(IPVer ipVer, const char* functionName) {
+
+    switch(ipVer) {
+
+        case IP4:
+            return AF_INET;
+
+        case IP6:
+            return AF_INET6;
+
+        case ANY:
+            return AF_UNSPEC;
+
+        default:
+            throw Exception(Exception::BAD_IP_VER, string("Resolver::") + functionName + ": bad ip version parameter");
+    }
+}
+
+
+static void setPort(Address& address, unsigned port) {
+
+    if(address.family == AF_INET)
+        ((struct sockaddr_in*)address.addr())->sin_port = htons(port);
+    else
+        ((struct sockaddr_in6*)address.addr())->sin6_port = htons(port);
+}
+
+
+/*
+* Resolves host with getaddrinfo() (or from the cache) into the addresses of a family.
+* The ports of the addresses are left to 0, so the same entry serves any port.
+*/
+
+static void lookup(const string& host, int family, bool passive, bool refresh, vector<Address>& addresses) {
+
+    bool wildcard = passive && (!host.compare("") || !host.compare("*"));
+    bool cacheable = wildcard || host.compare("");
+
+    // the wildcard address is different from the empty host name of a client
+    ResolverCacheKey key(wildcard ? string() : host, family);
+
+    if(cacheable && !refresh) {
+
+        std::lock_guard<std::mutex> lock(cacheMutex);
+
+        std::map<ResolverCacheKey, ResolverCacheEntry>::iterator it = cache.find(key);
+
+        if(it != cache.end()) {
+
+            if(it->second.expires > getMonotonicTime()) {
+                addresses = it->second.addresses;
+                return;
+            }
+
+            cache.erase(it);
+        }
+    }
+
+    struct addrinfo conf, *res = NULL;
+    memset(&conf, 0, sizeof(conf));
+
+    conf.ai_family = family;
+    conf.ai_socktype = SOCK_STREAM; // one result per address, the type is set when used
+
+    if(passive)
+        conf.ai_flags = AI_PASSIVE;
+
+    lookupCount++;
+    int status = getaddrinfo(wildcard ? NULL : host.c_str(), "0", &conf, &res);
+
+    if(status != 0) {
+
+        string errorMsg = "Resolver::resolve: Error setting addrInfo: ";
+
+        #ifndef _MSC_VER
+            errorMsg += gai_strerror(status);
+        #endif
+
+        throw Exception(Exception::ERROR_SET_ADDR_INFO, errorMsg, status);
+    }
+
+    addresses.clear();
+
+    for(struct addrinfo* it = res; it; it = it->ai_next) {
+
+        if(it->ai_family != AF_INET && it->ai_family != AF_INET6)
+            continue;
+
+        Address address;
+        memset(&address, 0, sizeof(address));
+
+        address.family = it->ai_family;
+        address.length = it->ai_addrlen;
+        memcpy(&address.storage, it->ai_addr, it->ai_addrlen);
+
+        addresses.push_back(address);
+    }
+
+    freeaddrinfo(res);
+
+    unsigned ttl = cacheTTL;
+
+    if(!cacheable || !ttl)
+        return;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+
+    if(cache.size() >= DEFAULT_RESOLVER_CACHE_SIZE) {
+
+        unsigned long long now = getMonotonicTime();
+
+        for(std::map<ResolverCacheKey, ResolverCacheEntry>::iterator it = cache.begin(); it != cache.end();)
+            if(it->second.expires <= now)
+                cache.erase(it++);
+            else
+                ++it;
+
+        if(cache.size() >= DEFAULT_RESOLVER_CACHE_SIZE)
+            cache.erase(cache.begin());
+    }
+
+    ResolverCacheEntry& entry = cache[key];
+    entry.expires = getMonotonicTime() + ttl;
+    entry.addresses = addresses;
+}
+
+
+/**
+* Resolves a host and port into socket addresses
+*
+* IP literals are converted without calling getaddrinfo(), host names are served from the
+* process-wide cache when possible.
+*
+* @param host The host to resolve. When passive, empty or "*" means all the local addresses.
+* @param port The port the addresses will have
+* @param protocol The protocol the addresses will be used with (TCP or UDP)
+* @param ipVer The IP version of the wanted addresses (IP4, IP6 or ANY)
+* @param passive true if the addresses are going to be bound, false if they are the target
+* @param[out] addresses Here the function will store the resolved addresses, in the order
+*   they should be tried
+*
+* @throw Exception BAD_PROTOCOL, BAD_IP_VER, ERROR_SET_ADDR_INFO*
+*/
+
+void Resolver::resolve(const string& host, unsigned port, Protocol protocol, IPVer ipVer,
+                        bool passive, vector<Address>& addresses) {
+
+    int sockType = getSockType(protocol, "resolve");
+    int family = getFamily(ipVer, "resolve");
+
+    addresses.clear();
+
+    Address numeric;
+
+    if(numericHost(host, ipVer, &numeric))
+        addresses.push_back(numeric);
+    else
+        lookup(host, family, passive, false, addresses);
+
+    if(addresses.empty())
+        throw Exception(Exception::ERROR_SET_ADDR_INFO, "Resolver::resolve: no address found for host " + host);
+
+    for(unsigned i=0; i < addresses.size(); ++i) {
+        addresses[i].sockType = sockType;
+        addresses[i].protocol = 0;
+        setPort(addresses[i], port);
+    }
+}
+
+
+/**
+* Resolves a target host and port into its preferred socket address
+*
+* @param host The target host to resolve
+* @param port The port the address will have
+* @param protocol The protocol the address will be used with (TCP or UDP)
+* @param ipVer The IP version of the wanted address (IP4, IP6 or ANY)
+* @param[out] address Here the function will store the resolved address
+*
+* @throw Exception BAD_PROTOCOL, BAD_IP_VER, ERROR_SET_ADDR_INFO*
+*/
+
+void Resolver::resolveFirst(const string& host, unsigned port, Protocol protocol, IPVer ipVer,
+                            Address& address) {
+
+    // fast path without vector allocations, the common case of sendTo()
+    if(numericHost(host, ipVer, &address)) {
+        address.sockType = getSockType(protocol, "resolveFirst");
+        setPort(address, port);
+        return;
+    }
+
+    vector<Address> addresses;
+    resolve(host, port, protocol, ipVer, false, addresses);
+
+    address = addresses[0];
+}
+
+
+/**
+* Resolves a host name ignoring the cache and stores the result in it
+*
+* Useful to avoid blocking on the first connection to a host.
+*
+* @param host The host name to resolve
+* @param ipVer The IP version to resolve for (IP4, IP6 or ANY). ANY (by default) warms up the
+*   cache for every IP version, and only fails if none of them could be resolved.
+* @param[out] addresses If not NULL, here the function will store the resolved addresses as strings
+* @return The number of resolved addresses
+*
+* @throw Exception BAD_IP_VER, ERROR_SET_ADDR_INFO*
+*/
+
+size_t Resolver::prewarm(const string& host, IPVer ipVer, vector<string>* addresses) {
+
+    vector<Address> resolved;
+
+    Address numeric;
+
+    if(numericHost(host, ipVer, &numeric))
+        resolved.push_back(numeric);
+
+    else if(ipVer != ANY)
+        lookup(host, getFamily(ipVer, "prewarm"), false, true, resolved);
+
+    else {
+
+        const int families[] = { AF_INET, AF_INET6, AF_UNSPEC };
+        Exception lastError(Exception::ERROR_SET_ADDR_INFO, "");
+        bool anyResolved = false;
+
+        for(unsigned i=0; i < sizeof(families) / sizeof(families[0]); ++i) {
+
+            vector<Address> found;
+
+            try {
+                lookup(host, families[i], false, true, found);
+            }
+            catch(Exception& e) {
+                lastError = e;
+                continue;
+            }
+
+            anyResolved = true;
+
+            // the unspecified family repeats the addresses of the others
+            if(families[i] != AF_UNSPEC)
+                resolved.insert(resolved.end(), found.begin(), found.end());
+        }
+
+        if(!anyResolved)
+            throw lastError;
+    }
+
+    if(addresses) {
+        addresses->clear();
+        for(unsigned i=0; i < resolved.size(); ++i)
+            addresses->push_back(toString(resolved[i]));
+    }
+
+    return resolved.size();
+}
+
+
+/**
+* Removes every entry of the cache
+*/
+
+void Resolver::flush() {
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    cache.clear();
+}
+
+
+/**
+* Removes the cache entry of a host
+*
+* @param host The host name to forget
+*/
+
+void Resolver::flush(const string& host) {
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+
+    cache.erase(ResolverCacheKey(host, AF_INET));
+    cache.erase(ResolverCacheKey(host, AF_INET6));
+    cache.erase(ResolverCacheKey(host, AF_UNSPEC));
+}
+
+
+/**
+* Returns the time to live of the cache entries
+*
+* @return milliseconds a resolved host is kept in the cache
+*/
+
+unsigned Resolver::ttl() {
+
+    return cacheTTL;
+}
+
+
+/**
+* Sets the time to live of the cache entries
+*
+* @param milisec milliseconds a resolved host is kept in the cache. 0 disables the cache.
+*/
+
+void Resolver::ttl(unsigned milisec) {
+
+    cacheTTL = milisec;
+
+    if(!milisec)
+        flush();
+}
+
+
+/**
+* Returns how many times hosts were resolved with getaddrinfo(), which the cache avoids
+*
+* @return the number of getaddrinfo() calls since the process started
+*/
+
+unsigned long long Resolver::lookups() {
+
+    return lookupCount;
+}
+
+
+/**
+* Checks if a host is an IP literal of the given IP version
+*
+* @param host The host to check
+* @param ipVer The IP version to check against (IP4, IP6 or ANY)
+* @param[out] address If not NULL and host is an IP literal, here the function will store
+*   its address (with port 0 and no socket type)
+* @return true if host is an IP literal, false otherwise
+*/
+
+bool Resolver::numericHost(const string& host, IPVer ipVer, Address* address) {
+
+    Address numeric;
+    memset(&numeric, 0, sizeof(numeric));
+
+    #ifdef OS_WIN32
+
+        struct addrinfo conf, *res = NULL;
+        memset(&conf, 0, sizeof(conf));
+
+        conf.ai_family = ipVer == IP4 ? AF_INET : ipVer == IP6 ? AF_INET6 : AF_UNSPEC;
+        conf.ai_flags = AI_NUMERICHOST;
+
+        if(!host.compare("") || getaddrinfo(host.c_str(), NULL, &conf, &res) != 0)
+            return false;
+
+        numeric.family = res->ai_family;
+        numeric.length = res->ai_addrlen;
+        memcpy(&numeric.storage, res->ai_addr, res->ai_addrlen);
+
+        freeaddrinfo(res);
+
+    #else
+
+        struct sockaddr_in* in4 = (struct sockaddr_in*)numeric.addr();
+        struct sockaddr_in6* in6 = (struct sockaddr_in6*)numeric.addr();
+
+        if(ipVer != IP6 && inet_pton(AF_INET, host.c_str(), &in4->sin_addr) == 1) {
+            in4->sin_family = AF_INET;
+            numeric.family = AF_INET;
+            numeric.length = sizeof(struct sockaddr_in);
+        }
+
+        else if(ipVer != IP4 && inet_pton(AF_INET6, host.c_str(), &in6->sin6_addr) == 1) {
+            in6->sin6_family = AF_INET6;
+            numeric.family = AF_INET6;
+            numeric.length = sizeof(struct sockaddr_in6);
+        }
+
+        else
+            return false;
+
+    #endif
+
+    if(address)
+        *address = numeric;
+
+    return true;
+}
+
+
+/**
+* Returns the numeric host of an address
+*
+* @param address The address to convert
+* @return The IP address as a string, for example "127.0.0.1" or "::1"
+*/
+
+string Resolver::toString(const Address& address) {
+
+    char hostChar[NI_MAXHOST];
+
+    if(getnameinfo(address.addr(), address.length, hostChar, sizeof hostChar, NULL, 0, NI_NUMERICHOST) != 0)
+        return "";
+
+    return hostChar;
+}
+
+
+NL_NAMESPACE_END
@@ -0,0 +1,94 @@
+/*
+    NetLink Sockets: Networking C++ library
+    Copyright 2012 Pedro Francisco Pareja Ruiz (PedroPareja@Gmail.com)
+
+    This file is part of NetLink Sockets.
+
+    NetLink Sockets is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NetLink Sockets is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NetLink Sockets. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __NL_RESOLVER
+#define __NL_RESOLVER
+
+#include "core.h"
+
+#include <vector>
+
+NL_NAMESPACE
+
+using std::vector;
+
+
+/**
+* @struct Address resolver.h netlink/resolver.h
+*
+* A resolved socket address, ready to be used with socket(), connect(), bind() or sendto()
+*/
+
+struct Address {
+
+    int                     family;     /**< Address family (AF_INET or AF_INET6)*/
+    int                     sockType;   /**< Socket type (SOCK_STREAM or SOCK_DGRAM)*/
+    int                     protocol;   /**< Socket protocol, 0 lets the OS choose*/
+    socklen_t               length;     /**< Size of the address stored in storage*/
+    struct sockaddr_storage storage;    /**< The native address*/
+
+    struct sockaddr*        addr();
+    const struct sockaddr*  addr() const;
+};
+
+
+/**
+* @class Resolver resolver.h netlink/resolver.h
+*
+* Process-wide host name resolution cache
+*
+* Every Socket resolves its hosts through this class. IP literals are converted directly
+* without calling getaddrinfo(), and host names are resolved once and then served from
+* the cache until their time to live expires.
+*
+* @note getaddrinfo() does not report DNS record TTLs, so a single TTL is used for every entry
+*/
+
+class Resolver {
+
+    public:
+
+        static void resolve(const string& host, unsigned port, Protocol protocol, IPVer ipVer,
+                                bool passive, vector<Address>& addresses);
+
+        static void resolveFirst(const string& host, unsigned port, Protocol protocol, IPVer ipVer,
+                                Address& address);
+
+        static size_t prewarm(const string& host, IPVer ipVer = ANY, vector<string>* addresses = NULL);
+
+        static void flush();
+        static void flush(const string& host);
+
+        static unsigned ttl();
+        static void ttl(unsigned milisec);
+
+        static unsigned long long lookups();
+
+        static bool numericHost(const string& host, IPVer ipVer, Address* address = NULL);
+
+        static string toString(const Address& address);
+};
+
+#include "resolver.inline.h"
+
+NL_NAMESPACE_END
+
+#endif
@@ -0,0 +1,51 @@
+/*
+    NetLink Sockets: Networking C++ library
+    Copyright 2012 Pedro Francisco Pareja Ruiz (PedroPareja@Gmail.com)
+
+    This file is part of NetLink Sockets.
+
+    NetLink Sockets is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NetLink Sockets is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NetLink Sockets. If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifdef DOXYGEN
+    #include "resolver.h"
+    NL_NAMESPACE
+#endif
+
+/**
+* Returns the native address
+*
+* @return A pointer to the address, to be used in native socket calls
+*/
+
+inline struct sockaddr* Address::addr() {
+
+    return (struct sockaddr*) &storage;
+}
+
+/**
+* Returns the native address
+*
+* @return A pointer to the address, to be used in native socket calls
+*/
+
+inline const struct sockaddr* Address::addr() const {
+
+    return (const struct sockaddr*) &storage;
+}
+
+#ifdef DOXYGEN
+    NL_NAMESPACE_END
+#endif
@@ -21,6 +21,9 @@
 
 
 #include "smart_buffer.h"
+#include "probes.h"
+
+#include <algorithm>
 
 NL_NAMESPACE_USE
 
@@ -29,18 +32,18 @@ NL_NAMESPACE_USE
 /**
 * SmartBuffer Constructor
 *
-* @param allocSize Size in bytes of the initial reserved memory.
+* @param allocSize Size in bytes of the initial reserved memory. The buffer never shrinks below it.
 * @param reallocRatio Growing ratio for memory reallocs. For example 1.5 means that
 *  each time the buffer is out of memory it reserves the previous size 1.5 times (150%).
 *
 * @throw Exception ERROR_ALLOC
 */
 
-SmartBuffer::SmartBuffer(size_t allocSize, double reallocRatio): _usedSize(0),
-                            _allocSize(allocSize), _reallocRatio(reallocRatio)
+SmartBuffer::SmartBuffer(size_t allocSize, double reallocRatio): _allocSize(allocSize ? allocSize : 1),
+                            _head(0), _usedSize(0), _minSize(_allocSize), _reallocRatio(reallocRatio)
 {
 
-    _buffer = malloc(allocSize);
+    _buffer = (char*)malloc(_allocSize);
 
     if(!_buffer)
         throw Exception(Exception::ERROR_ALLOC, "SmartBuffer::SmartBuffer: memory alloc error");
@@ -56,14 +59,33 @@ SmartBuffer::SmartBuffer(size_t allocSize, double reallocRatio): _usedSize(0),
 */
 
 
-SmartBuffer::SmartBuffer(SmartBuffer& s) : _usedSize(s._usedSize), _allocSize(s._allocSize), _reallocRatio(s._reallocRatio)
+SmartBuffer::SmartBuffer(const SmartBuffer& s) : _allocSize(std::max(s._allocSize, s._minSize)), _head(0),
+                            _usedSize(s._usedSize), _minSize(s._minSize), _reallocRatio(s._reallocRatio)
 {
-    _buffer = malloc(_allocSize);
+    _buffer = (char*)malloc(_allocSize);
 
     if(!_buffer)
         throw Exception(Exception::ERROR_ALLOC, "SmartBuffer::SmartBuffer: memory alloc error");
 
-    memcpy(_buffer, s._buffer, _usedSize);
+    s.peek(_buffer, _usedSize);
+}
+
+
+/**
+* SmartBuffer Move Constructor
+*
+* Takes the memory of s, which is left empty.
+*
+* @param s SmartBuffer source of data.
+*/
+
+SmartBuffer::SmartBuffer(SmartBuffer&& s) : _buffer(s._buffer), _allocSize(s._allocSize), _head(s._head),
+                            _usedSize(s._usedSize), _minSize(s._minSize), _reallocRatio(s._reallocRatio)
+{
+    s._buffer = NULL;
+    s._allocSize = 0;
+    s._head = 0;
+    s._usedSize = 0;
 }
 
 
@@ -77,45 +99,320 @@ SmartBuffer::~SmartBuffer() {
         free(_buffer);
 }
 
+
+/*
+* Moves the data to a new block of allocSize bytes (at least size()), unwrapping it
+*/
+
+void SmartBuffer::resize(size_t allocSize) {
+
+    char* newBuffer = (char*)malloc(allocSize);
+
+    if(!newBuffer)
+        throw Exception(Exception::ERROR_ALLOC, "SmartBuffer::resize: memory alloc error");
+
+    peek(newBuffer, _usedSize);
+
+    if(_buffer != NULL)
+        free(_buffer);
+
+    _buffer = newBuffer;
+    _allocSize = allocSize;
+    _head = 0;
+}
+
+
+void SmartBuffer::grow(size_t minAllocSize) {
+
+    size_t allocSize = minAllocSize;
+
+    // in double, so big buffers are not truncated to 32 bits
+    double scaled = _allocSize * _reallocRatio;
+
+    if(scaled >= (double)(size_t)-1)
+        allocSize = (size_t)-1;
+    else if((size_t)scaled > allocSize)
+        allocSize = (size_t)scaled;
+
+    resize(allocSize);
+}
+
+
+/*
+* Makes the data contiguous, moving it to the beginning of the buffer. Does not allocate.
+*/
+
+void SmartBuffer::linearize() const {
+
+    std::rotate(_buffer, _buffer + _head, _buffer + _allocSize);
+    _head = 0;
+}
+
+
 /**
 * Inserts the data read from a socket in the buffer
 *
+* Reads while the socket has data available, growing the buffer as needed. Each read fills
+* both free parts of the ring (after the data and before it) at once.
+*
 * @param socket Socket to be used as source
+* @return The amount of bytes read. 0 when the socket is non-blocking and has no data, or
+*  when the connection was closed by the other side.
 *
-* @throw Exception ERROR_ALLOC, ERROR_READ*
+* @throw Exception ERROR_ALLOC, ERROR_READ*, ERROR_IOCTL*
 */
 
 
-void SmartBuffer::read(Socket* socket) {
+size_t SmartBuffer::read(Socket* socket) {
 
+    size_t total = 0;
     size_t incomingBytes = socket->nextReadSize();
 
     do {
 
         size_t freeBytes = _allocSize - _usedSize;
 
-        if(incomingBytes > freeBytes || !freeBytes) {
+        if(incomingBytes > freeBytes || !freeBytes)
+            grow(_usedSize + (incomingBytes ? incomingBytes : 1));
 
-            size_t newAllocSize = uMax((unsigned)(_allocSize * _reallocRatio), _usedSize + incomingBytes);
+        if(!_usedSize)
+            _head = 0;
 
-            void* newBuffer = realloc(_buffer, newAllocSize);
+        size_t tailPos = tail();
+        size_t segments = 1;
 
-            if(!newBuffer)
-                throw Exception(Exception::ERROR_ALLOC, "SmartBuffer::Read: memory alloc error");
+        char* first = _buffer + tailPos;
+        size_t firstSize = (_usedSize && tailPos <= _head) ? _head - tailPos : _allocSize - tailPos;
+        size_t secondSize = (_usedSize && tailPos > _head) ? _head : 0;
 
-            _buffer = newBuffer;
+        if(secondSize)
+            segments = 2;
 
-            _allocSize = newAllocSize;
+        unsigned long long start = socket->latencyStart();
 
-            freeBytes = _allocSize - _usedSize;
-        }
+        #ifdef OS_WIN32
+
+            // WSABUF lengths are 32 bits
+            WSABUF buffers[2];
+            buffers[0].buf = first;
+            buffers[0].len = (ULONG)std::min(firstSize, (size_t)0x7FFFFFFF);
+            buffers[1].buf = _buffer;
+            buffers[1].len = (ULONG)std::min(secondSize, (size_t)0x7FFFFFFF);
+
+            DWORD received = 0, flags = 0;
+
+            if(WSARecv(socket->socketHandler(), buffers, segments, &received, &flags, NULL, NULL) == SOCKET_ERROR) {
+
+                socket->countRead(-1);
+                socket->latencyEnd(LATENCY_RECEIVE, start);
+
+                if(WSAGetLastError() == WSAEWOULDBLOCK)
+                    break;
+
+                throw Exception(Exception::ERROR_READ, "SmartBuffer::read: error detected", WSAGetLastError());
+            }
+
+            long status = received;
+            socket->countRead(status);
+            socket->latencyEnd(LATENCY_RECEIVE, start);
+
+        #else
 
-        _usedSize += socket->read((char*)_buffer + _usedSize, freeBytes);
+            struct iovec buffers[2];
+            buffers[0].iov_base = first;
+            buffers[0].iov_len = firstSize;
+            buffers[1].iov_base = _buffer;
+            buffers[1].iov_len = secondSize;
+
+            ssize_t status = readv(socket->socketHandler(), buffers, segments);
+            socket->countRead((long)status);
+            socket->latencyEnd(LATENCY_RECEIVE, start);
+            NL_PROBE3(read, socket->socketHandler(), firstSize + secondSize, status);
+
+            if(status == -1) {
+
+                if(errno == EAGAIN || errno == EWOULDBLOCK)
+                    break;
+
+                throw Exception(Exception::ERROR_READ, "SmartBuffer::read: error detected", errno);
+            }
+
+        #endif
+
+        if(!status)
+            break;
+
+        _usedSize += status;
+        total += status;
 
     } while ((incomingBytes = socket->nextReadSize()));
 
+    return total;
+}
+
+
+/**
+* Returns room for size more bytes of data, contiguous, right after the current data
+*
+* Write the data there and then commit() it. The buffer grows if needed.
+*
+* @param size The amount of bytes that are going to be written
+* @return Where to write them
+*
+* @throw Exception ERROR_ALLOC
+*/
+
+void* SmartBuffer::reserve(size_t size) {
+
+    if(_allocSize - _usedSize < size)
+        grow(_usedSize + size);
+
+    if(!_usedSize)
+        _head = 0;
+
+    size_t tailPos = tail();
+    size_t contiguous = (_usedSize && tailPos <= _head) ? _head - tailPos : _allocSize - tailPos;
+
+    if(contiguous < size) {
+        linearize();
+        tailPos = tail();
+    }
+
+    return _buffer + tailPos;
 }
 
+
+/**
+* Adds to the data the size bytes written where reserve() pointed
+*
+* @param size The amount of bytes written
+*
+* @throw Exception OUT_OF_RANGE
+*/
+
+void SmartBuffer::commit(size_t size) {
+
+    if(size > _allocSize - _usedSize)
+        throw Exception(Exception::OUT_OF_RANGE, "SmartBuffer::commit: size bigger than the reserved space");
+
+    _usedSize += size;
+}
+
+
+/**
+* Copies data out of the buffer without removing it
+*
+* @param buffer Where to copy the data to
+* @param size The maximum amount of bytes to copy
+* @param offset The position of the data to start copying from
+* @return The amount of bytes copied
+*/
+
+size_t SmartBuffer::peek(void* buffer, size_t size, size_t offset) const {
+
+    if(offset >= _usedSize)
+        return 0;
+
+    size = std::min(size, _usedSize - offset);
+
+    size_t start = (_head + offset) % _allocSize;
+    size_t first = std::min(size, _allocSize - start);
+
+    memcpy(buffer, _buffer + start, first);
+    memcpy((char*)buffer + first, _buffer, size - first);
+
+    return size;
+}
+
+
+/**
+* Removes data from the beginning of the buffer
+*
+* Once the data left uses a quarter of the buffer or less, the buffer shrinks to a half
+* (but not below its initial size). Shrinking less than growing keeps a buffer that
+* fills and empties repeatedly from reallocating each time.
+*
+* @param size The amount of bytes to remove. All the data, if bigger than size().
+*/
+
+void SmartBuffer::consume(size_t size) {
+
+    size = std::min(size, _usedSize);
+
+    _usedSize -= size;
+    _head = _usedSize ? (_head + size) % _allocSize : 0;
+
+    if(_allocSize > _minSize && _usedSize <= _allocSize / 4) {
+
+        try {
+            resize(std::max(_allocSize / 2, _minSize));
+        }
+        catch(Exception&) {
+            // keeping the bigger buffer is fine
+        }
+    }
+}
+
+
+/**
+* Tells if a whole frame, as Socket::sendFrame() sends them, is at the beginning of the buffer
+*
+* @param format The prefix of the frame, and its largest size
+* @param[out] frameSize The size of the frame, without its prefix, when it is whole
+* @return true if the prefix and all the frame are buffered
+*
+* @throw Exception OUT_OF_RANGE, when the prefix is bigger than format.maxSize: the stream
+*  can not be delimited any further
+*/
+
+bool SmartBuffer::nextFrame(const FrameFormat& format, size_t* frameSize) const {
+
+    unsigned char prefix[4];
+
+    if(format.prefixSize > sizeof(prefix) || peek(prefix, format.prefixSize) < format.prefixSize)
+        return false;
+
+    size_t size = format.frameSize(prefix);
+
+    if(size > format.maxSize)
+        throw Exception(Exception::OUT_OF_RANGE, "SmartBuffer::nextFrame: the frame is bigger than the maximum size");
+
+    *frameSize = size;
+
+    return _usedSize - format.prefixSize >= size;
+}
+
+
+/**
+* Finds a delimiter in the data, with findDelimiter()
+*
+* The data is made contiguous first, if it wraps around the end of the buffer.
+*
+* @param delimiter The delimiter to find
+* @param delimiterSize Size of delimiter
+* @param[out] position Where the delimiter starts, from the beginning of the data, when found
+* @param offset The position of the data to start looking from, such as where a previous
+*  search left it
+* @return true if the delimiter was found
+*/
+
+bool SmartBuffer::find(const void* delimiter, size_t delimiterSize, size_t* position, size_t offset) const {
+
+    if(offset >= _usedSize)
+        return false;
+
+    const char* data = (const char*)buffer();
+    const char* found = findDelimiter(data + offset, _usedSize - offset, (const char*)delimiter, delimiterSize);
+
+    if(!found)
+        return false;
+
+    *position = found - data;
+
+    return true;
+}
+
+
 /**
 * Copy Operator.
 *
@@ -124,26 +421,48 @@ void SmartBuffer::read(Socket* socket) {
 * @throw Exception ERROR_ALLOC
 */
 
-SmartBuffer& SmartBuffer::operator=(SmartBuffer& s)
+SmartBuffer& SmartBuffer::operator=(const SmartBuffer& s)
 {
-    _usedSize = s._usedSize;
+    if(this == &s)
+        return *this;
 
-    if(_allocSize < s._usedSize)
+    if(_allocSize < s._usedSize || !_buffer)
     {
-        if(_buffer != NULL)
-            free(_buffer);
+        char* newBuffer = (char*)malloc(std::max(s._usedSize, _minSize));
 
-        _allocSize = s._usedSize;
+        if(!newBuffer)
+            throw Exception(Exception::ERROR_ALLOC, "SmartBuffer::operator=: memory alloc error");
 
-        _buffer = malloc(_allocSize);
+        if(_buffer != NULL)
+            free(_buffer);
 
-        if(!_buffer)
-            throw Exception(Exception::ERROR_ALLOC, "SmartBuffer::operator=: memory alloc error");
+        _buffer = newBuffer;
+        _allocSize = std::max(s._usedSize, _minSize);
     }
 
-    memcpy(_buffer, s._buffer, s._usedSize);
+    _usedSize = s.peek(_buffer, s._usedSize);
+    _head = 0;
 
     return *this;
 }
 
 
+/**
+* Move Operator.
+*
+* Swaps the memory of both buffers.
+*
+* @param s SmartBuffer source of data.
+*/
+
+SmartBuffer& SmartBuffer::operator=(SmartBuffer&& s)
+{
+    std::swap(_buffer, s._buffer);
+    std::swap(_allocSize, s._allocSize);
+    std::swap(_head, s._head);
+    std::swap(_usedSize, s._usedSize);
+    std::swap(_minSize, s._minSize);
+    std::swap(_reallocRatio, s._reallocRatio);
+
+    return *this;
+}
@@ -39,7 +39,9 @@ NL_NAMESPACE
 *
 * Smart Buffer Class
 *
-* Buffer class to retrieve data of unknown size easily from a Socket
+* Buffer class to retrieve data of unknown size easily from a Socket. The data is kept
+* in a ring: it can be consumed from the front without moving the rest. The buffer grows
+* as needed and, once most of the data is consumed, shrinks back (never below its initial size).
 */
 
 
@@ -47,15 +49,23 @@ class SmartBuffer {
 
     private:
 
-        void*   _buffer;
-        size_t  _usedSize;
-        size_t  _allocSize;
-        double  _reallocRatio;
+        char*           _buffer;
+        size_t          _allocSize;
+        mutable size_t  _head;
+        size_t          _usedSize;
+        size_t          _minSize;
+        double          _reallocRatio;
+
+        size_t tail() const;
+        void resize(size_t allocSize);
+        void grow(size_t minAllocSize);
+        void linearize() const;
 
     public:
 
         SmartBuffer(size_t allocSize = DEFAULT_SMARTBUFFER_SIZE, double reallocRatio = DEFAULT_SMARTBUFFER_REALLOC_RATIO);
-        SmartBuffer(SmartBuffer& s);
+        SmartBuffer(const SmartBuffer& s);
+        SmartBuffer(SmartBuffer&& s);
         ~SmartBuffer();
 
         const void* operator*() const;
@@ -63,12 +73,22 @@ class SmartBuffer {
 
         const void* buffer() const;
         size_t size() const;
+        size_t capacity() const;
+
+        size_t read(Socket* socket);
+
+        void* reserve(size_t size);
+        void commit(size_t size);
+        size_t peek(void* buffer, size_t size, size_t offset = 0) const;
+        void consume(size_t size);
 
-        void read(Socket* socket);
+        bool nextFrame(const FrameFormat& format, size_t* frameSize) const;
+        bool find(const void* delimiter, size_t delimiterSize, size_t* position, size_t offset = 0) const;
 
         void clear();
 
-        SmartBuffer& operator=(SmartBuffer& s);
+        SmartBuffer& operator=(const SmartBuffer& s);
+        SmartBuffer& operator=(SmartBuffer&& s);
 };
 
 #include "smart_buffer.inline.h"
@@ -34,7 +34,7 @@
 
 inline const void* SmartBuffer::operator*() const {
 
-    return _buffer;
+    return buffer();
 }
 
 
@@ -52,18 +52,24 @@ inline const char* SmartBuffer::operator[](size_t index) const {
     if(index >= _usedSize)
         throw Exception(Exception::OUT_OF_RANGE, "SmartBuffer::operator[]: index out of range");
 
-    return (char*) _buffer + index;
+    return _buffer + (_head + index) % _allocSize;
 }
 
 /**
 * Returns the buffer data address. Same of operator*()
 *
+* The data is moved to the beginning of the buffer first, if it wraps around its end,
+* so it can be read contiguously.
+*
 * @return A pointer to data
 */
 
 inline const void* SmartBuffer::buffer() const {
 
-    return _buffer;
+    if(_head + _usedSize > _allocSize)
+        linearize();
+
+    return _buffer + _head;
 }
 
 /**
@@ -77,6 +83,17 @@ inline size_t SmartBuffer::size() const {
     return _usedSize;
 }
 
+/**
+* Returns the amount of bytes the buffer can hold before growing
+*
+* @return Size of the reserved memory
+*/
+
+inline size_t SmartBuffer::capacity() const {
+
+    return _allocSize;
+}
+
 /**
 * Clears the buffer.
 *
@@ -86,9 +103,15 @@ inline size_t SmartBuffer::size() const {
 inline void SmartBuffer::clear() {
 
     _usedSize = 0;
+    _head = 0;
+}
+
+
+inline size_t SmartBuffer::tail() const {
+
+    return _allocSize ? (_head + _usedSize) % _allocSize : 0;
 }
 
 #ifdef DOXYGEN
     NL_NAMESPACE_END
 #endif
-
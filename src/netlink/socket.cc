@@ -21,9 +21,15 @@
 
 
 #include "socket.h"
+#include "flight_recorder.h"
+#include "probes.h"
+#include "resolver.h"
 
+#include <algorithm>
 #include <string.h>
 #include <stdio.h>
+#include <stddef.h>
+#include <atomic>
 
 
 NL_NAMESPACE
@@ -36,11 +42,16 @@ NL_NAMESPACE
 	}
 
 
-	static void freeaddrinfo(struct addrinfo* addrInfo) {
-		(void)::freeaddrinfo(addrInfo);
+	static int poll(struct pollfd* fds, unsigned long count, int timeout) {
+		return WSAPoll(fds, count, timeout);
 	}
 
 
+	#ifndef SHUT_WR
+		#define SHUT_WR SD_SEND
+	#endif
+
+
 	static const char *inet_ntop(int af, const void *src, char *dst, socklen_t cnt)
 	{
 			if (af == AF_INET)
@@ -69,6 +80,71 @@ NL_NAMESPACE
 #endif
 
 
+#ifdef OS_WIN32
+    static const int CONNECT_TIMED_OUT = WSAETIMEDOUT;
+    static const int NO_SOURCE_ADDRESS = WSAEAFNOSUPPORT;
+#else
+    static const int CONNECT_TIMED_OUT = ETIMEDOUT;
+    static const int NO_SOURCE_ADDRESS = EAFNOSUPPORT;
+#endif
+
+
+static const unsigned MAX_LISTEN_QUEUE = 0x3FFFFF; // fits Socket::_listenQueue
+
+
+#if defined(__linux__) && !defined(IP_BIND_ADDRESS_NO_PORT)
+    #define IP_BIND_ADDRESS_NO_PORT 24
+#endif
+
+
+#ifdef __linux__
+
+    #include <netinet/udp.h>
+
+    #ifndef UDP_SEGMENT
+        #define UDP_SEGMENT 103
+    #endif
+
+    #ifndef UDP_GRO
+        #define UDP_GRO 104
+    #endif
+
+    #include <linux/errqueue.h>
+
+    #ifndef SO_ZEROCOPY
+        #define SO_ZEROCOPY 60
+    #endif
+
+    #ifndef MSG_ZEROCOPY
+        #define MSG_ZEROCOPY 0x4000000
+    #endif
+
+    #ifndef SO_EE_ORIGIN_ZEROCOPY
+        #define SO_EE_ORIGIN_ZEROCOPY 5
+    #endif
+
+    #ifndef SO_EE_CODE_ZEROCOPY_COPIED
+        #define SO_EE_CODE_ZEROCOPY_COPIED 1
+    #endif
+
+    #include <netinet/tcp.h>
+    #include <linux/sock_diag.h>
+
+    #ifndef SO_RXQ_OVFL
+        #define SO_RXQ_OVFL 40
+    #endif
+
+    #ifndef SO_MEMINFO
+        #define SO_MEMINFO 55
+    #endif
+
+#endif
+
+
+static const unsigned MAX_GSO_SEGMENTS = 64;        // UDP_MAX_SEGMENTS of the oldest kernels with UDP_SEGMENT
+static const unsigned MAX_DATAGRAM_PAYLOAD = 65507; // of an UDP datagram over IPv4, the smallest
+
+
 static unsigned getInPort(struct sockaddr* sa) {
 
     if (sa->sa_family == AF_INET)
@@ -106,579 +182,3194 @@ static unsigned getLocalPort(int socketHandler) {
 }
 
 
-static void checkReadError(const string& functionName) {
+static void checkReadError(const char* message) {
 
     #ifdef OS_WIN32
         if(WSAGetLastError() != WSAEWOULDBLOCK)
-            throw Exception(Exception::ERROR_READ, string("Socket::") + functionName + ": error detected", getSocketErrorCode());
+            throw Exception(Exception::ERROR_READ, message, getSocketErrorCode());
     #else
         if(errno != EAGAIN && errno != EWOULDBLOCK)
-            throw Exception(Exception::ERROR_READ, string("Socket::") + functionName + ": error detected", getSocketErrorCode());
+            throw Exception(Exception::ERROR_READ, message, getSocketErrorCode());
     #endif
 }
 
 
-void Socket::initSocket() {
-
-    struct addrinfo conf, *res = NULL;
-    memset(&conf, 0, sizeof(conf));
+#ifndef OS_WIN32
 
-    if(_type == SERVER || _protocol == UDP)
-        conf.ai_flags = AI_PASSIVE;
+    /*
+    * Room for all the control data the OS can add to a received message: the arrival time of
+    * receiveTimestamps(), the drop count of dropCounting() and the datagram size of
+    * receiveOffload(). A smaller buffer gets the ones that do not fit cut off.
+    */
 
+    static const size_t RECEIVE_CONTROL_SIZE = CMSG_SPACE(sizeof(struct timespec))
+        + CMSG_SPACE(sizeof(uint32_t)) + CMSG_SPACE(sizeof(int));
 
-    switch(_protocol) {
 
-        case TCP:
-            conf.ai_socktype = SOCK_STREAM;
-            break;
+    /*
+    * If the control message holds size bytes of data, which it does not when it was cut off.
+    */
 
-        case UDP:
-            conf.ai_socktype = SOCK_DGRAM;
-            break;
+    static bool controlFits(struct cmsghdr* header, size_t size) {
 
-        default:
-            throw Exception(Exception::BAD_PROTOCOL, "Socket::initSocket: bad protocol");
+        return header->cmsg_len >= CMSG_LEN(size);
     }
 
-    switch(_ipVer) {
-
-        case IP4:
-            conf.ai_family = AF_INET;
-            break;
-
-        case IP6:
-            conf.ai_family = AF_INET6;
-            break;
+#endif
 
-        case ANY:
-            conf.ai_family = AF_UNSPEC;
-            break;
 
-        default:
-            throw Exception(Exception::BAD_IP_VER, "Socket::initSocket: bad ip version parameter");
-    }
+#ifdef __linux__
 
+    /*
+    * Returns the count of packets the OS dropped for the socket, which it adds to the control
+    * data of received messages once SO_RXQ_OVFL is enabled. 0 when it is not there.
+    */
 
-    char portStr[10];
+    static unsigned long long getDrops(struct msghdr* message) {
 
-    const char* host;
+        for(struct cmsghdr* header = CMSG_FIRSTHDR(message); header; header = CMSG_NXTHDR(message, header))
+            if(header->cmsg_level == SOL_SOCKET && header->cmsg_type == SO_RXQ_OVFL
+                    && controlFits(header, sizeof(uint32_t))) {
+                uint32_t drops;
+                memcpy(&drops, CMSG_DATA(header), sizeof(drops));
+                return drops;
+            }
 
-    if(_type == CLIENT && _protocol == TCP) {
-        host = _hostTo.c_str();
-        snprintf(portStr, 10, "%u", _portTo);
+        return 0;
     }
-    else {
-        if(!_hostFrom.compare("") || !_hostFrom.compare("*"))
-            host = NULL;
-        else
-            host = _hostFrom.c_str();
 
-        snprintf(portStr, 10, "%u", _portFrom);
-    }
+#endif
 
-    int status = getaddrinfo(host, portStr, &conf, &res);
 
-    ReleaseManager<struct addrinfo> addrInfoReleaser(freeaddrinfo);
-    addrInfoReleaser.add(res);
+static int setHandlerBlocking(int socketHandler, bool blocking) {
 
-    if(status != 0) {
+    #ifdef OS_WIN32
 
-        string errorMsg = "Socket::initSocket: Error setting addrInfo: ";
+        u_long non_blocking = !blocking;
+        return ioctlsocket(socketHandler, FIONBIO, &non_blocking) == 0 ? 0 : -1;
+    #else
 
-		#ifndef _MSC_VER
-			errorMsg += gai_strerror(status);
-		#endif
+        int flags = fcntl(socketHandler, F_GETFL);
 
-        throw Exception(Exception::ERROR_SET_ADDR_INFO, errorMsg, getSocketErrorCode());
-    }
+        if(flags == -1)
+            return -1;
 
-    bool connected = false;
+        if(blocking)
+            return fcntl(socketHandler, F_SETFL, flags & ~O_NONBLOCK);
+        else
+            return fcntl(socketHandler, F_SETFL, flags | O_NONBLOCK);
+    #endif
+}
 
-    while(!connected && res) {
 
-        _socketHandler = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+/*
+* Fills addr with the AF_UNIX address of path and returns its length. Paths starting
+* with '@' are names in the (Linux) abstract namespace, which are not files.
+*/
 
-        if(_socketHandler != -1)
+static socklen_t unixAddress(const string& path, struct sockaddr_un* addr) {
 
-            switch(_type) {
+    if(path.size() >= sizeof(addr->sun_path))
+        throw Exception(Exception::OUT_OF_RANGE, "Socket::(static)unixAddress: path too long");
 
-                case CLIENT:
-                    if(_protocol == UDP) {
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    memcpy(addr->sun_path, path.data(), path.size());
 
-                        if (bind(_socketHandler, res->ai_addr, res->ai_addrlen) == -1)
-                            close(_socketHandler);
-                        else
-                            connected = true;
-                    }
-                    else {
-                        status = connect(_socketHandler, res->ai_addr, res->ai_addrlen);
-                        if(status != -1)
-                            connected = true;
-                        else
-                            close(_socketHandler);
-                    }
+    if(!path.empty() && path[0] == '@') {
+        addr->sun_path[0] = '\0';
+        return (socklen_t)(offsetof(struct sockaddr_un, sun_path) + path.size());
+    }
 
-                    break;
+    return (socklen_t)(offsetof(struct sockaddr_un, sun_path) + path.size() + 1);
+}
 
-                case SERVER:
-                    #ifdef OS_WIN32
-                        char yes = 1;
-                    #else
-                        int yes = 1;
-                    #endif
 
-                    if (setsockopt(_socketHandler, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(int)) == -1)
-                        throw Exception(Exception::ERROR_SET_SOCK_OPT, "Socket::initSocket: Error establishing socket options");
+/*
+* Returns the path of the AF_UNIX address addr of the given length, with '@' in place
+* of the leading zero of abstract names. Empty for unnamed sockets.
+*/
 
-                    if (bind(_socketHandler, res->ai_addr, res->ai_addrlen) == -1)
-                        close(_socketHandler);
-                    else
-                        connected = true;
+static string unixPath(const struct sockaddr_un* addr, socklen_t length) {
 
-                    if (_protocol == TCP && listen(_socketHandler, _listenQueue) == -1)
-                        throw Exception(Exception::ERROR_CAN_NOT_LISTEN, "Socket::initSocket: could not start listening", getSocketErrorCode());
+    size_t offset = offsetof(struct sockaddr_un, sun_path);
 
-                    break;
+    if(length <= offset)
+        return string();
 
-            }
+    size_t size = length - offset;
 
-    if(connected && _ipVer == ANY)
-        switch(res->ai_family) {
-            case AF_INET:
-                _ipVer = IP4;
-                break;
+    if(addr->sun_path[0] == '\0')
+        return "@" + string(addr->sun_path + 1, size - 1);
 
-            case AF_INET6:
-                _ipVer = IP6;
-                break;
-        }
+    return string(addr->sun_path, strnlen(addr->sun_path, size));
+}
 
-    res = res->ai_next;
 
-    }
+static bool wouldBlock() {
 
-    if(!connected)
-        throw Exception(Exception::ERROR_CONNECT_SOCKET, "Socket::initSocket: error in socket connection/bind", getSocketErrorCode());
+    #ifdef OS_WIN32
+        return WSAGetLastError() == WSAEWOULDBLOCK;
+    #else
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    #endif
+}
 
 
-    if(!_portFrom)
-        _portFrom = getLocalPort(_socketHandler);
+static bool connectInProgress() {
 
-    //freeaddrinfo(res);
+    #ifdef OS_WIN32
+        return WSAGetLastError() == WSAEWOULDBLOCK;
+    #else
+        return errno == EINPROGRESS;
+    #endif
 }
 
-/**
-* CLIENT Socket constructor
-*
-* Creates a socket, connect it (if TCP) and sets it ready to send to hostTo:portTo.
-* The local port of the socket is choosen by OS.
-*
-* @param hostTo the target/remote host
-* @param portTo the target/remote port
-* @param protocol the protocol to be used (TCP or UDP). TCP by default.
-* @param ipVer the IP version to be used (IP4, IP6 or ANY). ANY by default.
-* @throw Exception BAD_PROTOCOL, BAD_IP_VER, ERROR_SET_ADDR_INFO*, ERROR_CONNECT_SOCKET*,
-*  ERROR_GET_ADDR_INFO*
-*/
 
+static bool pollInterrupted() {
 
-Socket::Socket(const string& hostTo, unsigned portTo, Protocol protocol, IPVer ipVer) :
-                _hostTo(hostTo), _portTo(portTo), _portFrom(0), _protocol(protocol),
-                _ipVer(ipVer), _type(CLIENT), _blocking(true), _listenQueue(0)
-{
-    initSocket();
+    #ifdef OS_WIN32
+        return false;
+    #else
+        return errno == EINTR;
+    #endif
 }
 
 
-/**
-* SERVER Socket constructor
-*
-* Creates a socket, binds it to portFrom port and listens for connections (if TCP).
-*
-* @param portFrom the local port the socket will be bound to
-* @param protocol the protocol to be used (TCP or UDP). TCP by default.
-* @param ipVer the IP version to be used (IP4, IP6 or ANY). IP4 by default.
-* @param hostFrom the local address to be binded to (example: "localhost" or "127.0.0.1"). Empty (by default) or "*" means all avariable addresses.
-* @param listenQueue the size of the internal buffer of the SERVER TCP socket where the connection requests are stored until accepted
-* @throw Exception BAD_PROTOCOL, BAD_IP_VER, ERROR_SET_ADDR_INFO*, ERROR_SET_SOCK_OPT*,
-*  ERROR_CAN_NOT_LISTEN*, ERROR_CONNECT_SOCKET*
-*/
+static int getConnectError(int socketHandler) {
 
-Socket::Socket(unsigned portFrom, Protocol protocol, IPVer ipVer, const string& hostFrom, unsigned listenQueue):
-                _hostFrom(hostFrom), _portTo(0), _portFrom(portFrom), _protocol(protocol),
-                _ipVer(ipVer), _type(SERVER), _blocking(true), _listenQueue(listenQueue)
-{
-    initSocket();
-}
+    int error = 0;
 
-/**
-* UDP CLIENT Socket Constructor
-*
-* This client constructor for UDP Sockets allows to expecify the local port the socket
-* will be bound to. It sets the socket ready to send data to hostTo:portTo.
-*
-* @param hostTo the target/remote host
-* @param portTo the target/remote port
-* @param portFrom the local port the socket will be bound to
-* @param ipVer the IP version to be used (IP4, IP6 or ANY). ANY by default.
-* @throw Exception BAD_PROTOCOL, BAD_IP_VER, ERROR_SET_ADDR_INFO*, ERROR_SET_SOCK_OPT*,
-*  ERROR_CAN_NOT_LISTEN*, ERROR_CONNECT_SOCKET*
-*/
+    #ifdef OS_WIN32
+        int size = sizeof(error);
+    #else
+        socklen_t size = sizeof(error);
+    #endif
 
-Socket::Socket(const string& hostTo, unsigned portTo, unsigned portFrom, IPVer ipVer):
-                _hostTo(hostTo), _portTo(portTo), _portFrom(portFrom), _protocol(UDP),
-                _ipVer(ipVer), _type(CLIENT), _blocking(true), _listenQueue(0)
-{
+    if(getsockopt(socketHandler, SOL_SOCKET, SO_ERROR, (char*)&error, &size) == -1)
+        return getSocketErrorCode();
 
-    initSocket();
+    return error;
 }
 
 
-Socket::Socket() : _blocking(true), _socketHandler(-1) {};
+/*
+* Sorts the addresses as RFC 8305 (Happy Eyeballs v2) section 4 describes: the preferred
+* (first) family keeps the lead and from there on the address families alternate.
+*/
 
+static void interleaveFamilies(vector<Address>& addresses) {
 
-/**
-* Socket Destructor
-*
-* Closes (disconnects) the socket
-*/
+    if(addresses.size() < 3)
+        return;
 
-Socket::~Socket() {
+    vector<Address> preferred, other;
 
-    if(_socketHandler != -1)
-        close(_socketHandler);
+    for(unsigned i=0; i < addresses.size(); ++i)
+        if(addresses[i].family == addresses[0].family)
+            preferred.push_back(addresses[i]);
+        else
+            other.push_back(addresses[i]);
 
-}
+    addresses.clear();
 
+    for(unsigned i=0; i < preferred.size() || i < other.size(); ++i) {
 
-// get sockaddr, IPv4 or IPv6:
-// This function is from Brian “Beej Jorgensen” Hall: Beej's Guide to Network Programming.
-static void *get_in_addr(struct sockaddr *sa)
-{
-    if (sa->sa_family == AF_INET) {
-        return &(((struct sockaddr_in*)sa)->sin_addr);
+        if(i < preferred.size())
+            addresses.push_back(preferred[i]);
+
+        if(i < other.size())
+            addresses.push_back(other[i]);
     }
-    return &(((struct sockaddr_in6*)sa)->sin6_addr);
 }
 
 
-/**
-* Accepts a new incoming connection (SERVER Socket).
-*
-* Creates a new CLIENT socket to handle the communication (send/recieve data) of
-* this accepted connection. Requires the socket to be a SERVER TCP socket. Throws an
-* exception otherwise.
-*
-* @pre Socket must be SERVER
-* @return A CLIENT socket that handles the new connection
-* @throw Exception EXPECTED_TCP_SOCKET, EXPECTED_SERVER_SOCKET
+/*
+* Non-blocking connection establishment. Each ConnectRace connects to one target: it starts
+* a connection attempt to its next address every attemptDelay milisecs (or as soon as an
+* attempt fails) and keeps the first attempt that succeeds, closing the rest. Each attempt
+* is bound to one of the source addresses first, if any.
 */
 
-Socket* Socket::accept() {
-
-    if(_protocol != TCP)
-        throw Exception(Exception::EXPECTED_TCP_SOCKET, "Socket::accept: non-tcp socket can not accept connections");
+struct ConnectAttempt {
 
-    if(_type != SERVER)
-        throw Exception(Exception::EXPECTED_SERVER_SOCKET, "Socket::accept: non-server socket can not accept connections");
+    int     handler;
+    size_t  address;
+    int     source;
+};
 
-    struct sockaddr_storage incoming_addr;
 
-    #ifdef OS_WIN32
-        int addrSize = sizeof(incoming_addr);
-    #else
-        unsigned addrSize = sizeof(incoming_addr);
-    #endif
+struct ConnectRace {
 
-    int new_handler = ::accept(_socketHandler, (struct sockaddr *)&incoming_addr, &addrSize);
+    vector<Address>         addresses;
+    size_t                  next;
+    vector<ConnectAttempt>  attempts;
+    unsigned long long      nextAttemptTime;
 
-    if(new_handler == -1)
-        return NULL;
+    int                     handler;
+    size_t                  winner;
+    int                     winnerSource;
+    int                     error;
+    bool                    done;
 
-    char hostChar[INET6_ADDRSTRLEN];
-    inet_ntop(incoming_addr.ss_family, get_in_addr((struct sockaddr *)&incoming_addr), hostChar, sizeof hostChar);
+    ConnectRace(): next(0), nextAttemptTime(0), handler(-1), winner(0), winnerSource(-1), error(0), done(false) {}
+};
 
-    int localPort = getLocalPort(new_handler);
 
-    Socket* acceptSocket = new Socket();
-    acceptSocket->_socketHandler = new_handler;
-    acceptSocket->_hostTo = hostChar;
-    acceptSocket->_portTo = getInPort((struct sockaddr *)&incoming_addr);
-    acceptSocket->_portFrom = localPort;
+static void closeAttempts(ConnectRace& race) {
 
-    acceptSocket->_protocol = _protocol;
-    acceptSocket->_ipVer = _ipVer;
-    acceptSocket->_type = CLIENT;
-    acceptSocket->_listenQueue = 0;
-    acceptSocket->blocking(_blocking);
+    for(unsigned i=0; i < race.attempts.size(); ++i)
+        close(race.attempts[i].handler);
 
-    return acceptSocket;
+    race.attempts.clear();
 }
 
 
-/**
-* Sends data to an expecific host:port
-*
-* Sends the data contained in buffer to a given host:port. Requires the socket to be an UDP socket,
-* throws an exception otherwise.
-*
-* @pre Socket must be UDP
-* @param buffer A pointer to the data we want to send
-* @param size Size of the data to send (bytes)
-* @param hostTo Target/remote host
-* @param portTo Target/remote port
-* @throw Exception EXPECTED_UDP_SOCKET, BAD_IP_VER, ERROR_SET_ADDR_INFO*, ERROR_SEND*
-*/
+static void winRace(ConnectRace& race, size_t attempt) {
 
+    race.handler = race.attempts[attempt].handler;
+    race.winner = race.attempts[attempt].address;
+    race.winnerSource = race.attempts[attempt].source;
 
-void Socket::sendTo(const void* buffer, size_t size, const string& hostTo, unsigned portTo) {
+    race.attempts.erase(race.attempts.begin() + attempt);
+    closeAttempts(race);
 
-    if(_protocol != UDP)
-        throw Exception(Exception::EXPECTED_UDP_SOCKET, "Socket::sendTo: non-UDP socket can not 'sendTo'");
+    race.done = true;
+}
 
-    struct addrinfo conf, *res;
-    memset(&conf, 0, sizeof(conf));
 
-    conf.ai_socktype = SOCK_DGRAM;
+static void loseRace(ConnectRace& race, int error) {
 
-    switch(_ipVer) {
+    closeAttempts(race);
 
-        case IP4:
-            conf.ai_family = AF_INET;
-            break;
+    race.error = error;
+    race.done = true;
+}
 
-        case IP6:
-            conf.ai_family = AF_INET6;
-            break;
 
-        default:
-            throw Exception(Exception::BAD_IP_VER, "Socket::sendTo: bad ip version.");
-    }
+/*
+* Resolves the local addresses the connections of options must be made from. Stays empty
+* when neither a local address nor a local port are given.
+*/
 
-    char portStr[10];
-    snprintf(portStr, 10, "%u", portTo);
+static void resolveSources(const ConnectOptions& options, vector<Address>& sources) {
 
-    int status = getaddrinfo(hostTo.c_str(), portStr, &conf, &res);
+    sources.clear();
 
-    ReleaseManager<struct addrinfo> addrInfoReleaser(freeaddrinfo);
-    addrInfoReleaser.add(&res);
+    if(options.hostsFrom.empty()) {
 
+        if(options.portFrom)
+            Resolver::resolve("", options.portFrom, TCP, ANY, true, sources);
 
-    if(status != 0) {
-        string errorMsg = "Socket::sendTo: error setting addrInfo: ";
-		#ifndef _MSC_VER
-			errorMsg += gai_strerror(status);
-		#endif
-		throw Exception(Exception::ERROR_SET_ADDR_INFO, "Socket::sendTo: error setting addr info", getSocketErrorCode());
+        return;
     }
 
-    size_t sentBytes = 0;
-
-    while(sentBytes < size) {
-
-        int status = ::sendto(_socketHandler, (const char*)buffer + sentBytes, size - sentBytes, 0, res->ai_addr, res->ai_addrlen);
+    vector<Address> addresses;
 
-        if(status == -1)
-            throw Exception(Exception::ERROR_SEND, "Socket::sendTo: could not send the data", getSocketErrorCode());
-
-        sentBytes += status;
+    for(unsigned i=0; i < options.hostsFrom.size(); ++i) {
+        Resolver::resolve(options.hostsFrom[i], options.portFrom, TCP, ANY, true, addresses);
+        sources.insert(sources.end(), addresses.begin(), addresses.end());
     }
 }
 
 
+/*
+* Shared by all the connections of the process, so consecutive connections (from the same
+* or from different calls) spread over the source addresses.
+*/
 
+static std::atomic<unsigned> nextSource(0);
 
-/**
-* Receive data and get the source host and port
+
+/*
+* Binds the socket to the next source address of its family. When the local port is left
+* to the OS, IP_BIND_ADDRESS_NO_PORT delays the port choice to connect(), where the kernel
+* can reuse a port for different destinations instead of reserving it at bind(). Without
+* it each source address runs out of ports after the ephemeral range (~28K connections).
 *
-* Requires the socket to be UDP. Source host address and port are returned in hostFrom and
-* portFrom parameters. Data recieved is written in buffer address up to bufferSize.
+* Returns 0 or the native error code.
+*/
+
+static int bindSource(int socketHandler, int family, const vector<Address>& sources, unsigned portFrom, int* source) {
+
+    unsigned start = nextSource.fetch_add(1, std::memory_order_relaxed);
+
+    for(unsigned i=0; i < sources.size(); ++i) {
+
+        unsigned index = (start + i) % sources.size();
+
+        if(sources[index].family != family)
+            continue;
+
+        int yes = 1;
+
+        if(portFrom)
+            setsockopt(socketHandler, SOL_SOCKET, SO_REUSEADDR, (char*)&yes, sizeof(yes));
+
+        #ifdef IP_BIND_ADDRESS_NO_PORT
+        else
+            // best effort: kernels older than 4.2 refuse it, and bind() reserves the port as usual
+            setsockopt(socketHandler, IPPROTO_IP, IP_BIND_ADDRESS_NO_PORT, &yes, sizeof(yes));
+        #endif
+
+        if(bind(socketHandler, sources[index].addr(), sources[index].length) == -1)
+            return getSocketErrorCode();
+
+        *source = index;
+        return 0;
+    }
+
+    return NO_SOURCE_ADDRESS;
+}
+
+
+static void startAttempt(ConnectRace& race, unsigned long long now, const ConnectOptions& options,
+                            const vector<Address>& sources) {
+
+    ConnectAttempt attempt;
+    attempt.address = race.next++;
+    attempt.source = -1;
+
+    const Address& address = race.addresses[attempt.address];
+
+    race.nextAttemptTime = now + options.attemptDelay;
+
+    attempt.handler = socket(address.family, address.sockType, address.protocol);
+
+    if(attempt.handler == -1) {
+        race.error = getSocketErrorCode();
+        race.nextAttemptTime = now;
+        return;
+    }
+
+    if(setHandlerBlocking(attempt.handler, false) == -1) {
+        race.error = getSocketErrorCode();
+        race.nextAttemptTime = now;
+        close(attempt.handler);
+        return;
+    }
+
+    if(!sources.empty()) {
+
+        int error = bindSource(attempt.handler, address.family, sources, options.portFrom, &attempt.source);
+
+        if(error) {
+            race.error = error;
+            race.nextAttemptTime = now;
+            close(attempt.handler);
+            return;
+        }
+    }
+
+    if(connect(attempt.handler, address.addr(), address.length) == 0) {
+        race.attempts.push_back(attempt);
+        winRace(race, race.attempts.size() - 1);
+        return;
+    }
+
+    if(!connectInProgress()) {
+        race.error = getSocketErrorCode();
+        race.nextAttemptTime = now;
+        close(attempt.handler);
+        return;
+    }
+
+    race.attempts.push_back(attempt);
+}
+
+
+static void runConnectRaces(vector<ConnectRace>& races, const ConnectOptions& options,
+                            const vector<Address>& sources) {
+
+    unsigned timeout = options.timeout;
+    unsigned long long deadline = getMonotonicTime() + timeout;
+
+    vector<struct pollfd> fds;
+    vector<ConnectRace*> fdRaces;
+
+    while(true) {
+
+        unsigned long long now = getMonotonicTime();
+        unsigned long long nextAttemptTime = 0;
+        bool racing = false;
+
+        for(unsigned i=0; i < races.size(); ++i) {
+
+            ConnectRace& race = races[i];
+
+            while(!race.done && race.next < race.addresses.size()
+                    && (race.attempts.empty() || now >= race.nextAttemptTime))
+                startAttempt(race, now, options, sources);
+
+            if(race.done)
+                continue;
+
+            if(race.attempts.empty()) {
+                loseRace(race, race.error);
+                continue;
+            }
+
+            racing = true;
+
+            if(race.next < race.addresses.size() && (!nextAttemptTime || race.nextAttemptTime < nextAttemptTime))
+                nextAttemptTime = race.nextAttemptTime;
+        }
+
+        if(!racing)
+            return;
+
+        if(timeout && now >= deadline) {
+
+            for(unsigned i=0; i < races.size(); ++i)
+                if(!races[i].done)
+                    loseRace(races[i], CONNECT_TIMED_OUT);
+
+            return;
+        }
+
+        int wait = -1;
+
+        if(timeout)
+            wait = (int)std::min(deadline - now, 0x7FFFFFFFULL);
+
+        if(nextAttemptTime) {
+            int untilNextAttempt = nextAttemptTime > now ? (int)std::min(nextAttemptTime - now, 0x7FFFFFFFULL) : 0;
+            if(wait == -1 || untilNextAttempt < wait)
+                wait = untilNextAttempt;
+        }
+
+        fds.clear();
+        fdRaces.clear();
+
+        for(unsigned i=0; i < races.size(); ++i)
+            for(unsigned j=0; !races[i].done && j < races[i].attempts.size(); ++j) {
+
+                struct pollfd fd;
+                fd.fd = races[i].attempts[j].handler;
+                fd.events = POLLOUT;
+                fd.revents = 0;
+
+                fds.push_back(fd);
+                fdRaces.push_back(&races[i]);
+            }
+
+        int status = poll(&fds[0], fds.size(), wait);
+
+        if(status == -1) {
+
+            if(pollInterrupted())
+                continue;
+
+            int error = getSocketErrorCode();
+
+            // the races already won too, as the caller does not get to own their handlers
+            for(unsigned i=0; i < races.size(); ++i) {
+
+                if(!races[i].done)
+                    loseRace(races[i], error);
+
+                else if(races[i].handler != -1) {
+                    close(races[i].handler);
+                    races[i].handler = -1;
+                }
+            }
+
+            throw Exception(Exception::ERROR_SELECT, "Socket::(static)runConnectRaces: could not poll the connecting sockets", error);
+        }
+
+        // backwards, so finished attempts can be erased without moving the pending ones
+        for(size_t i = fds.size(); status > 0 && i-- > 0;) {
+
+            if(!fds[i].revents)
+                continue;
+
+            status--;
+
+            ConnectRace& race = *fdRaces[i];
+
+            if(race.done)
+                continue;
+
+            size_t attempt = 0;
+            while(race.attempts[attempt].handler != fds[i].fd)
+                attempt++;
+
+            int error = getConnectError(fds[i].fd);
+
+            if(!error)
+                winRace(race, attempt);
+
+            else {
+                close(fds[i].fd);
+                race.attempts.erase(race.attempts.begin() + attempt);
+
+                race.error = error;
+                race.nextAttemptTime = getMonotonicTime(); // the next address does not need to wait
+            }
+        }
+    }
+}
+
+
+void Socket::initSocket(const ConnectOptions& options) {
+
+    vector<Address> addresses;
+
+    if(_type == CLIENT && _protocol == TCP) {
+
+        Resolver::resolve(_host, _portTo, protocol(), ipVer(), false, addresses);
+        connectSocket(addresses, options);
+        return;
+    }
+
+    Resolver::resolve(_type == SERVER ? _host : "", _portFrom, protocol(), ipVer(), true, addresses);
+
+    bool connected = false;
+
+    for(unsigned i=0; !connected && i < addresses.size(); ++i) {
+
+        const Address* res = &addresses[i];
+
+        _socketHandler = socket(res->family, res->sockType, res->protocol);
+
+        if(_socketHandler != -1)
+
+            switch(_type) {
+
+                case CLIENT: {
+                    int status = bind(_socketHandler, res->addr(), res->length);
+                    NL_PROBE3(bind, _socketHandler, _portFrom, status);
+
+                    if (status == -1)
+                        close(_socketHandler);
+                    else
+                        connected = true;
+
+                    break;
+                }
+
+                case SERVER:
+                    #ifdef OS_WIN32
+                        char yes = 1;
+                    #else
+                        int yes = 1;
+                    #endif
+
+                    if (setsockopt(_socketHandler, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(int)) == -1)
+                        throw Exception(Exception::ERROR_SET_SOCK_OPT, "Socket::initSocket: Error establishing socket options");
+
+                    int status = bind(_socketHandler, res->addr(), res->length);
+                    NL_PROBE3(bind, _socketHandler, _portFrom, status);
+
+                    if (status == -1)
+                        close(_socketHandler);
+                    else
+                        connected = true;
+
+                    if (_protocol == TCP && listen(_socketHandler, _listenQueue) == -1)
+                        throw Exception(Exception::ERROR_CAN_NOT_LISTEN, "Socket::initSocket: could not start listening", getSocketErrorCode());
+
+                    break;
+
+            }
+
+    if(connected && _ipVer == ANY)
+        switch(res->family) {
+            case AF_INET:
+                _ipVer = IP4;
+                break;
+
+            case AF_INET6:
+                _ipVer = IP6;
+                break;
+        }
+
+    }
+
+    if(!connected)
+        throw Exception(Exception::ERROR_CONNECT_SOCKET, "Socket::initSocket: error in socket connection/bind", getSocketErrorCode());
+
+    if(_type == CLIENT) {
+
+        Address peer;
+
+        try {
+            connectDatagram(_host, _portTo, peer);
+        }
+        catch(...) {
+            disconnect();
+            throw;
+        }
+    }
+
+    if(!_portFrom)
+        _portFrom = getLocalPort(_socketHandler);
+}
+
+
+/*
+* Connects the UDP socket to hostTo:portTo, so the kernel only takes datagrams from there
+* and plain send() and recv() can be used. The resolved address is left in address.
+*/
+
+void Socket::connectDatagram(const string& hostTo, unsigned portTo, Address& address) {
+
+    Resolver::resolveFirst(hostTo, portTo, UDP, ipVer(), address);
+
+    int status = ::connect(_socketHandler, address.addr(), address.length);
+    NL_PROBE3(connect, _socketHandler, portTo, status);
+    FlightRecorder::record(TRACE_CONNECT, _socketHandler, status, status == -1 ? getSocketErrorCode() : 0);
+
+    if(status == -1)
+        throw Exception(Exception::ERROR_CONNECT_SOCKET, "Socket::connectTo: could not connect the socket", getSocketErrorCode());
+}
+
+/*
+* Connects the TCP CLIENT socket to the first address that accepts the connection,
+* racing the addresses as configured in options.
+*/
+
+void Socket::connectSocket(vector<Address>& addresses, const ConnectOptions& options) {
+
+    interleaveFamilies(addresses);
+
+    vector<Address> sources;
+    resolveSources(options, sources);
+
+    vector<ConnectRace> races(1);
+    ConnectRace& race = races[0];
+    race.addresses.swap(addresses);
+
+    unsigned long long start = latencyStart();
+    runConnectRaces(races, options, sources);
+    latencyEnd(LATENCY_CONNECT, start);
+    NL_PROBE3(connect, race.handler, _portTo, race.handler == -1 ? -1 : 0);
+    FlightRecorder::record(TRACE_CONNECT, race.handler, race.handler == -1 ? -1 : 0, race.handler == -1 ? race.error : 0);
+
+    if(race.handler == -1) {
+
+        if(race.error == CONNECT_TIMED_OUT)
+            throw Exception(Exception::ERROR_CONNECT_SOCKET, "Socket::initSocket: connection timed out", race.error);
+
+        throw Exception(Exception::ERROR_CONNECT_SOCKET, "Socket::initSocket: error in socket connection/bind", race.error);
+    }
+
+    _socketHandler = race.handler;
+
+    if(setHandlerBlocking(_socketHandler, _blocking) == -1) {
+
+        int error = getSocketErrorCode();
+        disconnect();
+        throw Exception(Exception::ERROR_IOCTL, "Socket::initSocket: ioctl error", error);
+    }
+
+    if(_ipVer == ANY)
+        _ipVer = race.addresses[race.winner].family == AF_INET6 ? IP6 : IP4;
+
+    if(race.winnerSource != -1)
+        address(sources[race.winnerSource].addr(), false);
+
+    _portFrom = getLocalPort(_socketHandler);
+}
+
+
+/**
+* ConnectOptions constructor
+*
+* Sets the defaults: no timeout other than the OS one, DEFAULT_CONNECTION_ATTEMPT_DELAY
+* milisecs between connection attempts, and the local address and port choosen by the OS.
+*/
+
+ConnectOptions::ConnectOptions(): timeout(0), attemptDelay(DEFAULT_CONNECTION_ATTEMPT_DELAY), portFrom(0) {}
+
+
+/**
+* FrameFormat constructor
+*
+* Sets the defaults: a DEFAULT_FRAME_PREFIX_SIZE bytes big endian prefix, and frames of up
+* to DEFAULT_MAX_FRAME_SIZE bytes.
+*/
+
+FrameFormat::FrameFormat(): prefixSize(DEFAULT_FRAME_PREFIX_SIZE), littleEndian(false), maxSize(DEFAULT_MAX_FRAME_SIZE) {}
+
+
+/**
+* Writes the length prefix of a frame
+*
+* @param size The size of the frame
+* @param[out] prefix Where to write the prefixSize bytes of the prefix
+*/
+
+void FrameFormat::prefix(size_t size, unsigned char* prefix) const {
+
+    for(unsigned i = 0; i < prefixSize; i++) {
+
+        unsigned shift = 8 * (littleEndian ? i : prefixSize - 1 - i);
+        prefix[i] = (unsigned char)(size >> shift);
+    }
+}
+
+
+/**
+* Reads the length prefix of a frame
+*
+* @param prefix The prefixSize bytes of the prefix
+* @return The size of the frame
+*/
+
+size_t FrameFormat::frameSize(const unsigned char* prefix) const {
+
+    size_t size = 0;
+
+    for(unsigned i = 0; i < prefixSize; i++) {
+
+        unsigned shift = 8 * (littleEndian ? i : prefixSize - 1 - i);
+        size |= (size_t)prefix[i] << shift;
+    }
+
+    return size;
+}
+
+
+/**
+* ConnectTarget constructor
+*
+* @param hostTo the target/remote host
+* @param portTo the target/remote port
+* @param ipVer the IP version to be used (IP4, IP6 or ANY). ANY by default.
+*/
+
+ConnectTarget::ConnectTarget(const string& hostTo, unsigned portTo, IPVer ipVer):
+                hostTo(hostTo), portTo(portTo), ipVer(ipVer) {}
+
+
+/**
+* ConnectResult constructor
+*/
+
+ConnectResult::ConnectResult(): socket(NULL), error(Exception::ERROR_CONNECT_SOCKET, "") {}
+
+
+/**
+* SocketStats constructor, all the counters at 0
+*/
+
+SocketStats::SocketStats(): bytesSent(0), bytesReceived(0), messagesSent(0), messagesReceived(0), syscalls(0),
+                            wouldBlock(0), partialSends(0), accepts(0), errors(0), drops(0) {}
+
+
+/*
+* The counters of every socket of the process. Sockets of any thread add to them, relaxed as
+* they are only summed up and never order anything else.
+*/
+
+static struct {
+
+    std::atomic<unsigned long long> bytesSent;
+    std::atomic<unsigned long long> bytesReceived;
+    std::atomic<unsigned long long> messagesSent;
+    std::atomic<unsigned long long> messagesReceived;
+    std::atomic<unsigned long long> syscalls;
+    std::atomic<unsigned long long> wouldBlock;
+    std::atomic<unsigned long long> partialSends;
+    std::atomic<unsigned long long> accepts;
+    std::atomic<unsigned long long> errors;
+    std::atomic<unsigned long long> drops;
+
+} allStats;
+
+
+static void add(unsigned long long& counter, std::atomic<unsigned long long>& total, unsigned long long value) {
+
+    counter += value;
+    total.fetch_add(value, std::memory_order_relaxed);
+}
+
+
+/*
+* Counts a call to the OS that failed, from the error code it left
+*/
+
+static void countFailure(SocketStats& stats) {
+
+    if(wouldBlock())
+        add(stats.wouldBlock, allStats.wouldBlock, 1);
+    else
+        add(stats.errors, allStats.errors, 1);
+}
+
+
+/**
+* Returns the counters of the I/O of all the sockets of the process
+*
+* Those disconnected or destroyed included.
+*
+* @return the counters since the process started
+*/
+
+SocketStats Socket::processStats() {
+
+    SocketStats stats;
+    stats.bytesSent = allStats.bytesSent.load(std::memory_order_relaxed);
+    stats.bytesReceived = allStats.bytesReceived.load(std::memory_order_relaxed);
+    stats.messagesSent = allStats.messagesSent.load(std::memory_order_relaxed);
+    stats.messagesReceived = allStats.messagesReceived.load(std::memory_order_relaxed);
+    stats.syscalls = allStats.syscalls.load(std::memory_order_relaxed);
+    stats.wouldBlock = allStats.wouldBlock.load(std::memory_order_relaxed);
+    stats.partialSends = allStats.partialSends.load(std::memory_order_relaxed);
+    stats.accepts = allStats.accepts.load(std::memory_order_relaxed);
+    stats.errors = allStats.errors.load(std::memory_order_relaxed);
+    stats.drops = allStats.drops.load(std::memory_order_relaxed);
+
+    return stats;
+}
+
+
+/*
+* The latencies of the blocking calls of every socket of the process
+*/
+
+static LatencyHistogram allLatency[LATENCY_OPS];
+
+
+/**
+* Returns the latencies of a blocking operation of all the sockets of the process
+*
+* Recorded for every socket, whether its latencyTracking() is enabled or not.
+*
+* @param op the operation
+* @return the histogram of its durations
+*/
+
+const LatencyHistogram& Socket::processLatency(LatencyOp op) {
+
+    return allLatency[op];
+}
+
+
+/**
+* Removes the latencies recorded for all the sockets of the process
+*
+* Those of the sockets with latencyTracking() enabled are kept.
+*/
+
+void Socket::resetProcessLatency() {
+
+    for(unsigned op = 0; op < LATENCY_OPS; ++op)
+        allLatency[op].reset();
+}
+
+
+/*
+* Returns when a call to the OS that may block starts, 0 for non-blocking sockets, whose calls
+* can not take long and are not measured
+*/
+
+unsigned long long Socket::latencyStart() const {
+
+    return _blocking ? LatencyHistogram::now() : 0;
+}
+
+
+/*
+* Records the duration of a call to the OS started at start, from latencyStart()
+*/
+
+void Socket::latencyEnd(LatencyOp op, unsigned long long start) {
+
+    if(!start)
+        return;
+
+    unsigned long long duration = LatencyHistogram::now() - start;
+
+    allLatency[op].record(duration);
+
+    if(_latency)
+        _latency[op].record(duration);
+}
+
+
+/*
+* Counts a call to the OS that received data: status is what it returned, and messages the
+* datagrams received when it was not -1. It is also recorded in the FlightRecorder. Must run
+* before anything else changes the error code.
+*/
+
+void Socket::countRead(long status, unsigned messages) {
+
+    FlightRecorder::record(TRACE_READ, _socketHandler, status, status == -1 ? getSocketErrorCode() : 0);
+    add(_stats.syscalls, allStats.syscalls, 1);
+
+    if(status == -1)
+        countFailure(_stats);
+
+    else if(status > 0 || _protocol == UDP) {
+        add(_stats.bytesReceived, allStats.bytesReceived, status);
+        add(_stats.messagesReceived, allStats.messagesReceived, messages);
+    }
+}
+
+
+/*
+* Counts a call to the OS that sent size bytes, like countRead()
+*/
+
+void Socket::countSend(long status, size_t size, unsigned messages) {
+
+    FlightRecorder::record(TRACE_SEND, _socketHandler, status, status == -1 ? getSocketErrorCode() : 0);
+    add(_stats.syscalls, allStats.syscalls, 1);
+
+    if(status == -1) {
+        countFailure(_stats);
+        return;
+    }
+
+    add(_stats.bytesSent, allStats.bytesSent, status);
+    add(_stats.messagesSent, allStats.messagesSent, messages);
+
+    if((size_t)status < size)
+        add(_stats.partialSends, allStats.partialSends, 1);
+}
+
+
+/*
+* Counts a call to accept(), which returned socketHandler
+*/
+
+void Socket::countAccept(int socketHandler) {
+
+    FlightRecorder::record(TRACE_ACCEPT, _socketHandler, socketHandler, socketHandler == -1 ? getSocketErrorCode() : 0);
+    add(_stats.syscalls, allStats.syscalls, 1);
+
+    if(socketHandler != -1)
+        add(_stats.accepts, allStats.accepts, 1);
+    else
+        countFailure(_stats);
+}
+
+
+/*
+* Counts the packets dropped for the socket, from the running count of the OS read with a
+* message. Only what it grew by since the last one is added to those of the process.
+*/
+
+void Socket::countDrops(unsigned long long drops) {
+
+    if(drops > _stats.drops)
+        add(_stats.drops, allStats.drops, drops - _stats.drops);
+}
+
+
+/**
+* CLIENT Socket constructor
+*
+* Creates a socket, connect it (if TCP) and sets it ready to send to hostTo:portTo.
+* The local port of the socket is choosen by OS.
+*
+* @param hostTo the target/remote host
+* @param portTo the target/remote port
+* @param protocol the protocol to be used (TCP or UDP). TCP by default.
+* @param ipVer the IP version to be used (IP4, IP6 or ANY). ANY by default.
+* @throw Exception BAD_PROTOCOL, BAD_IP_VER, ERROR_SET_ADDR_INFO*, ERROR_CONNECT_SOCKET*,
+*  ERROR_GET_ADDR_INFO*
+*/
+
+
+Socket::Socket(const string& hostTo, unsigned portTo, Protocol protocol, IPVer ipVer) :
+                _host(hostTo), _portTo(portTo), _portFrom(0), _listenQueue(0), _protocol(protocol),
+                _ipVer(ipVer), _type(CLIENT), _blocking(true), _hasAddressTo(false), _hasAddressFrom(false), _local(false), _ownsPath(false), _zeroCopy(false), _latency(NULL)
+{
+    initSocket();
+}
+
+
+/**
+* TCP CLIENT Socket constructor with connection options
+*
+* Creates a socket and connects it to hostTo:portTo. When the host resolves to several
+* addresses they are raced as RFC 8305 (Happy Eyeballs) describes, alternating IPv6 and
+* IPv4, and the first one to accept the connection is kept.
+*
+* @param hostTo the target/remote host
+* @param portTo the target/remote port
+* @param options the connection timeout, the delay between connection attempts and the
+*   local addresses and port to connect from
+* @param ipVer the IP version to be used (IP4, IP6 or ANY). ANY by default.
+* @throw Exception BAD_IP_VER, ERROR_SET_ADDR_INFO*, ERROR_CONNECT_SOCKET*, ERROR_SELECT*,
+*  ERROR_IOCTL*, ERROR_GET_ADDR_INFO*
+*/
+
+Socket::Socket(const string& hostTo, unsigned portTo, const ConnectOptions& options, IPVer ipVer) :
+                _host(hostTo), _portTo(portTo), _portFrom(0), _listenQueue(0), _protocol(TCP),
+                _ipVer(ipVer), _type(CLIENT), _blocking(true), _hasAddressTo(false), _hasAddressFrom(false), _local(false), _ownsPath(false), _zeroCopy(false), _latency(NULL)
+{
+    initSocket(options);
+}
+
+
+/**
+* SERVER Socket constructor
+*
+* Creates a socket, binds it to portFrom port and listens for connections (if TCP).
+*
+* @param portFrom the local port the socket will be bound to
+* @param protocol the protocol to be used (TCP or UDP). TCP by default.
+* @param ipVer the IP version to be used (IP4, IP6 or ANY). IP4 by default.
+* @param hostFrom the local address to be binded to (example: "localhost" or "127.0.0.1"). Empty (by default) or "*" means all avariable addresses.
+* @param listenQueue the size of the internal buffer of the SERVER TCP socket where the connection requests are stored until accepted
+* @throw Exception BAD_PROTOCOL, BAD_IP_VER, ERROR_SET_ADDR_INFO*, ERROR_SET_SOCK_OPT*,
+*  ERROR_CAN_NOT_LISTEN*, ERROR_CONNECT_SOCKET*
+*/
+
+Socket::Socket(unsigned portFrom, Protocol protocol, IPVer ipVer, const string& hostFrom, unsigned listenQueue):
+                _host(hostFrom), _portTo(0), _portFrom(portFrom),
+                _listenQueue(listenQueue < MAX_LISTEN_QUEUE ? listenQueue : MAX_LISTEN_QUEUE), _protocol(protocol),
+                _ipVer(ipVer), _type(SERVER), _blocking(true), _hasAddressTo(false), _hasAddressFrom(false), _local(false), _ownsPath(false), _zeroCopy(false), _latency(NULL)
+{
+    initSocket();
+}
+
+/**
+* UDP CLIENT Socket Constructor
+*
+* This client constructor for UDP Sockets allows to expecify the local port the socket
+* will be bound to. It sets the socket ready to send data to hostTo:portTo, connecting it
+* so datagrams from any other source are dropped by the OS.
+*
+* @param hostTo the target/remote host
+* @param portTo the target/remote port
+* @param portFrom the local port the socket will be bound to
+* @param ipVer the IP version to be used (IP4, IP6 or ANY). ANY by default.
+* @throw Exception BAD_PROTOCOL, BAD_IP_VER, ERROR_SET_ADDR_INFO*, ERROR_SET_SOCK_OPT*,
+*  ERROR_CAN_NOT_LISTEN*, ERROR_CONNECT_SOCKET*
+*/
+
+Socket::Socket(const string& hostTo, unsigned portTo, unsigned portFrom, IPVer ipVer):
+                _host(hostTo), _portTo(portTo), _portFrom(portFrom), _listenQueue(0), _protocol(UDP),
+                _ipVer(ipVer), _type(CLIENT), _blocking(true), _hasAddressTo(false), _hasAddressFrom(false), _local(false), _ownsPath(false), _zeroCopy(false), _latency(NULL)
+{
+
+    initSocket();
+}
+
+
+Socket::Socket() : _socketHandler(-1), _portTo(0), _portFrom(0), _listenQueue(0), _protocol(TCP),
+                _ipVer(ANY), _type(CLIENT), _blocking(true), _hasAddressTo(false), _hasAddressFrom(false), _local(false), _ownsPath(false), _zeroCopy(false), _latency(NULL) {};
+
+
+/**
+* Socket move constructor
+*
+* Takes over the connection of socket, which is left disconnected.
+*
+* @param socket the socket to move from
+*/
+
+Socket::Socket(Socket&& socket) :
+                _host(std::move(socket._host)), _socketHandler(socket._socketHandler),
+                _portTo(socket._portTo), _portFrom(socket._portFrom), _listenQueue(socket._listenQueue),
+                _protocol(socket._protocol), _ipVer(socket._ipVer), _type(socket._type),
+                _blocking(socket._blocking), _hasAddressTo(socket._hasAddressTo),
+                _hasAddressFrom(socket._hasAddressFrom), _local(socket._local), _ownsPath(socket._ownsPath), _zeroCopy(socket._zeroCopy),
+                _stats(socket._stats), _latency(socket._latency)
+{
+    memcpy(_address, socket._address, sizeof(_address));
+    socket._socketHandler = -1;
+    socket._latency = NULL;
+}
+
+
+/**
+* Socket Destructor
+*
+* Closes (disconnects) the socket
+*/
+
+Socket::~Socket() {
+
+    if(_socketHandler != -1) {
+        close(_socketHandler);
+        removePath();
+    }
+
+    delete[] _latency;
+}
+
+
+// get sockaddr, IPv4 or IPv6:
+// This function is from Brian “Beej Jorgensen” Hall: Beej's Guide to Network Programming.
+static void *get_in_addr(struct sockaddr *sa)
+{
+    if (sa->sa_family == AF_INET) {
+        return &(((struct sockaddr_in*)sa)->sin_addr);
+    }
+    return &(((struct sockaddr_in6*)sa)->sin6_addr);
+}
+
+
+static string getInHost(struct sockaddr* sa) {
+
+    char hostChar[INET6_ADDRSTRLEN];
+    inet_ntop(sa->sa_family, get_in_addr(sa), hostChar, sizeof hostChar);
+
+    return hostChar;
+}
+
+
+/**
+* AF_UNIX CLIENT Socket factory
+*
+* Creates a Unix domain socket connected to the one bound to pathTo, which skips the
+* network stack for processes on the same host. A UDP socket is a datagram one and
+* can only send to (and receive from) pathTo.
+*
+* @param pathTo the path of the SERVER socket, or a name in the (Linux) abstract namespace
+*   starting with '@'
+* @param protocol TCP for a stream socket, UDP for a datagram one. TCP by default.
+* @return the connected socket, owned by the caller
+* @throw Exception OUT_OF_RANGE, ERROR_CONNECT_SOCKET*
+*/
+
+Socket* Socket::unixClient(const string& pathTo, Protocol protocol) {
+
+    struct sockaddr_un addr;
+    socklen_t length = unixAddress(pathTo, &addr);
+
+    int handler = socket(AF_UNIX, protocol == TCP ? SOCK_STREAM : SOCK_DGRAM, 0);
+
+    if(handler == -1)
+        throw Exception(Exception::ERROR_CONNECT_SOCKET, "Socket::unixClient: could not create the socket", getSocketErrorCode());
+
+    if(connect(handler, (struct sockaddr*)&addr, length) == -1) {
+        int error = getSocketErrorCode();
+        close(handler);
+        throw Exception(Exception::ERROR_CONNECT_SOCKET, "Socket::unixClient: could not connect", error);
+    }
+
+    return unixSocket(handler, pathTo, protocol, CLIENT);
+}
+
+
+/**
+* AF_UNIX SERVER Socket factory
+*
+* Creates a Unix domain socket bound to pathFrom, listening for connections if TCP. The
+* file of the path is removed when the socket is disconnected.
+*
+* @param pathFrom the path to bind to, or a name in the (Linux) abstract namespace starting
+*   with '@'. Empty lets Linux choose an abstract name, and leaves the socket unbound elsewhere.
+* @param protocol TCP for a stream socket, UDP for a datagram one. TCP by default.
+* @param listenQueue the size of the queue of connection requests of TCP sockets
+* @return the bound socket, owned by the caller
+* @throw Exception OUT_OF_RANGE, ERROR_CONNECT_SOCKET*, ERROR_CAN_NOT_LISTEN*, ERROR_GET_ADDR_INFO*
+*/
+
+Socket* Socket::unixServer(const string& pathFrom, Protocol protocol, unsigned listenQueue) {
+
+    struct sockaddr_un addr;
+    socklen_t length = unixAddress(pathFrom, &addr);
+
+    int handler = socket(AF_UNIX, protocol == TCP ? SOCK_STREAM : SOCK_DGRAM, 0);
+
+    if(handler == -1)
+        throw Exception(Exception::ERROR_CONNECT_SOCKET, "Socket::unixServer: could not create the socket", getSocketErrorCode());
+
+    string path = pathFrom;
+    bool named = !path.empty();
+
+    #ifdef __linux__
+        // a bare address family makes Linux choose an unused abstract name
+        if(!named) {
+            length = sizeof(sa_family_t);
+            named = true;
+        }
+    #endif
+
+    if(named && bind(handler, (struct sockaddr*)&addr, length) == -1) {
+        int error = getSocketErrorCode();
+        close(handler);
+        throw Exception(Exception::ERROR_CONNECT_SOCKET, "Socket::unixServer: could not bind", error);
+    }
+
+    if(listenQueue > MAX_LISTEN_QUEUE)
+        listenQueue = MAX_LISTEN_QUEUE;
+
+    if(protocol == TCP && listen(handler, listenQueue) == -1) {
+        int error = getSocketErrorCode();
+        close(handler);
+        throw Exception(Exception::ERROR_CAN_NOT_LISTEN, "Socket::unixServer: could not start listening", error);
+    }
+
+    if(path.empty()) {
+
+        socklen_t size = sizeof(addr);
+
+        if(getsockname(handler, (struct sockaddr*)&addr, &size) == -1) {
+            int error = getSocketErrorCode();
+            close(handler);
+            throw Exception(Exception::ERROR_GET_ADDR_INFO, "Socket::unixServer: error getting socket info", error);
+        }
+
+        path = unixPath(&addr, size);
+    }
+
+    Socket* socket = unixSocket(handler, path, protocol, SERVER);
+    socket->_listenQueue = protocol == TCP ? listenQueue : 0;
+    socket->_ownsPath = named && !path.empty() && path[0] != '@';
+
+    return socket;
+}
+
+
+/**
+* Creates a pair of connected AF_UNIX CLIENT sockets
+*
+* What one of them sends the other one receives. Useful to talk to a child process, or
+* between threads.
+*
+* @param[out] first Here the function will store one of the sockets, owned by the caller
+* @param[out] second Here the function will store the other socket, owned by the caller
+* @param protocol TCP for stream sockets, UDP for datagram ones. TCP by default.
+* @throw Exception ERROR_CONNECT_SOCKET* (always on Windows, which lacks socketpair())
+*/
+
+void Socket::unixPair(Socket** first, Socket** second, Protocol protocol) {
+
+    #ifdef OS_WIN32
+        throw Exception(Exception::ERROR_CONNECT_SOCKET, "Socket::unixPair: socket pairs are not supported on Windows");
+    #else
+        int handlers[2];
+
+        if(socketpair(AF_UNIX, protocol == TCP ? SOCK_STREAM : SOCK_DGRAM, 0, handlers) == -1)
+            throw Exception(Exception::ERROR_CONNECT_SOCKET, "Socket::unixPair: could not create the sockets", getSocketErrorCode());
+
+        *first = unixSocket(handlers[0], "", protocol, CLIENT);
+        *second = unixSocket(handlers[1], "", protocol, CLIENT);
+    #endif
+}
+
+
+/**
+* Adopts a socket handler created elsewhere, such as one received with receiveFd()
+*
+* The kind of socket (protocol, type, addresses and ports) is found out from the handler.
+* Sockets that are connected are CLIENT ones, the rest SERVER ones. The Socket owns the
+* handler from then on, but the file of an AF_UNIX SERVER socket is left in place.
+*
+* @param socketHandler the socket handler (file/socket descriptor)
+* @return the socket, owned by the caller
+* @throw Exception ERROR_GET_ADDR_INFO* (not a socket), BAD_PROTOCOL (neither stream nor datagram)
+*/
+
+Socket* Socket::fromHandler(int socketHandler) {
+
+    struct sockaddr_storage local;
+    socklen_t localSize = sizeof(local);
+
+    if(getsockname(socketHandler, (struct sockaddr*)&local, &localSize) == -1)
+        throw Exception(Exception::ERROR_GET_ADDR_INFO, "Socket::fromHandler: not a socket", getSocketErrorCode());
+
+    int sockType = 0;
+    socklen_t optionSize = sizeof(sockType);
+
+    if(getsockopt(socketHandler, SOL_SOCKET, SO_TYPE, (char*)&sockType, &optionSize) == -1)
+        throw Exception(Exception::ERROR_GET_ADDR_INFO, "Socket::fromHandler: error getting socket info", getSocketErrorCode());
+
+    if(sockType != SOCK_STREAM && sockType != SOCK_DGRAM)
+        throw Exception(Exception::BAD_PROTOCOL, "Socket::fromHandler: neither a stream nor a datagram socket");
+
+    int listening = 0;
+    optionSize = sizeof(listening);
+    getsockopt(socketHandler, SOL_SOCKET, SO_ACCEPTCONN, (char*)&listening, &optionSize);
+
+    struct sockaddr_storage peer;
+    socklen_t peerSize = sizeof(peer);
+    bool connected = !listening && getpeername(socketHandler, (struct sockaddr*)&peer, &peerSize) == 0;
+
+    Protocol protocol = sockType == SOCK_STREAM ? TCP : UDP;
+    SocketType type = connected ? CLIENT : SERVER;
+    Socket* socket;
+
+    if(local.ss_family == AF_UNIX) {
+        socket = unixSocket(socketHandler, connected ? unixPath((struct sockaddr_un*)&peer, peerSize)
+                                                     : unixPath((struct sockaddr_un*)&local, localSize), protocol, type);
+    }
+
+    else {
+
+        socket = new Socket();
+        socket->_socketHandler = socketHandler;
+        socket->_protocol = protocol;
+        socket->_type = type;
+        socket->_ipVer = local.ss_family == AF_INET6 ? IP6 : IP4;
+        socket->_portFrom = getInPort((struct sockaddr*)&local);
+
+        if(connected) {
+            socket->address((struct sockaddr*)&peer, true);
+            socket->_portTo = getInPort((struct sockaddr*)&peer);
+        }
+        else
+            socket->address((struct sockaddr*)&local, false);
+    }
+
+    #ifndef OS_WIN32
+        int flags = fcntl(socketHandler, F_GETFL);
+        socket->_blocking = flags == -1 || !(flags & O_NONBLOCK);
+    #endif
+
+    return socket;
+}
+
+
+/**
+* Gives up the socket handler without closing it
+*
+* The Socket is left disconnected, and the file of an AF_UNIX SERVER socket is left in place.
+*
+* @return the socket handler, now owned by the caller
+*/
+
+int Socket::release() {
+
+    int socketHandler = _socketHandler;
+    _socketHandler = -1;
+
+    return socketHandler;
+}
+
+
+/*
+* Wraps the AF_UNIX socketHandler in a new Socket
+*/
+
+Socket* Socket::unixSocket(int socketHandler, const string& path, Protocol protocol, SocketType type) {
+
+    Socket* socket = new Socket();
+    socket->_socketHandler = socketHandler;
+    socket->_host = path;
+    socket->_protocol = protocol;
+    socket->_type = type;
+    socket->_local = true;
+
+    return socket;
+}
+
+
+/**
+* Connects many TCP CLIENT sockets at once
+*
+* Starts non-blocking connections to all the targets and waits for all of them together,
+* instead of connecting one after another. The addresses of each target are raced
+* the same way the connection options constructor does.
+*
+* @param targets The remote addresses to connect to
+* @param[out] results Here the function will store the outcome of each target, in the same
+*   order. The connected sockets are owned by the caller.
+* @param options The timeout for all the connections, the delay between connection attempts
+*   of the same target, and the local addresses and port to connect from (shared by all of them)
+* @throw Exception ERROR_SET_ADDR_INFO*, ERROR_SELECT*
+*/
+
+void Socket::connectMany(const vector<ConnectTarget>& targets, vector<ConnectResult>& results,
+                            const ConnectOptions& options) {
+
+    results.assign(targets.size(), ConnectResult());
+
+    vector<ConnectRace> races(targets.size());
+    vector<bool> resolved(targets.size(), true);
+
+    for(unsigned i=0; i < targets.size(); ++i) {
+
+        try {
+            Resolver::resolve(targets[i].hostTo, targets[i].portTo, TCP, targets[i].ipVer, false, races[i].addresses);
+        }
+        catch(Exception& e) {
+            results[i].error = e;
+            resolved[i] = false;
+            races[i].done = true;
+            continue;
+        }
+
+        interleaveFamilies(races[i].addresses);
+    }
+
+    vector<Address> sources;
+    resolveSources(options, sources);
+
+    runConnectRaces(races, options, sources);
+
+    for(unsigned i=0; i < targets.size(); ++i) {
+
+        ConnectRace& race = races[i];
+
+        if(race.handler == -1) {
+
+            if(!resolved[i])
+                continue;
+
+            if(race.error == CONNECT_TIMED_OUT)
+                results[i].error = Exception(Exception::ERROR_CONNECT_SOCKET, "Socket::connectMany: connection timed out", race.error);
+            else
+                results[i].error = Exception(Exception::ERROR_CONNECT_SOCKET, "Socket::connectMany: error in socket connection", race.error);
+
+            continue;
+        }
+
+        Socket* socket = new Socket();
+        socket->_socketHandler = race.handler;
+        socket->_host = targets[i].hostTo;
+        socket->_portTo = targets[i].portTo;
+        socket->_ipVer = race.addresses[race.winner].family == AF_INET6 ? IP6 : IP4;
+
+        if(race.winnerSource != -1)
+            socket->address(sources[race.winnerSource].addr(), false);
+
+        try {
+            socket->_portFrom = getLocalPort(race.handler);
+            socket->blocking(true);
+        }
+        catch(Exception& e) {
+            results[i].error = e;
+            delete socket;
+            continue;
+        }
+
+        results[i].socket = socket;
+    }
+}
+
+
+/**
+* Accepts a new incoming connection (SERVER Socket).
+*
+* Creates a new CLIENT socket to handle the communication (send/recieve data) of
+* this accepted connection. Requires the socket to be a SERVER TCP socket. Throws an
+* exception otherwise.
+*
+* @pre Socket must be SERVER
+* @return A CLIENT socket that handles the new connection, NULL if none could be accepted
+* @throw Exception EXPECTED_TCP_SOCKET, EXPECTED_SERVER_SOCKET
+*/
+
+Socket* Socket::accept() {
+
+    Socket* acceptSocket = NULL;
+    tryAccept(&acceptSocket);
+
+    return acceptSocket;
+}
+
+
+/**
+* Accepts a new incoming connection without throwing on failure (SERVER Socket).
+*
+* Like accept(), but tells apart a non-blocking socket with no pending connection
+* (IO_WOULD_BLOCK) from a failure (IO_ERROR, with the native error code).
+*
+* @pre Socket must be SERVER
+* @param[out] accepted Here the function will store the new CLIENT socket, NULL if none
+* @return IO_DONE, IO_WOULD_BLOCK or IO_ERROR
+* @throw Exception EXPECTED_TCP_SOCKET, EXPECTED_SERVER_SOCKET
+*/
+
+IOResult Socket::tryAccept(Socket** accepted) {
+
+    if(_protocol != TCP)
+        throw Exception(Exception::EXPECTED_TCP_SOCKET, "Socket::accept: non-tcp socket can not accept connections");
+
+    if(_type != SERVER)
+        throw Exception(Exception::EXPECTED_SERVER_SOCKET, "Socket::accept: non-server socket can not accept connections");
+
+    IOResult result = { IO_DONE, 0, 0 };
+    *accepted = NULL;
+
+    struct sockaddr_storage incoming_addr;
+
+    #ifdef OS_WIN32
+        int addrSize = sizeof(incoming_addr);
+    #else
+        unsigned addrSize = sizeof(incoming_addr);
+    #endif
+
+    unsigned long long start = latencyStart();
+    int new_handler = ::accept(_socketHandler, (struct sockaddr *)&incoming_addr, &addrSize);
+    countAccept(new_handler);
+    latencyEnd(LATENCY_ACCEPT, start);
+    NL_PROBE2(accept, _socketHandler, new_handler);
+
+    if(new_handler == -1) {
+        if(wouldBlock())
+            result.status = IO_WOULD_BLOCK;
+        else {
+            result.status = IO_ERROR;
+            result.error = getSocketErrorCode();
+        }
+        return result;
+    }
+
+    if(_local) {
+        *accepted = unixSocket(new_handler, "", TCP, CLIENT);
+        (*accepted)->blocking(_blocking);
+        return result;
+    }
+
+    int localPort = getLocalPort(new_handler);
+
+    Socket* acceptSocket = new Socket();
+    acceptSocket->_socketHandler = new_handler;
+    acceptSocket->address((struct sockaddr *)&incoming_addr, true);
+    acceptSocket->_portTo = getInPort((struct sockaddr *)&incoming_addr);
+    acceptSocket->_portFrom = localPort;
+
+    acceptSocket->_protocol = _protocol;
+    acceptSocket->_ipVer = _ipVer;
+    acceptSocket->blocking(_blocking);
+
+    *accepted = acceptSocket;
+    return result;
+}
+
+
+/**
+* Sends data to an expecific host:port
+*
+* Sends the data contained in buffer to a given host:port. Requires the socket to be an UDP socket,
+* throws an exception otherwise.
+*
+* @pre Socket must be UDP
+* @param buffer A pointer to the data we want to send
+* @param size Size of the data to send (bytes)
+* @param hostTo Target/remote host
+* @param portTo Target/remote port
+* @throw Exception EXPECTED_UDP_SOCKET, BAD_IP_VER, ERROR_SET_ADDR_INFO*, ERROR_SEND*
+*/
+
+
+void Socket::sendTo(const void* buffer, size_t size, const string& hostTo, unsigned portTo) {
+
+    if(_protocol != UDP)
+        throw Exception(Exception::EXPECTED_UDP_SOCKET, "Socket::sendTo: non-UDP socket can not 'sendTo'");
+
+    Address address;
+
+    if(_local)
+        address.length = unixAddress(hostTo, (struct sockaddr_un*)&address.storage);
+
+    else {
+
+        if(_ipVer != IP4 && _ipVer != IP6)
+            throw Exception(Exception::BAD_IP_VER, "Socket::sendTo: bad ip version.");
+
+        Resolver::resolveFirst(hostTo, portTo, UDP, ipVer(), address);
+    }
+
+    size_t sentBytes = 0;
+
+    while(sentBytes < size) {
+
+        unsigned long long start = latencyStart();
+        int status = ::sendto(_socketHandler, (const char*)buffer + sentBytes, size - sentBytes, 0, address.addr(), address.length);
+        countSend(status, size - sentBytes);
+        latencyEnd(LATENCY_SEND, start);
+        NL_PROBE3(send_to, _socketHandler, size - sentBytes, status);
+
+        if(status == -1)
+            throw Exception(Exception::ERROR_SEND, "Socket::sendTo: could not send the data", getSocketErrorCode());
+
+        sentBytes += status;
+    }
+}
+
+
+
+
+/**
+* Receive data and get the source host and port
+*
+* Requires the socket to be UDP. Source host address and port are returned in hostFrom and
+* portFrom parameters. Data recieved is written in buffer address up to bufferSize.
+*
+* @pre Socket must be UDP
+* @param buffer Pointer to a buffer where received data will be stored
+* @param bufferSize Size of the buffer
+* @param[out] hostFrom Here the function will store the address of the remote host
+* @param[out] portFrom Here the function will store the remote port
+* @return the length of the data recieved
+* @throw Exception EXPECTED_UDP_SOCKET, ERROR_READ*
+*/
+
+
+int Socket::readFrom(void* buffer, size_t bufferSize, string* hostFrom, unsigned* portFrom) {
+
+    if(_protocol != UDP)
+        throw Exception(Exception::EXPECTED_UDP_SOCKET, "Socket::readFrom: non-UDP socket can not 'readFrom'");
+
+    struct sockaddr_storage addr;
+    socklen_t addrSize = sizeof(addr);
+    unsigned long long start = latencyStart();
+
+    #ifdef __linux__
+
+        // recvmsg() for the drop count the OS adds once dropCounting() is enabled
+        struct iovec vector;
+        vector.iov_base = buffer;
+        vector.iov_len = bufferSize;
+
+        char control[RECEIVE_CONTROL_SIZE];
+
+        struct msghdr message;
+        memset(&message, 0, sizeof(message));
+        message.msg_name = &addr;
+        message.msg_namelen = addrSize;
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        int status = (int)recvmsg(_socketHandler, &message, 0);
+        addrSize = message.msg_namelen;
+
+    #else
+
+        int status = recvfrom(_socketHandler, (char*)buffer, bufferSize, 0, (struct sockaddr *)&addr, &addrSize);
+
+    #endif
+
+    countRead(status);
+    latencyEnd(LATENCY_RECEIVE, start);
+    NL_PROBE3(read_from, _socketHandler, bufferSize, status);
+
+    if(status == -1) {
+        checkReadError("Socket::readFrom: error detected");
+        if(hostFrom)
+            *hostFrom = "";
+        if(portFrom)
+            *portFrom = 0;
+    }
+
+    else if(_local) {
+
+        if(portFrom)
+            *portFrom = 0;
+        if(hostFrom)
+            *hostFrom = unixPath((struct sockaddr_un*)&addr, addrSize);
+    }
+
+    else {
+
+        #ifdef __linux__
+            countDrops(getDrops(&message));
+        #endif
+
+        if(portFrom)
+            *portFrom = getInPort((struct sockaddr*)&addr);
+
+        if(hostFrom)
+            *hostFrom = getInHost((struct sockaddr*)&addr);
+    }
+
+    return status;
+}
+
+
+/**
+* Receives data along with the time the OS received it
+*
+* Like read(), or readFrom() for UDP sockets, but also returns when the data arrived, as
+* stamped by the kernel once receiveTimestamps() is enabled. For TCP it is the arrival of the
+* last packet read. Compared to the current time, it tells how long the data waited to be read.
+*
+* @param buffer Pointer to a buffer where received data will be stored
+* @param bufferSize Size of the buffer
+* @param[out] arrival Here the function will store the arrival time, in nanoseconds since
+*   the Unix epoch, or 0 when the OS did not stamp it
+* @param[out] hostFrom Here the function will store the address of the remote host, UDP only
+* @param[out] portFrom Here the function will store the remote port, UDP only
+* @return the length of the data recieved or (-1) if Socket is non-blocking and there's no
+*   data received
+* @throw Exception ERROR_READ*
+*/
+
+int Socket::readTimestamped(void* buffer, size_t bufferSize, unsigned long long* arrival,
+                            string* hostFrom, unsigned* portFrom) {
+
+    if(arrival)
+        *arrival = 0;
+
+    struct sockaddr_storage addr;
+    socklen_t addrSize = sizeof(addr);
+
+    unsigned long long start = latencyStart();
+
+    #ifdef OS_WIN32
+
+        int status = recvfrom(_socketHandler, (char*)buffer, (int)bufferSize, 0, (struct sockaddr*)&addr, &addrSize);
+
+    #else
+
+        struct iovec vector;
+        vector.iov_base = buffer;
+        vector.iov_len = bufferSize;
+
+        char control[RECEIVE_CONTROL_SIZE];
+
+        struct msghdr message;
+        memset(&message, 0, sizeof(message));
+        message.msg_name = &addr;
+        message.msg_namelen = addrSize;
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        int status = (int)recvmsg(_socketHandler, &message, 0);
+        addrSize = message.msg_namelen;
+
+    #endif
+
+    countRead(status);
+    latencyEnd(LATENCY_RECEIVE, start);
+
+    if(_protocol == UDP) {
+        NL_PROBE3(read_from, _socketHandler, bufferSize, status);
+    }
+    else {
+        NL_PROBE3(read, _socketHandler, bufferSize, status);
+    }
+
+    if(status == -1) {
+        checkReadError("Socket::readTimestamped: error detected");
+        return status;
+    }
+
+    #ifndef OS_WIN32
+        if(arrival)
+            for(struct cmsghdr* header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header)) {
+
+                #ifdef __linux__
+                    if(header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_TIMESTAMPNS
+                            && controlFits(header, sizeof(struct timespec))) {
+                        struct timespec stamp;
+                        memcpy(&stamp, CMSG_DATA(header), sizeof(stamp));
+                        *arrival = stamp.tv_sec * 1000000000ULL + stamp.tv_nsec;
+                    }
+                #else
+                    if(header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_TIMESTAMP
+                            && controlFits(header, sizeof(struct timeval))) {
+                        struct timeval stamp;
+                        memcpy(&stamp, CMSG_DATA(header), sizeof(stamp));
+                        *arrival = stamp.tv_sec * 1000000000ULL + stamp.tv_usec * 1000ULL;
+                    }
+                #endif
+            }
+    #endif
+
+    if(_protocol != UDP)
+        return status;
+
+    #ifdef __linux__
+        if(!_local)
+            countDrops(getDrops(&message));
+    #endif
+
+    if(_local) {
+
+        if(portFrom)
+            *portFrom = 0;
+        if(hostFrom)
+            *hostFrom = unixPath((struct sockaddr_un*)&addr, addrSize);
+    }
+
+    else {
+
+        if(portFrom)
+            *portFrom = getInPort((struct sockaddr*)&addr);
+        if(hostFrom)
+            *hostFrom = getInHost((struct sockaddr*)&addr);
+    }
+
+    return status;
+}
+
+
+/**
+* Sends data
+*
+* Sends the data contained in buffer. Requires the Socket to be a CLIENT socket, or an UDP one
+* connected with connectTo().
+*
+* @pre Socket must be CLIENT or connected
+* @param buffer A pointer to the data we want to send
+* @param size Length of the data to be sent (bytes)
+* @throw Exception EXPECTED_CLIENT_SOCKET, ERROR_SEND*
+*/
+
+
+void Socket::send(const void* buffer, size_t size) {
+
+    if(_type != CLIENT && !_hasAddressTo)
+        throw Exception(Exception::EXPECTED_CLIENT_SOCKET, "Socket::send: Expected client socket (socket with host and port target)");
+
+    size_t sentData = 0;
+
+    while (sentData < size) {
+
+        unsigned long long start = latencyStart();
+        int status = ::send(_socketHandler, (const char*)buffer + sentData, size - sentData, 0);
+        countSend(status, size - sentData);
+        latencyEnd(LATENCY_SEND, start);
+        NL_PROBE3(send, _socketHandler, size - sentData, status);
+
+        if(status == -1)
+            throw Exception(Exception::ERROR_SEND, "Error sending data", getSocketErrorCode());
+
+        sentData += status;
+    }
+}
+
+/**
+* Sends data as one frame
+*
+* The length prefix and the data go out together, in a single vectored send when the
+* socket takes them at once, so the peer never sees a prefix without its data for long.
+*
+* @param buffer A pointer to the data we want to send
+* @param size Size of the data to send (bytes)
+* @param format The prefix of the frame, and its largest size
+* @throw Exception EXPECTED_CLIENT_SOCKET, OUT_OF_RANGE, ERROR_SEND*
+*/
+
+void Socket::sendFrame(const void* buffer, size_t size, const FrameFormat& format) {
+
+    if(_type != CLIENT && !_hasAddressTo)
+        throw Exception(Exception::EXPECTED_CLIENT_SOCKET, "Socket::sendFrame: Expected client socket (socket with host and port target)");
+
+    if(format.prefixSize != 1 && format.prefixSize != 2 && format.prefixSize != 4)
+        throw Exception(Exception::OUT_OF_RANGE, "Socket::sendFrame: the prefix must be 1, 2 or 4 bytes");
+
+    if(size > format.maxSize || (format.prefixSize < 4 && size >> (8 * format.prefixSize)))
+        throw Exception(Exception::OUT_OF_RANGE, "Socket::sendFrame: the frame is bigger than its prefix allows");
+
+    unsigned char prefix[4];
+    format.prefix(size, prefix);
+
+    size_t total = format.prefixSize + size;
+    size_t sentData = 0;
+
+    while (sentData < total) {
+
+        // what is left of the prefix, then of the data
+        size_t prefixLeft = sentData < format.prefixSize ? format.prefixSize - sentData : 0;
+        size_t dataSent = sentData - (format.prefixSize - prefixLeft);
+
+        unsigned long long start = latencyStart();
+
+        #ifdef OS_WIN32
+
+            WSABUF buffers[2];
+            buffers[0].buf = (char*)prefix + (format.prefixSize - prefixLeft);
+            buffers[0].len = (ULONG)prefixLeft;
+            buffers[1].buf = (char*)buffer + dataSent;
+            buffers[1].len = (ULONG)std::min(size - dataSent, (size_t)0x7FFFFFFF);
+
+            DWORD sent = 0;
+            int status = WSASend(_socketHandler, prefixLeft ? buffers : buffers + 1, prefixLeft ? 2 : 1, &sent, 0, NULL, NULL);
+            if(status != SOCKET_ERROR)
+                status = (int)sent;
+
+        #else
+
+            struct iovec buffers[2];
+            buffers[0].iov_base = prefix + (format.prefixSize - prefixLeft);
+            buffers[0].iov_len = prefixLeft;
+            buffers[1].iov_base = (char*)buffer + dataSent;
+            buffers[1].iov_len = size - dataSent;
+
+            ssize_t status = writev(_socketHandler, prefixLeft ? buffers : buffers + 1, prefixLeft ? 2 : 1);
+
+        #endif
+
+        countSend((long)status, total - sentData);
+        latencyEnd(LATENCY_SEND, start);
+        NL_PROBE3(send, _socketHandler, total - sentData, status);
+
+        if(status == -1)
+            throw Exception(Exception::ERROR_SEND, "Socket::sendFrame: could not send the data", getSocketErrorCode());
+
+        sentData += status;
+    }
+}
+
+
+/**
+* Receives data
+*
+* Receives data and stores it in buffer until bufferSize reached.
+*
+* @param buffer A pointer to a buffer where received data will be stored
+* @param bufferSize Size of the buffer
+* @return Size of received data or (-1) if Socket is non-blocking and there's no data received.
+* @throw Exception ERROR_READ*
+*/
+
+
+int Socket::read(void* buffer, size_t bufferSize) {
+
+    unsigned long long start = latencyStart();
+    int status = recv(_socketHandler, (char*)buffer, bufferSize, 0);
+    countRead(status);
+    latencyEnd(LATENCY_RECEIVE, start);
+    NL_PROBE3(read, _socketHandler, bufferSize, status);
+
+    if(status == -1)
+        checkReadError("Socket::read: error detected");
+
+    return status;
+}
+
+
+/**
+* Receives data without throwing on failure
+*
+* Like read(), for non-blocking loops: would-block, the peer closing a TCP connection and
+* errors are all reported in the returned IOResult.
+*
+* @param buffer A pointer to a buffer where received data will be stored
+* @param bufferSize Size of the buffer
+* @return IO_DONE with the size of received data, IO_WOULD_BLOCK, IO_CLOSED or IO_ERROR
+*/
+
+IOResult Socket::tryRead(void* buffer, size_t bufferSize) {
+
+    IOResult result = { IO_DONE, 0, 0 };
+
+    unsigned long long start = latencyStart();
+    int status = recv(_socketHandler, (char*)buffer, bufferSize, 0);
+    countRead(status);
+    latencyEnd(LATENCY_RECEIVE, start);
+    NL_PROBE3(read, _socketHandler, bufferSize, status);
+
+    if(status == -1) {
+        if(wouldBlock())
+            result.status = IO_WOULD_BLOCK;
+        else {
+            result.status = IO_ERROR;
+            result.error = getSocketErrorCode();
+        }
+    }
+    else if(status == 0 && bufferSize && _protocol == TCP)
+        result.status = IO_CLOSED;
+    else
+        result.size = status;
+
+    return result;
+}
+
+
+/**
+* Sends data without throwing on failure
+*
+* Like send(), but a non-blocking socket sends only what fits in its send buffer: the
+* returned IOResult has the bytes sent and IO_WOULD_BLOCK when that was not all of them.
+*
+* @pre Socket must be CLIENT or connected
+* @param buffer A pointer to the data we want to send
+* @param size Length of the data to be sent (bytes)
+* @return IO_DONE, IO_WOULD_BLOCK or IO_ERROR, with the number of bytes sent
+* @throw Exception EXPECTED_CLIENT_SOCKET
+*/
+
+IOResult Socket::trySend(const void* buffer, size_t size) {
+
+    if(_type != CLIENT && !_hasAddressTo)
+        throw Exception(Exception::EXPECTED_CLIENT_SOCKET, "Socket::trySend: Expected client socket (socket with host and port target)");
+
+    IOResult result = { IO_DONE, 0, 0 };
+
+    while(result.size < size) {
+
+        unsigned long long start = latencyStart();
+        int status = ::send(_socketHandler, (const char*)buffer + result.size, size - result.size, 0);
+        countSend(status, size - result.size);
+        latencyEnd(LATENCY_SEND, start);
+        NL_PROBE3(send, _socketHandler, size - result.size, status);
+
+        if(status == -1) {
+            if(wouldBlock())
+                result.status = IO_WOULD_BLOCK;
+            else {
+                result.status = IO_ERROR;
+                result.error = getSocketErrorCode();
+            }
+            break;
+        }
+
+        result.size += status;
+    }
+
+    return result;
+}
+
+
+/**
+* Sends a datagram to an expecific host:port without throwing on failure
+*
+* Like sendTo(). IP addresses are converted without allocating, host names go through
+* the Resolver cache.
+*
+* @pre Socket must be UDP
+* @param buffer A pointer to the data we want to send
+* @param size Size of the data to send (bytes)
+* @param hostTo Target/remote host
+* @param portTo Target/remote port
+* @return IO_DONE, IO_WOULD_BLOCK or IO_ERROR, with the number of bytes sent
+* @throw Exception EXPECTED_UDP_SOCKET, BAD_IP_VER, ERROR_SET_ADDR_INFO*
+*/
+
+IOResult Socket::trySendTo(const void* buffer, size_t size, const string& hostTo, unsigned portTo) {
+
+    if(_protocol != UDP)
+        throw Exception(Exception::EXPECTED_UDP_SOCKET, "Socket::trySendTo: non-UDP socket can not 'sendTo'");
+
+    Address address;
+
+    if(_local)
+        address.length = unixAddress(hostTo, (struct sockaddr_un*)&address.storage);
+
+    else {
+
+        if(_ipVer != IP4 && _ipVer != IP6)
+            throw Exception(Exception::BAD_IP_VER, "Socket::trySendTo: bad ip version.");
+
+        Resolver::resolveFirst(hostTo, portTo, UDP, ipVer(), address);
+    }
+
+    IOResult result = { IO_DONE, 0, 0 };
+
+    // a datagram is sent whole or not at all
+    unsigned long long start = latencyStart();
+    int status = ::sendto(_socketHandler, (const char*)buffer, size, 0, address.addr(), address.length);
+    countSend(status, size);
+    latencyEnd(LATENCY_SEND, start);
+    NL_PROBE3(send_to, _socketHandler, size, status);
+
+    if(status == -1) {
+        if(wouldBlock())
+            result.status = IO_WOULD_BLOCK;
+        else {
+            result.status = IO_ERROR;
+            result.error = getSocketErrorCode();
+        }
+    }
+    else
+        result.size = status;
+
+    return result;
+}
+
+
+/**
+* Connects an UDP socket to a fixed peer
+*
+* The host is resolved once, then send(), trySend(), read() and tryRead() exchange datagrams
+* with hostTo:portTo only: the OS drops the ones coming from other sources. Connecting again
+* changes the peer. Whether sendTo() can still reach other hosts depends on the OS.
+*
+* @pre Socket must be UDP
+* @param hostTo the target/remote host
+* @param portTo the target/remote port
+* @throw Exception EXPECTED_UDP_SOCKET, BAD_IP_VER, ERROR_SET_ADDR_INFO*, ERROR_CONNECT_SOCKET*
+*/
+
+void Socket::connectTo(const string& hostTo, unsigned portTo) {
+
+    if(_protocol != UDP || _local)
+        throw Exception(Exception::EXPECTED_UDP_SOCKET, "Socket::connectTo: non-UDP socket can not 'connectTo'");
+
+    Address peer;
+    connectDatagram(hostTo, portTo, peer);
+
+    if(_type == CLIENT)
+        _host = hostTo;
+
+    else {
+
+        // _address is about to hold hostTo, so a hostFrom kept there moves to _host
+        if(_hasAddressFrom)
+            _host = this->address();
+
+        address(peer.addr(), true);
+    }
+
+    _portTo = portTo;
+}
+
+
+/*
+* Sends size bytes from buffer as datagrams of segmentSize bytes, the last one shorter when
+* needed, to address (NULL for connected sockets). Where the OS has UDP_SEGMENT, each call
+* hands over as many datagrams as the kernel takes at once, and it splits them.
+*/
+
+void Socket::sendSegmented(const char* buffer, size_t size, unsigned segmentSize, const Address* address) {
+
+    size_t segments = std::max(1u, std::min(MAX_GSO_SEGMENTS, MAX_DATAGRAM_PAYLOAD / segmentSize));
+
+    #ifndef __linux__
+        segments = 1;
+    #endif
+
+    size_t sentBytes = 0;
+
+    while(sentBytes < size) {
+
+        size_t chunk = std::min(size - sentBytes, segments * segmentSize);
+
+        unsigned long long start = latencyStart();
+
+        #ifdef __linux__
+
+            struct iovec vector;
+            vector.iov_base = (void*)(buffer + sentBytes);
+            vector.iov_len = chunk;
+
+            struct msghdr message;
+            memset(&message, 0, sizeof(message));
+            message.msg_name = address ? (void*)address->addr() : NULL;
+            message.msg_namelen = address ? address->length : 0;
+            message.msg_iov = &vector;
+            message.msg_iovlen = 1;
+
+            char control[CMSG_SPACE(sizeof(uint16_t))];
+
+            // a single datagram needs no segmentation
+            if(chunk > segmentSize) {
+
+                memset(control, 0, sizeof(control));
+                message.msg_control = control;
+                message.msg_controllen = sizeof(control);
+
+                struct cmsghdr* header = CMSG_FIRSTHDR(&message);
+                header->cmsg_level = IPPROTO_UDP;
+                header->cmsg_type = UDP_SEGMENT;
+                header->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+
+                uint16_t gsoSize = (uint16_t)segmentSize;
+                memcpy(CMSG_DATA(header), &gsoSize, sizeof(gsoSize));
+            }
+
+            ssize_t status = sendmsg(_socketHandler, &message, 0);
+
+        #else
+
+            int status = address ? ::sendto(_socketHandler, buffer + sentBytes, (int)chunk, 0, address->addr(), address->length)
+                                 : ::send(_socketHandler, buffer + sentBytes, (int)chunk, 0);
+
+        #endif
+
+        countSend((long)status, chunk, (unsigned)((chunk + segmentSize - 1) / segmentSize));
+        latencyEnd(LATENCY_SEND, start);
+
+        if(address) {
+            NL_PROBE3(send_to, _socketHandler, chunk, status);
+        }
+        else {
+            NL_PROBE3(send, _socketHandler, chunk, status);
+        }
+
+        if(status == -1)
+            throw Exception(Exception::ERROR_SEND, "Socket::sendSegments: could not send the data", getSocketErrorCode());
+
+        sentBytes += status;
+    }
+}
+
+
+/**
+* Sends data as many datagrams to the connected peer
+*
+* Splits buffer in datagrams of segmentSize bytes (the last one can be shorter). On Linux
+* the kernel does the split (UDP generic segmentation offload), so tens of datagrams take a
+* single system call; elsewhere they are sent one by one.
+*
+* @pre Socket must be UDP, and CLIENT or connected with connectTo()
+* @param buffer A pointer to the data we want to send
+* @param size Length of the data to be sent (bytes)
+* @param segmentSize Size of each datagram (bytes)
+* @throw Exception EXPECTED_UDP_SOCKET, EXPECTED_CLIENT_SOCKET, ERROR_SEND*
+*/
+
+void Socket::sendSegments(const void* buffer, size_t size, unsigned segmentSize) {
+
+    if(_protocol != UDP || _local)
+        throw Exception(Exception::EXPECTED_UDP_SOCKET, "Socket::sendSegments: non-UDP socket can not 'sendSegments'");
+
+    if(_type != CLIENT && !_hasAddressTo)
+        throw Exception(Exception::EXPECTED_CLIENT_SOCKET, "Socket::sendSegments: Expected client socket (socket with host and port target)");
+
+    if(!segmentSize)
+        throw Exception(Exception::ERROR_SEND, "Socket::sendSegments: segment size can not be 0");
+
+    sendSegmented((const char*)buffer, size, segmentSize, NULL);
+}
+
+
+/**
+* Sends data as many datagrams to an expecific host:port
+*
+* Like sendSegments(), to the given host:port.
+*
+* @pre Socket must be UDP
+* @param buffer A pointer to the data we want to send
+* @param size Length of the data to be sent (bytes)
+* @param segmentSize Size of each datagram (bytes)
+* @param hostTo Target/remote host
+* @param portTo Target/remote port
+* @throw Exception EXPECTED_UDP_SOCKET, BAD_IP_VER, ERROR_SET_ADDR_INFO*, ERROR_SEND*
+*/
+
+void Socket::sendSegmentsTo(const void* buffer, size_t size, unsigned segmentSize, const string& hostTo, unsigned portTo) {
+
+    if(_protocol != UDP || _local)
+        throw Exception(Exception::EXPECTED_UDP_SOCKET, "Socket::sendSegmentsTo: non-UDP socket can not 'sendSegmentsTo'");
+
+    if(!segmentSize)
+        throw Exception(Exception::ERROR_SEND, "Socket::sendSegmentsTo: segment size can not be 0");
+
+    if(_ipVer != IP4 && _ipVer != IP6)
+        throw Exception(Exception::BAD_IP_VER, "Socket::sendSegmentsTo: bad ip version.");
+
+    Address address;
+    Resolver::resolveFirst(hostTo, portTo, UDP, ipVer(), address);
+
+    sendSegmented((const char*)buffer, size, segmentSize, &address);
+}
+
+
+/**
+* Receives datagrams coalesced by the OS
+*
+* With receiveOffload() enabled, Linux joins datagrams of the same size from the same source
+* (UDP generic receive offload), and a single call returns all of them back to back. Without
+* it, or elsewhere, it returns one datagram as readFrom() does.
+*
+* @pre Socket must be UDP
+* @param buffer Pointer to a buffer where received data will be stored. 64 KiB fit any of them.
+* @param bufferSize Size of the buffer
+* @param[out] segmentSize Here the function will store the size of each datagram, all but
+*   the last one, which can be shorter
+* @param[out] hostFrom Here the function will store the address of the remote host
+* @param[out] portFrom Here the function will store the remote port
+* @return the length of the data recieved or (-1) if Socket is non-blocking and there's no
+*   data received
+* @throw Exception EXPECTED_UDP_SOCKET, ERROR_READ*
+*/
+
+int Socket::readSegments(void* buffer, size_t bufferSize, unsigned* segmentSize, string* hostFrom, unsigned* portFrom) {
+
+    if(_protocol != UDP || _local)
+        throw Exception(Exception::EXPECTED_UDP_SOCKET, "Socket::readSegments: non-UDP socket can not 'readSegments'");
+
+    struct sockaddr_storage addr;
+    socklen_t addrSize = sizeof(addr);
+
+    unsigned long long start = latencyStart();
+
+    #ifdef __linux__
+
+        struct iovec vector;
+        vector.iov_base = buffer;
+        vector.iov_len = bufferSize;
+
+        char control[RECEIVE_CONTROL_SIZE];
+
+        struct msghdr message;
+        memset(&message, 0, sizeof(message));
+        message.msg_name = &addr;
+        message.msg_namelen = addrSize;
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        int status = (int)recvmsg(_socketHandler, &message, 0);
+
+    #else
+
+        int status = recvfrom(_socketHandler, (char*)buffer, (int)bufferSize, 0, (struct sockaddr*)&addr, &addrSize);
+
+    #endif
+
+    if(status == -1) {
+        countRead(status);
+        latencyEnd(LATENCY_RECEIVE, start);
+        NL_PROBE3(read_from, _socketHandler, bufferSize, status);
+        checkReadError("Socket::readSegments: error detected");
+        return status;
+    }
+
+    unsigned gsoSize = status;
+
+    #ifdef __linux__
+        for(struct cmsghdr* header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header))
+            if(header->cmsg_level == IPPROTO_UDP && header->cmsg_type == UDP_GRO
+                    && controlFits(header, sizeof(int))) {
+                int value;
+                memcpy(&value, CMSG_DATA(header), sizeof(value));
+                gsoSize = value;
+            }
+
+        countDrops(getDrops(&message));
+    #endif
+
+    countRead(status, gsoSize ? (status + gsoSize - 1) / gsoSize : 1);
+    latencyEnd(LATENCY_RECEIVE, start);
+    NL_PROBE3(read_from, _socketHandler, bufferSize, status);
+
+    if(segmentSize)
+        *segmentSize = gsoSize;
+
+    if(portFrom)
+        *portFrom = getInPort((struct sockaddr*)&addr);
+
+    if(hostFrom)
+        *hostFrom = getInHost((struct sockaddr*)&addr);
+
+    return status;
+}
+
+
+/**
+* Sends data without copying it to the kernel
+*
+* With zeroCopy() enabled, sends of ZEROCOPY_MIN_SIZE bytes or more use MSG_ZEROCOPY: the
+* kernel reads buffer while sending, so it must not be modified or freed until the completions
+* of the returned notifications are read with readZeroCopyCompletion(). Each call to the OS
+* takes one notification, numbered from 0 on by the OS for every socket. Smaller sends, and
+* all of them when zeroCopy() is disabled, are copied as send() does and take none.
+*
+* @pre Socket must be CLIENT or connected
+* @param buffer A pointer to the data we want to send
+* @param size Length of the data to be sent (bytes)
+* @param[out] notifications Here the function will store the number of notifications taken, 0
+*   when the data was copied. Also when an Exception is thrown, as part of the data may have
+*   been sent without copying it before, and buffer is in use until those complete too.
+* @throw Exception EXPECTED_CLIENT_SOCKET, ERROR_SEND*
+*/
+
+void Socket::sendZeroCopy(const void* buffer, size_t size, unsigned* notifications) {
+
+    *notifications = 0;
+
+    if(_type != CLIENT && !_hasAddressTo)
+        throw Exception(Exception::EXPECTED_CLIENT_SOCKET, "Socket::sendZeroCopy: Expected client socket (socket with host and port target)");
+
+    size_t sentBytes = 0;
+
+    #ifdef __linux__
+
+        while(_zeroCopy && size - sentBytes >= ZEROCOPY_MIN_SIZE) {
+
+            ssize_t status = ::send(_socketHandler, (const char*)buffer + sentBytes, size - sentBytes, MSG_ZEROCOPY);
+            countSend((long)status, size - sentBytes);
+            NL_PROBE3(send, _socketHandler, size - sentBytes, status);
+
+            if(status == -1) {
+
+                // out of memory for the notifications, so the rest is copied
+                if(errno == ENOBUFS)
+                    break;
+
+                throw Exception(Exception::ERROR_SEND, "Socket::sendZeroCopy: could not send the data", errno);
+            }
+
+            sentBytes += status;
+            (*notifications)++;
+        }
+
+    #endif
+
+    if(sentBytes < size)
+        send((const char*)buffer + sentBytes, size - sentBytes);
+}
+
+
+/**
+* Reads the completion of zero copy sends
+*
+* Once completed, the buffers of the notifications from first to last (both included) are no
+* longer used by the OS. Completions may cover the notifications of several sendZeroCopy()
+* calls, and they can arrive out of order. This never blocks.
+*
+* @param[out] first Here the function will store the first notification completed
+* @param[out] last Here the function will store the last notification completed
+* @param[out] copied Here the function will store whether the OS had to copy the data after
+*   all, as it does for loopback connections
+* @return true if a completion was read, false if there are none to read
+* @throw Exception ERROR_READ*
+*/
+
+bool Socket::readZeroCopyCompletion(unsigned* first, unsigned* last, bool* copied) {
+
+    #ifdef __linux__
+
+        for(;;) {
+
+            char control[CMSG_SPACE(sizeof(struct sock_extended_err) + sizeof(struct sockaddr_in6))];
+
+            struct msghdr message;
+            memset(&message, 0, sizeof(message));
+            message.msg_control = control;
+            message.msg_controllen = sizeof(control);
+
+            if(recvmsg(_socketHandler, &message, MSG_ERRQUEUE | MSG_DONTWAIT) == -1) {
+
+                if(errno == EAGAIN || errno == EWOULDBLOCK)
+                    return false;
+
+                throw Exception(Exception::ERROR_READ, "Socket::readZeroCopyCompletion: error detected", errno);
+            }
+
+            for(struct cmsghdr* header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header)) {
+
+                if(!(header->cmsg_level == SOL_IP && header->cmsg_type == IP_RECVERR)
+                    && !(header->cmsg_level == SOL_IPV6 && header->cmsg_type == IPV6_RECVERR))
+                    continue;
+
+                struct sock_extended_err error;
+                memcpy(&error, CMSG_DATA(header), sizeof(error));
+
+                if(error.ee_errno || error.ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+                    continue;
+
+                *first = error.ee_info;
+                *last = error.ee_data;
+
+                if(copied)
+                    *copied = (error.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) != 0;
+
+                return true;
+            }
+
+            // something else was queued, such as an ICMP error: skip it
+        }
+
+    #else
+
+        return false;
+
+    #endif
+}
+
+
+/**
+* Sends a file/socket descriptor to the process at the other end of an AF_UNIX socket
+*
+* The receiving process gets its own descriptor for the same file or connection, with
+* receiveFd(). One byte of data goes along with it, so receiveFd() calls must match
+* sendFd() ones in streams that carry other data too.
+*
+* @pre Socket must be an AF_UNIX CLIENT
+* @param fd the descriptor to send. It stays open in this process.
+* @throw Exception BAD_PROTOCOL, ERROR_SEND*
+*/
+
+void Socket::sendFd(int fd) {
+
+    #ifdef OS_WIN32
+        throw Exception(Exception::BAD_PROTOCOL, "Socket::sendFd: descriptors can not be passed on Windows");
+    #else
+
+        if(!_local)
+            throw Exception(Exception::BAD_PROTOCOL, "Socket::sendFd: descriptors can only be passed over AF_UNIX sockets");
+
+        char data = 0;
+        struct iovec iov;
+        iov.iov_base = &data;
+        iov.iov_len = 1;
+
+        union {
+            struct cmsghdr header;
+            char buffer[CMSG_SPACE(sizeof(int))];
+        } control;
+        memset(&control, 0, sizeof(control));
+
+        struct msghdr message;
+        memset(&message, 0, sizeof(message));
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+        message.msg_control = control.buffer;
+        message.msg_controllen = sizeof(control.buffer);
+
+        struct cmsghdr* header = CMSG_FIRSTHDR(&message);
+        header->cmsg_level = SOL_SOCKET;
+        header->cmsg_type = SCM_RIGHTS;
+        header->cmsg_len = CMSG_LEN(sizeof(int));
+        memcpy(CMSG_DATA(header), &fd, sizeof(int));
+
+        int status = sendmsg(_socketHandler, &message, 0);
+        countSend(status, iov.iov_len);
+
+        if(status == -1)
+            throw Exception(Exception::ERROR_SEND, "Socket::sendFd: could not send the descriptor", getSocketErrorCode());
+    #endif
+}
+
+
+/**
+* Hands a socket over to the process at the other end of an AF_UNIX socket
+*
+* Sends the handler of socket, like sendFd(), and then closes it in this process: the
+* connection now belongs to the receiver. Nothing is drained or reset, and the file of an
+* AF_UNIX SERVER socket is left in place.
+*
+* @pre Socket must be an AF_UNIX CLIENT
+* @param socket the socket to hand over, left disconnected
+* @throw Exception BAD_PROTOCOL, ERROR_SEND*
+*/
+
+void Socket::sendFd(Socket& socket) {
+
+    sendFd(socket._socketHandler);
+
+    close(socket.release());
+}
+
+
+/**
+* Receives a file/socket descriptor sent with sendFd()
+*
+* @pre Socket must be an AF_UNIX CLIENT
+* @return the received descriptor, owned by the caller (see fromHandler()). -1 if the
+*   Socket is non-blocking and nothing was received.
+* @throw Exception BAD_PROTOCOL, ERROR_READ*
+*/
+
+int Socket::receiveFd() {
+
+    #ifdef OS_WIN32
+        throw Exception(Exception::BAD_PROTOCOL, "Socket::receiveFd: descriptors can not be passed on Windows");
+    #else
+
+        if(!_local)
+            throw Exception(Exception::BAD_PROTOCOL, "Socket::receiveFd: descriptors can only be passed over AF_UNIX sockets");
+
+        char data;
+        struct iovec iov;
+        iov.iov_base = &data;
+        iov.iov_len = 1;
+
+        union {
+            struct cmsghdr header;
+            char buffer[CMSG_SPACE(sizeof(int))];
+        } control;
+
+        struct msghdr message;
+        memset(&message, 0, sizeof(message));
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+        message.msg_control = control.buffer;
+        message.msg_controllen = sizeof(control.buffer);
+
+        int flags = 0;
+        #ifdef MSG_CMSG_CLOEXEC
+            flags = MSG_CMSG_CLOEXEC;
+        #endif
+
+        int status = recvmsg(_socketHandler, &message, flags);
+        countRead(status);
+
+        if(status == -1) {
+            checkReadError("Socket::receiveFd: error detected");
+            return -1;
+        }
+
+        if(status == 0)
+            throw Exception(Exception::ERROR_READ, "Socket::receiveFd: connection closed");
+
+        struct cmsghdr* header = CMSG_FIRSTHDR(&message);
+
+        if(!header || header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_RIGHTS)
+            throw Exception(Exception::ERROR_READ, "Socket::receiveFd: no descriptor received");
+
+        int fd;
+        memcpy(&fd, CMSG_DATA(header), sizeof(int));
+
+        return fd;
+    #endif
+}
+
+
+/**
+* Get next read() data size
+*
+* Get the size of the data (bytes) a call to read() or readFrom() can process
+*
+* @return size of data the next call to read/readFrom will receive
+* @throw Exception ERROR_IOCTL*
+*/
+
+
+int Socket::nextReadSize() const {
+
+	#ifdef OS_WIN32
+		u_long result = -1;
+	#else
+		long int result = -1;
+	#endif
+
+    int status;
+
+    #ifdef OS_WIN32
+        status = ioctlsocket(_socketHandler, FIONREAD, &result);
+    #else
+        status = ioctl(_socketHandler, FIONREAD, &result);
+    #endif
+
+    if(status)
+        throw Exception(Exception::ERROR_IOCTL, "Socket::nextReadSize: error ioctl", getSocketErrorCode());
+
+    return result;
+}
+
+
+/**
+* Gets what the OS knows of the connection: round trip time, congestion window, retransmissions...
 *
-* @pre Socket must be UDP
-* @param buffer Pointer to a buffer where received data will be stored
-* @param bufferSize Size of the buffer
-* @param[out] hostFrom Here the function will store the address of the remote host
-* @param[out] portFrom Here the function will store the remote port
-* @return the length of the data recieved
-* @throw Exception EXPECTED_UDP_SOCKET, ERROR_READ*
+* Only Linux has it (TCP_INFO). Elsewhere, and when the OS fails to tell, it returns false.
+*
+* @param[out] info Here the function will store the information of the connection
+* @return true if info was filled in, false otherwise
+* @throw Exception EXPECTED_TCP_SOCKET
 */
 
+bool Socket::tcpInfo(TcpInfo* info) const {
+
+    if(_protocol != TCP || _local)
+        throw Exception(Exception::EXPECTED_TCP_SOCKET, "Socket::tcpInfo: non-TCP socket has no TCP info");
+
+    #ifdef __linux__
+
+        struct tcp_info tcp;
+        socklen_t size = sizeof(tcp);
+        memset(&tcp, 0, sizeof(tcp));
+
+        if(getsockopt(_socketHandler, IPPROTO_TCP, TCP_INFO, &tcp, &size) == -1)
+            return false;
+
+        info->state = tcp.tcpi_state;
+        info->caState = tcp.tcpi_ca_state;
+        info->retransmits = tcp.tcpi_retransmits;
+        info->probes = tcp.tcpi_probes;
+        info->backoff = tcp.tcpi_backoff;
+        info->rto = tcp.tcpi_rto;
+        info->ato = tcp.tcpi_ato;
+        info->sndMss = tcp.tcpi_snd_mss;
+        info->rcvMss = tcp.tcpi_rcv_mss;
+        info->unacked = tcp.tcpi_unacked;
+        info->sacked = tcp.tcpi_sacked;
+        info->lost = tcp.tcpi_lost;
+        info->retrans = tcp.tcpi_retrans;
+        info->lastDataSent = tcp.tcpi_last_data_sent;
+        info->lastDataReceived = tcp.tcpi_last_data_recv;
+        info->lastAckReceived = tcp.tcpi_last_ack_recv;
+        info->pmtu = tcp.tcpi_pmtu;
+        info->rcvSsthresh = tcp.tcpi_rcv_ssthresh;
+        info->rtt = tcp.tcpi_rtt;
+        info->rttVar = tcp.tcpi_rttvar;
+        info->sndSsthresh = tcp.tcpi_snd_ssthresh;
+        info->sndCwnd = tcp.tcpi_snd_cwnd;
+        info->advMss = tcp.tcpi_advmss;
+        info->reordering = tcp.tcpi_reordering;
+        info->rcvRtt = tcp.tcpi_rcv_rtt;
+        info->rcvSpace = tcp.tcpi_rcv_space;
+        info->totalRetrans = tcp.tcpi_total_retrans;
+
+        return true;
 
-int Socket::readFrom(void* buffer, size_t bufferSize, string* hostFrom, unsigned* portFrom) {
+    #else
 
-    if(_protocol != UDP)
-        throw Exception(Exception::EXPECTED_UDP_SOCKET, "Socket::readFrom: non-UDP socket can not 'readFrom'");
+        (void)info;
+        return false;
 
-    struct sockaddr_storage addr;
-    socklen_t addrSize = sizeof(addr);
-    int status = recvfrom(_socketHandler, (char*)buffer, bufferSize, 0, (struct sockaddr *)&addr, &addrSize);
+    #endif
+}
 
-    if(status == -1) {
-        checkReadError("readFrom");
-        if(hostFrom)
-            *hostFrom = "";
-        if(portFrom)
-            *portFrom = 0;
-    }
 
-    else {
+/**
+* Gets the memory the OS has for the socket: its buffers, what is queued in them, and drops
+*
+* Only Linux has it (SO_MEMINFO). Elsewhere, and when the OS fails to tell, it returns false.
+*
+* @param[out] memory Here the function will store the memory of the socket
+* @return true if memory was filled in, false otherwise
+*/
 
-        if(portFrom)
-            *portFrom = getInPort((struct sockaddr*)&addr);
+bool Socket::memoryInfo(SocketMemory* memory) const {
 
-        if(hostFrom) {
-            char hostChar[INET6_ADDRSTRLEN];
-            inet_ntop(addr.ss_family, get_in_addr((struct sockaddr *)&addr), hostChar, sizeof hostChar);
+    #ifdef __linux__
 
-            *hostFrom = hostChar;
-        }
-    }
+        uint32_t values[SK_MEMINFO_VARS];
+        socklen_t size = sizeof(values);
+        memset(values, 0, sizeof(values));
 
-    return status;
+        if(getsockopt(_socketHandler, SOL_SOCKET, SO_MEMINFO, values, &size) == -1)
+            return false;
+
+        memory->receiveAllocated = values[SK_MEMINFO_RMEM_ALLOC];
+        memory->receiveBuffer = values[SK_MEMINFO_RCVBUF];
+        memory->sendAllocated = values[SK_MEMINFO_WMEM_ALLOC];
+        memory->sendBuffer = values[SK_MEMINFO_SNDBUF];
+        memory->forwardAllocated = values[SK_MEMINFO_FWD_ALLOC];
+        memory->sendQueued = values[SK_MEMINFO_WMEM_QUEUED];
+        memory->optionMemory = values[SK_MEMINFO_OPTMEM];
+        memory->backlog = values[SK_MEMINFO_BACKLOG];
+        memory->drops = values[SK_MEMINFO_DROPS];
+
+        return true;
+
+    #else
+
+        (void)memory;
+        return false;
+
+    #endif
 }
 
 
 /**
-* Sends data
+* Returns the target host of the socket
 *
-* Sends the data contained in buffer. Requires the Socket to be a CLIENT socket.
+* @return the host this socket is connected to (in TCP
+* case) or the host it sends data to (UDP case)
+*/
+
+string Socket::hostTo() const {
+
+    if(_hasAddressTo)
+        return address();
+
+    return _type == CLIENT ? _host : string();
+}
+
+
+/**
+* Returns the socket local address
 *
-* @pre Socket must be CLIENT
-* @param buffer A pointer to the data we want to send
-* @param size Length of the data to be sent (bytes)
-* @throw Exception EXPECTED_CLIENT_SOCKET, ERROR_SEND*
+* @return socket local address
 */
 
+string Socket::hostFrom() const {
 
-void Socket::send(const void* buffer, size_t size) {
+    if(_hasAddressFrom)
+        return address();
 
-    if(_type != CLIENT)
-        throw Exception(Exception::EXPECTED_CLIENT_SOCKET, "Socket::send: Expected client socket (socket with host and port target)");
+    return _type == SERVER ? _host : string();
+}
 
-    if(_protocol == UDP)
-        return sendTo(buffer, size, _hostTo, _portTo);
 
-    size_t sentData = 0;
+/*
+* Keeps the binary form of the IP address of addr, as hostTo or as hostFrom
+*/
 
-    while (sentData < size) {
+void Socket::address(const struct sockaddr* addr, bool isHostTo) {
 
-        int status = ::send(_socketHandler, (const char*)buffer + sentData, size - sentData, 0);
+    if(addr->sa_family == AF_INET6)
+        memcpy(_address, &((const struct sockaddr_in6*)addr)->sin6_addr, 16);
+    else
+        memcpy(_address, &((const struct sockaddr_in*)addr)->sin_addr, 4);
 
-        if(status == -1)
-            throw Exception(Exception::ERROR_SEND, "Error sending data", getSocketErrorCode());
+    _hasAddressTo = isHostTo;
+    _hasAddressFrom = !isHostTo;
+}
 
-        sentData += status;
-    }
+
+string Socket::address() const {
+
+    char hostChar[INET6_ADDRSTRLEN];
+
+    if(inet_ntop(_ipVer == IP6 ? AF_INET6 : AF_INET, (void*)_address, hostChar, sizeof hostChar) == NULL)
+        return string();
+
+    return hostChar;
+}
+
+
+/*
+* Removes the file an AF_UNIX SERVER socket was bound to, which would make binding to
+* the same path fail from then on
+*/
+
+void Socket::removePath() const {
+
+    if(_ownsPath)
+        remove(_host.c_str());
 }
 
+
 /**
-* Receives data
+* Sets the blocking nature of the Socket
 *
-* Receives data and stores it in buffer until bufferSize reached.
+* Sets the Socket as blocking (if blocking is true) or as non-blocking (otherwise)
 *
-* @param buffer A pointer to a buffer where received data will be stored
-* @param bufferSize Size of the buffer
-* @return Size of received data or (-1) if Socket is non-blocking and there's no data received.
-* @throw Exception ERROR_READ*
+* @param blocking true to set the Socket as blocking; false to set the Socket as non-blocking
+* @throw Exception ERROR_IOCTL*
 */
 
+void Socket::blocking(bool blocking) {
 
-int Socket::read(void* buffer, size_t bufferSize) {
+    if (setHandlerBlocking(_socketHandler, blocking) == -1)
+        throw Exception(Exception::ERROR_IOCTL, "Socket::blocking: ioctl error", getSocketErrorCode());
 
-    int status = recv(_socketHandler, (char*)buffer, bufferSize, 0);
+    _blocking = blocking;
+}
 
-    if(status == -1)
-        checkReadError("read");
 
-    return status;
+/**
+* Enables or disables the receive offload of an UDP socket
+*
+* Enabled, Linux coalesces the datagrams that arrive together, to be read with readSegments().
+* Other reads would get them joined with no way to split them back. Elsewhere it does nothing.
+*
+* @param enable true to enable it, false to disable it
+* @throw Exception EXPECTED_UDP_SOCKET, ERROR_SET_SOCK_OPT*
+*/
+
+void Socket::receiveOffload(bool enable) {
+
+    if(_protocol != UDP || _local)
+        throw Exception(Exception::EXPECTED_UDP_SOCKET, "Socket::receiveOffload: non-UDP socket can not offload receives");
+
+    #ifdef __linux__
+
+        int value = enable;
+
+        if(setsockopt(_socketHandler, IPPROTO_UDP, UDP_GRO, &value, sizeof(value)) == -1)
+            throw Exception(Exception::ERROR_SET_SOCK_OPT, "Socket::receiveOffload: could not set UDP_GRO", getSocketErrorCode());
+
+    #endif
 }
 
 
 /**
-* Get next read() data size
+* Returns whether the receive offload of the socket is enabled
 *
-* Get the size of the data (bytes) a call to read() or readFrom() can process
+* @return true if the OS coalesces the datagrams received, false otherwise
+*/
+
+bool Socket::receiveOffload() const {
+
+    #ifdef __linux__
+
+        int value = 0;
+        socklen_t size = sizeof(value);
+
+        if(_protocol == UDP && !_local
+            && getsockopt(_socketHandler, IPPROTO_UDP, UDP_GRO, &value, &size) == 0)
+            return value != 0;
+
+    #endif
+
+    return false;
+}
+
+
+/**
+* Enables or disables counting the datagrams dropped for an UDP socket
 *
-* @return size of data the next call to read/readFrom will receive
-* @throw Exception ERROR_IOCTL*
+* Enabled, Linux adds how many datagrams it dropped for the socket, as its receive buffer was
+* full, to those received (SO_RXQ_OVFL). readFrom(), readTimestamped() and readSegments() add
+* them to the drops of stats(). Elsewhere it does nothing.
+*
+* @param enable true to enable it, false to disable it
+* @throw Exception EXPECTED_UDP_SOCKET, ERROR_SET_SOCK_OPT*
 */
 
+void Socket::dropCounting(bool enable) {
 
-int Socket::nextReadSize() const {
+    if(_protocol != UDP || _local)
+        throw Exception(Exception::EXPECTED_UDP_SOCKET, "Socket::dropCounting: non-UDP socket can not count drops");
 
-	#ifdef OS_WIN32
-		u_long result = -1;
-	#else
-		long int result = -1;
-	#endif
+    #ifdef __linux__
 
-    int status;
+        int value = enable;
+
+        if(setsockopt(_socketHandler, SOL_SOCKET, SO_RXQ_OVFL, &value, sizeof(value)) == -1)
+            throw Exception(Exception::ERROR_SET_SOCK_OPT, "Socket::dropCounting: could not set SO_RXQ_OVFL", getSocketErrorCode());
 
-    #ifdef OS_WIN32
-        status = ioctlsocket(_socketHandler, FIONREAD, &result);
-    #else
-        status = ioctl(_socketHandler, FIONREAD, &result);
     #endif
+}
 
-    if(status)
-        throw Exception(Exception::ERROR_IOCTL, "Socket::nextReadSize: error ioctl", getSocketErrorCode());
 
-    return result;
+/**
+* Returns whether the socket counts the datagrams dropped for it
+*
+* @return true if the OS reports the drops with the datagrams received, false otherwise
+*/
+
+bool Socket::dropCounting() const {
+
+    #ifdef __linux__
+
+        int value = 0;
+        socklen_t size = sizeof(value);
+
+        if(_protocol == UDP && !_local
+            && getsockopt(_socketHandler, SOL_SOCKET, SO_RXQ_OVFL, &value, &size) == 0)
+            return value != 0;
+
+    #endif
+
+    return false;
 }
 
 
 /**
-* Sets the blocking nature of the Socket
+* Enables or disables receive timestamps
 *
-* Sets the Socket as blocking (if blocking is true) or as non-blocking (otherwise)
+* Enabled, the OS stamps the data it receives with the time it arrived (SO_TIMESTAMPNS on
+* Linux, SO_TIMESTAMP elsewhere), which readTimestamped() returns. Windows has none.
 *
-* @param blocking true to set the Socket as blocking; false to set the Socket as non-blocking
-* @throw Exception ERROR_IOCTL*
+* @param enable true to enable it, false to disable it
+* @throw Exception ERROR_SET_SOCK_OPT*
 */
 
-void Socket::blocking(bool blocking) {
+void Socket::receiveTimestamps(bool enable) {
 
-    _blocking = blocking;
+    #ifndef OS_WIN32
 
-    int result = -1;
+        int value = enable;
 
-    #ifdef OS_WIN32
+        #ifdef __linux__
+            int option = SO_TIMESTAMPNS;
+        #else
+            int option = SO_TIMESTAMP;
+        #endif
 
-        u_long non_blocking = !blocking;
-        result = ioctlsocket(_socketHandler, FIONBIO, &non_blocking);
-        if(result!=0)
-            result = -1;
-    #else
+        if(setsockopt(_socketHandler, SOL_SOCKET, option, &value, sizeof(value)) == -1)
+            throw Exception(Exception::ERROR_SET_SOCK_OPT, "Socket::receiveTimestamps: could not enable timestamps", getSocketErrorCode());
+
+    #endif
+}
 
-        int flags = fcntl(_socketHandler, F_GETFL);
 
-        if(blocking)
-            result = fcntl(_socketHandler, F_SETFL, flags & ~O_NONBLOCK);
-        else
-            result = fcntl(_socketHandler, F_SETFL, flags | O_NONBLOCK);
+/**
+* Returns whether the socket has receive timestamps enabled
+*
+* @return true if the OS stamps the data received, false otherwise
+*/
+
+bool Socket::receiveTimestamps() const {
+
+    #ifndef OS_WIN32
+
+        int value = 0;
+        socklen_t size = sizeof(value);
+
+        #ifdef __linux__
+            int option = SO_TIMESTAMPNS;
+        #else
+            int option = SO_TIMESTAMP;
+        #endif
+
+        if(getsockopt(_socketHandler, SOL_SOCKET, option, &value, &size) == 0)
+            return value != 0;
+
     #endif
 
-    if (result == -1)
-        throw Exception(Exception::ERROR_IOCTL, "Socket::blocking: ioctl error", getSocketErrorCode());
+    return false;
+}
+
+
+/**
+* Enables or disables recording the latency of the blocking calls of this socket
+*
+* Enabled, the durations of accept, receive and send calls of a blocking socket are recorded
+* in histograms of its own, besides those of processLatency(). Each takes a few KiB, so it is
+* left to the sockets of interest. Disabling it discards them.
+*
+* @param enable true to enable it, false to disable it
+*/
+
+void Socket::latencyTracking(bool enable) {
+
+    if(enable && !_latency)
+        _latency = new LatencyHistogram[LATENCY_OPS];
+
+    else if(!enable) {
+        delete[] _latency;
+        _latency = NULL;
+    }
+}
+
+
+/**
+* Enables or disables zero copy sends
+*
+* Enabled, sendZeroCopy() lets the OS read large sends straight from the buffers given, which
+* saves copying them but has to be followed by readZeroCopyCompletion(). Requires Linux 4.14
+* for TCP and 5.0 for UDP. Elsewhere it does nothing and zeroCopy() stays false.
+*
+* @param enable true to enable it, false to disable it
+* @throw Exception ERROR_SET_SOCK_OPT*
+*/
+
+void Socket::zeroCopy(bool enable) {
+
+    #ifdef __linux__
+
+        int value = enable;
+
+        if(setsockopt(_socketHandler, SOL_SOCKET, SO_ZEROCOPY, &value, sizeof(value)) == -1)
+            throw Exception(Exception::ERROR_SET_SOCK_OPT, "Socket::zeroCopy: could not set SO_ZEROCOPY", getSocketErrorCode());
+
+        _zeroCopy = enable;
+
+    #endif
+}
+
+
+/*
+* Shuts down the sending side of the connected handlers and discards what arrives until
+* each peer closes its side as well, or timeout milisecs pass. Handlers that can not be
+* shut down (UDP, listening or already reset sockets) are left alone.
+*/
+
+static void drainHandlers(const vector<int>& handlers, unsigned timeout) {
+
+    vector<struct pollfd> fds;
+
+    for(unsigned i=0; i < handlers.size(); ++i) {
+
+        if(shutdown(handlers[i], SHUT_WR) == -1 || setHandlerBlocking(handlers[i], false) == -1)
+            continue;
+
+        struct pollfd fd;
+        fd.fd = handlers[i];
+        fd.events = POLLIN;
+        fd.revents = 0;
+
+        fds.push_back(fd);
+    }
+
+    unsigned long long deadline = getMonotonicTime() + timeout;
+    char buffer[4096];
+
+    while(!fds.empty()) {
+
+        unsigned long long now = getMonotonicTime();
+
+        if(now >= deadline)
+            return;
+
+        int status = poll(&fds[0], fds.size(), (int)std::min(deadline - now, 0x7FFFFFFFULL));
+
+        if(status == -1) {
+
+            if(pollInterrupted())
+                continue;
+
+            return;
+        }
+
+        // backwards, so drained handlers can be erased without moving the pending ones
+        for(size_t i = fds.size(); status > 0 && i-- > 0;) {
+
+            if(!fds[i].revents)
+                continue;
+
+            status--;
+
+            // a bounded number of reads, so a peer that keeps sending can not outlast the timeout
+            int bytes = 0;
+            for(unsigned reads = 0; reads < 16 && (bytes = recv(fds[i].fd, buffer, sizeof(buffer), 0)) > 0; ++reads);
+
+            if(bytes == 0 || (bytes == -1 && !wouldBlock()))
+                fds.erase(fds.begin() + i);
+            else
+                fds[i].revents = 0;
+        }
+    }
+}
+
+
+static void closeHandlers(const vector<int>& handlers, DisconnectMode mode, unsigned timeout) {
+
+    if(mode == ABORT) {
+
+        struct linger noLinger;
+        noLinger.l_onoff = 1;
+        noLinger.l_linger = 0;
+
+        for(unsigned i=0; i < handlers.size(); ++i)
+            setsockopt(handlers[i], SOL_SOCKET, SO_LINGER, (char*)&noLinger, sizeof(noLinger));
+    }
+
+    else if(mode == GRACEFUL)
+        drainHandlers(handlers, timeout);
+
+    for(unsigned i=0; i < handlers.size(); ++i)
+        if(handlers[i] != -1) {
+            FlightRecorder::record(TRACE_DISCONNECT, handlers[i], mode, 0);
+            close(handlers[i]);
+        }
 }
 
 
 /**
 * Closes (disconnects) the socket. After this call the socket can not be used.
 *
+* By default the socket is just closed. Short lived TCP connections closed this way pile
+* up in TIME_WAIT state, holding ports and kernel memory for a while: ABORT resets the
+* connection instead, leaving no TIME_WAIT behind (but discarding the unsent data).
+* GRACEFUL makes sure the peer got everything: it stops sending and waits for the peer
+* to close its side before closing.
+*
+* @param mode how to close the socket (CLOSE, ABORT or GRACEFUL). CLOSE by default.
+* @param timeout milisecs GRACEFUL waits for the peer to close its side
+*
 * @warning Any use of the Socket after disconnection leads to undefined behaviour.
 */
 
 
-void Socket::disconnect() {
+void Socket::disconnect(DisconnectMode mode, unsigned timeout) {
+
+    if(_socketHandler != -1)
+        removePath();
 
-    close(_socketHandler);
+    closeHandlers(vector<int>(1, _socketHandler), mode, timeout);
 
     _socketHandler = -1;
 
 }
 
+
+/**
+* Disconnects many sockets at once
+*
+* Same as calling disconnect() on each of them, but GRACEFUL waits for all of the
+* peers together: it takes timeout milisecs at most, instead of timeout for each socket.
+*
+* @param sockets the sockets to disconnect. They still have to be deleted by the caller.
+* @param mode how to close the sockets (CLOSE, ABORT or GRACEFUL). CLOSE by default.
+* @param timeout milisecs GRACEFUL waits for the peers to close their side
+*/
+
+void Socket::disconnectAll(const vector<Socket*>& sockets, DisconnectMode mode, unsigned timeout) {
+
+    vector<int> handlers;
+    handlers.reserve(sockets.size());
+
+    for(unsigned i=0; i < sockets.size(); ++i)
+        if(sockets[i]->_socketHandler != -1) {
+            handlers.push_back(sockets[i]->_socketHandler);
+            sockets[i]->_socketHandler = -1;
+            sockets[i]->removePath();
+        }
+
+    closeHandlers(handlers, mode, timeout);
+}
+
 /**
 * @include socket.inline.h
 */
@@ -23,10 +23,180 @@
 #define __NL_SOCKET
 
 #include "core.h"
+#include "latency.h"
+#include "resolver.h"
 
 
 NL_NAMESPACE
 
+/**
+* @struct ConnectOptions socket.h netlink/socket.h
+*
+* Options for the connection establishment of TCP CLIENT sockets
+*/
+
+struct ConnectOptions {
+
+    unsigned        timeout;        /**< Milisecs to wait for the connection to be established. 0 waits as long as the OS does*/
+    unsigned        attemptDelay;   /**< Milisecs to wait for an attempt before also trying the next address*/
+    vector<string>  hostsFrom;      /**< Local addresses to connect from, taken in turns (round-robin) by each connection. Empty lets the OS choose*/
+    unsigned        portFrom;       /**< Local port to connect from. 0 lets the OS choose*/
+
+    ConnectOptions();
+};
+
+
+/**
+* @struct ConnectTarget socket.h netlink/socket.h
+*
+* A remote address for Socket::connectMany()
+*/
+
+struct ConnectTarget {
+
+    string      hostTo;     /**< The target/remote host*/
+    unsigned    portTo;     /**< The target/remote port*/
+    IPVer       ipVer;      /**< The IP version to be used (IP4, IP6 or ANY)*/
+
+    ConnectTarget(const string& hostTo, unsigned portTo, IPVer ipVer = ANY);
+};
+
+
+class Socket;
+
+
+/**
+* @struct ConnectResult socket.h netlink/socket.h
+*
+* The outcome of connecting to one ConnectTarget with Socket::connectMany()
+*/
+
+struct ConnectResult {
+
+    Socket*     socket;     /**< The connected socket, NULL if the connection failed*/
+    Exception   error;      /**< Why the connection failed, when socket is NULL*/
+
+    ConnectResult();
+};
+
+
+/**
+* @struct FrameFormat socket.h netlink/socket.h
+*
+* How Socket::sendFrame() and SmartBuffer::nextFrame() delimit messages in a TCP stream:
+* each one goes after a prefix with its length
+*/
+
+struct FrameFormat {
+
+    unsigned char   prefixSize;     /**< Bytes of the length prefix: 1, 2 or 4*/
+    bool            littleEndian;   /**< Byte order of the prefix, big endian (network order) if false*/
+    unsigned        maxSize;        /**< Largest frame accepted, not counting the prefix*/
+
+    FrameFormat();
+
+    void prefix(size_t size, unsigned char* prefix) const;
+    size_t frameSize(const unsigned char* prefix) const;
+};
+
+
+/**
+* @struct IOResult socket.h netlink/socket.h
+*
+* The outcome of a try* operation of Socket. Filled in without allocating, so non-blocking
+* loops can handle would-block with a branch instead of catching an Exception.
+*/
+
+struct IOResult {
+
+    IOStatus    status;     /**< What happened*/
+    size_t      size;       /**< Bytes read or sent, also when only part of the data was sent*/
+    int         error;      /**< The native error code when status is IO_ERROR, 0 otherwise*/
+};
+
+
+/**
+* @struct SocketStats socket.h netlink/socket.h
+*
+* Counters of the I/O of a Socket (Socket::stats()) or of all of them (Socket::processStats()).
+* Messages are datagrams for UDP and the calls to the OS that moved data for TCP.
+*/
+
+struct SocketStats {
+
+    unsigned long long  bytesSent;          /**< Bytes sent*/
+    unsigned long long  bytesReceived;      /**< Bytes received*/
+    unsigned long long  messagesSent;       /**< Datagrams, or successful sends for TCP*/
+    unsigned long long  messagesReceived;   /**< Datagrams, or reads that returned data for TCP*/
+    unsigned long long  syscalls;           /**< Calls to the OS to send, receive or accept*/
+    unsigned long long  wouldBlock;         /**< Calls that failed as the non-blocking socket was not ready*/
+    unsigned long long  partialSends;       /**< Sends that took only part of the data*/
+    unsigned long long  accepts;            /**< Connections accepted*/
+    unsigned long long  errors;             /**< Calls that failed, besides would-block ones*/
+    unsigned long long  drops;              /**< Datagrams the OS dropped for a full receive buffer, once dropCounting()*/
+
+    SocketStats();
+};
+
+
+/**
+* @struct TcpInfo socket.h netlink/socket.h
+*
+* What the OS knows of a TCP connection (struct tcp_info of Linux), from Socket::tcpInfo()
+*/
+
+struct TcpInfo {
+
+    unsigned    state;              /**< TCP state, as the TCP_* of the kernel (1 is ESTABLISHED)*/
+    unsigned    caState;            /**< Congestion avoidance state (0 Open, 1 Disorder, 2 CWR, 3 Recovery, 4 Loss)*/
+    unsigned    retransmits;        /**< Retransmissions of the current timeout*/
+    unsigned    probes;             /**< Zero window probes sent unanswered*/
+    unsigned    backoff;            /**< Exponential backoff of the retransmission timeout*/
+    unsigned    rto;                /**< Retransmission timeout, microseconds*/
+    unsigned    ato;                /**< Delayed acknowledgement timeout, microseconds*/
+    unsigned    sndMss;             /**< Maximum segment size sent*/
+    unsigned    rcvMss;             /**< Maximum segment size received*/
+    unsigned    unacked;            /**< Segments sent and not acknowledged yet*/
+    unsigned    sacked;             /**< Segments selectively acknowledged*/
+    unsigned    lost;               /**< Segments considered lost*/
+    unsigned    retrans;            /**< Segments retransmitted and not acknowledged yet*/
+    unsigned    lastDataSent;       /**< Milisecs since data was last sent*/
+    unsigned    lastDataReceived;   /**< Milisecs since data was last received*/
+    unsigned    lastAckReceived;    /**< Milisecs since an acknowledgement was last received*/
+    unsigned    pmtu;               /**< Path MTU*/
+    unsigned    rcvSsthresh;        /**< Receive window clamp*/
+    unsigned    rtt;                /**< Smoothed round trip time, microseconds*/
+    unsigned    rttVar;             /**< Round trip time variance, microseconds*/
+    unsigned    sndSsthresh;        /**< Slow start threshold, segments*/
+    unsigned    sndCwnd;            /**< Congestion window, segments*/
+    unsigned    advMss;             /**< Maximum segment size advertised*/
+    unsigned    reordering;         /**< Reordering the connection tolerates, segments*/
+    unsigned    rcvRtt;             /**< Round trip time measured by the receiver, microseconds*/
+    unsigned    rcvSpace;           /**< Receive buffer space the window grows to*/
+    unsigned    totalRetrans;       /**< Segments retransmitted over the connection*/
+};
+
+
+/**
+* @struct SocketMemory socket.h netlink/socket.h
+*
+* Memory the OS has for a socket (SO_MEMINFO of Linux), from Socket::memoryInfo(), in bytes
+*/
+
+struct SocketMemory {
+
+    unsigned    receiveAllocated;   /**< Taken by received data not read yet*/
+    unsigned    receiveBuffer;      /**< Limit of receiveAllocated (SO_RCVBUF)*/
+    unsigned    sendAllocated;      /**< Taken by sent data the network has not taken yet*/
+    unsigned    sendBuffer;         /**< Limit of the data queued to be sent (SO_SNDBUF)*/
+    unsigned    forwardAllocated;   /**< Reserved ahead for later data*/
+    unsigned    sendQueued;         /**< Taken by data queued to be sent, TCP keeping it until acknowledged*/
+    unsigned    optionMemory;       /**< Taken by socket options and control data*/
+    unsigned    backlog;            /**< Taken by data received while the socket was in use*/
+    unsigned    drops;              /**< Packets dropped for the socket*/
+};
+
+
 /**
 * @class Socket socket.h netlink/socket.h
 *
@@ -40,61 +210,149 @@ class Socket {
 
     private:
 
-        string      _hostTo;
-        string      _hostFrom;
-        unsigned    _portTo;
-        unsigned    _portFrom;
-        Protocol    _protocol;
-        IPVer       _ipVer;
-        SocketType  _type;
-        bool        _blocking;
-        unsigned    _listenQueue;
+        // kept small, as a process may hold many thousands of them: each host is stored
+        // once, the name given by the user or the binary address. The enums are bit fields
+        // (unsigned ones, as MSVC makes enum bit fields signed).
+
+        string          _host;              // hostTo of CLIENT sockets and hostFrom of SERVER ones, as given (the path of AF_UNIX ones)
+        unsigned char   _address[16];       // the other host, when known: the IPv4 or IPv6 address in network order
+
+        int             _socketHandler;
+        unsigned short  _portTo;
+        unsigned short  _portFrom;
 
-        int         _socketHandler;
+        unsigned        _listenQueue    : 22;
+        unsigned        _protocol       : 1;
+        unsigned        _ipVer          : 2;
+        unsigned        _type           : 1;
+        unsigned        _blocking       : 1;
+        unsigned        _hasAddressTo   : 1;    // _address is hostTo (accepted sockets and connected UDP SERVER ones)
+        unsigned        _hasAddressFrom : 1;    // _address is hostFrom (CLIENT sockets bound to a local address)
+        unsigned        _local          : 1;    // AF_UNIX socket, TCP meaning a stream one and UDP a datagram one
+        unsigned        _ownsPath       : 1;    // bound by unixServer() to _host, a file to remove on disconnection
+        unsigned        _zeroCopy       : 1;    // SO_ZEROCOPY set, so sendZeroCopy() does not copy large sends
+
+        SocketStats     _stats;             // plain counters, a Socket is used by one thread at a time
+        LatencyHistogram* _latency;         // one per LatencyOp while latencyTracking(), NULL otherwise
+
+        friend class SmartBuffer;           // reads from _socketHandler directly, and counts it
 
 
     public:
 
         Socket(const string& hostTo, unsigned portTo, Protocol protocol = TCP, IPVer ipVer = ANY);
 
+        Socket(const string& hostTo, unsigned portTo, const ConnectOptions& options, IPVer ipVer = ANY);
+
         Socket(unsigned portFrom, Protocol protocol = TCP, IPVer ipVer = IP4, const string& hostFrom = "", unsigned listenQueue = DEFAULT_LISTEN_QUEUE);
 
         Socket(const string& hostTo, unsigned portTo, unsigned portFrom, IPVer ipVer = ANY);
 
+        Socket(Socket&& socket);
+
         ~Socket();
 
 
+        static void connectMany(const vector<ConnectTarget>& targets, vector<ConnectResult>& results,
+                                const ConnectOptions& options = ConnectOptions());
+
+        static Socket* unixClient(const string& pathTo, Protocol protocol = TCP);
+        static Socket* unixServer(const string& pathFrom, Protocol protocol = TCP, unsigned listenQueue = DEFAULT_LISTEN_QUEUE);
+        static void unixPair(Socket** first, Socket** second, Protocol protocol = TCP);
+
+        static Socket* fromHandler(int socketHandler);
+        int release();
+
         Socket* accept();
+        IOResult tryAccept(Socket** accepted);
 
         int read(void* buffer, size_t bufferSize);
         void send(const void* buffer, size_t size);
 
+        IOResult tryRead(void* buffer, size_t bufferSize);
+        IOResult trySend(const void* buffer, size_t size);
+        IOResult trySendTo(const void* buffer, size_t size, const string& hostTo, unsigned portTo);
+
+        void connectTo(const string& hostTo, unsigned portTo);
+
+        void sendSegments(const void* buffer, size_t size, unsigned segmentSize);
+        void sendSegmentsTo(const void* buffer, size_t size, unsigned segmentSize, const string& hostTo, unsigned portTo);
+        int readSegments(void* buffer, size_t bufferSize, unsigned* segmentSize, string* hostFrom = NULL, unsigned* portFrom = NULL);
+
         int readFrom(void* buffer, size_t bufferSize, string* HostFrom, unsigned* portFrom = NULL);
+        int readTimestamped(void* buffer, size_t bufferSize, unsigned long long* arrival,
+                            string* hostFrom = NULL, unsigned* portFrom = NULL);
         void sendTo(const void* buffer, size_t size, const string& hostTo, unsigned portTo);
 
+        void sendFrame(const void* buffer, size_t size, const FrameFormat& format = FrameFormat());
+
+        void sendZeroCopy(const void* buffer, size_t size, unsigned* notifications);
+        bool readZeroCopyCompletion(unsigned* first, unsigned* last, bool* copied = NULL);
+
+        void sendFd(int fd);
+        void sendFd(Socket& socket);
+        int receiveFd();
+
         int nextReadSize() const;
 
-        void disconnect();
+        bool tcpInfo(TcpInfo* info) const;
+        bool memoryInfo(SocketMemory* memory) const;
+
+        void disconnect(DisconnectMode mode = CLOSE, unsigned timeout = DEFAULT_DISCONNECT_TIMEOUT);
 
-        const string&   hostTo() const;
-        const string&   hostFrom() const;
+        static void disconnectAll(const vector<Socket*>& sockets, DisconnectMode mode = CLOSE,
+                                    unsigned timeout = DEFAULT_DISCONNECT_TIMEOUT);
+
+        string          hostTo() const;
+        string          hostFrom() const;
         unsigned        portTo() const;
         unsigned        portFrom() const;
         Protocol        protocol() const;
         IPVer           ipVer() const;
         SocketType      type() const;
         bool            blocking() const;
+        bool            dropCounting() const;
+        bool            local() const;
+        bool            receiveOffload() const;
+        bool            receiveTimestamps() const;
+        bool            zeroCopy() const;
         unsigned        listenQueue() const;
         int             socketHandler() const;
+        const SocketStats& stats() const;
+        bool            latencyTracking() const;
+        const LatencyHistogram* latency(LatencyOp op) const;
+
+        static SocketStats processStats();
+        static const LatencyHistogram& processLatency(LatencyOp op);
+        static void resetProcessLatency();
 
 
         void blocking(bool blocking);
+        void dropCounting(bool enable);
+        void receiveOffload(bool enable);
+        void receiveTimestamps(bool enable);
+        void zeroCopy(bool enable);
+        void latencyTracking(bool enable);
 
 
     private:
 
-        void initSocket();
+        void initSocket(const ConnectOptions& options = ConnectOptions());
+        void connectSocket(vector<Address>& addresses, const ConnectOptions& options);
+        void connectDatagram(const string& hostTo, unsigned portTo, Address& address);
+        void address(const struct sockaddr* addr, bool isHostTo);
+        string address() const;
+        void removePath() const;
+        void sendSegmented(const char* buffer, size_t size, unsigned segmentSize, const Address* address);
+        void countRead(long status, unsigned messages = 1);
+        void countSend(long status, size_t size, unsigned messages = 1);
+        void countAccept(int socketHandler);
+        void countDrops(unsigned long long drops);
+        unsigned long long latencyStart() const;
+        void latencyEnd(LatencyOp op, unsigned long long start);
+        static Socket* unixSocket(int socketHandler, const string& path, Protocol protocol, SocketType type);
         Socket();
+        Socket(const Socket&);
 
 };
 
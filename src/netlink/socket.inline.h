@@ -24,29 +24,6 @@
     NL_NAMESPACE
 #endif
 
-/**
-* Returns the target host of the socket
-*
-* @return the host this socket is connected to (in TCP
-* case) or the host it sends data to (UDP case)
-*/
-
-inline const string& Socket::hostTo() const {
-
-    return _hostTo;
-}
-
-/**
-* Returns the socket local address
-*
-* @return socket local address
-*/
-
-inline const string& Socket::hostFrom() const {
-
-    return _hostFrom;
-}
-
 /**
 * Returns the port this socket is connected/sends to
 *
@@ -76,7 +53,7 @@ inline unsigned Socket::portFrom() const {
 
 inline Protocol Socket::protocol() const {
 
-    return _protocol;
+    return (Protocol)_protocol;
 }
 
 /**
@@ -86,7 +63,7 @@ inline Protocol Socket::protocol() const {
 
 inline IPVer Socket::ipVer() const {
 
-    return _ipVer;
+    return (IPVer)_ipVer;
 }
 
 /**
@@ -96,7 +73,7 @@ inline IPVer Socket::ipVer() const {
 
 inline SocketType Socket::type() const {
 
-    return _type;
+    return (SocketType)_type;
 }
 
 /**
@@ -123,6 +100,69 @@ inline bool Socket::blocking() const {
     return _blocking;
 }
 
+/**
+* Returns whether the socket is an AF_UNIX (local) one, whose hostTo and hostFrom are
+* paths and ports are 0
+*
+* @return true for AF_UNIX sockets
+*/
+
+inline bool Socket::local() const {
+
+    return _local;
+}
+
+
+/**
+* Returns whether large sends of sendZeroCopy() skip the copy to the kernel
+*
+* @return true if SO_ZEROCOPY is enabled
+*/
+
+inline bool Socket::zeroCopy() const {
+
+    return _zeroCopy;
+}
+
+
+/**
+* Returns the counters of the I/O of this socket
+*
+* They keep their values after disconnection.
+*
+* @return the counters since the socket was created
+*/
+
+inline const SocketStats& Socket::stats() const {
+
+    return _stats;
+}
+
+
+/**
+* Returns whether the latency of the blocking calls of this socket is recorded
+*
+* @return true if it is
+*/
+
+inline bool Socket::latencyTracking() const {
+
+    return _latency != NULL;
+}
+
+
+/**
+* Returns the latencies of a blocking operation of this socket
+*
+* @param op the operation
+* @return the histogram of its durations, NULL if latencyTracking() is disabled
+*/
+
+inline const LatencyHistogram* Socket::latency(LatencyOp op) const {
+
+    return _latency ? &_latency[op] : NULL;
+}
+
 
 /**
 * Returns the socket handler (file/socket descriptor)
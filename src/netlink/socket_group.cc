@@ -20,16 +20,30 @@
 */
 
 #include "socket_group.h"
+#include "probes.h"
 
 NL_NAMESPACE_USE
 
 
+#ifdef OS_WIN32
+
+    static int poll(struct pollfd* fds, unsigned long count, int timeout) {
+        return WSAPoll(fds, count, timeout);
+    }
+
+#endif
+
+
 ; // <-- this is for doxygen not to get confused by NL_NAMESPACE_USE
 /**
 * SocketGroup constructor
+*
+* @param backend How listen() waits for the sockets: GROUP_SELECT by default, GROUP_POLL for
+*   groups of more sockets than select() takes
 */
 
-SocketGroup::SocketGroup(): _cmdOnAccept(NULL), _cmdOnRead(NULL), _cmdOnDisconnect(NULL) {}
+SocketGroup::SocketGroup(GroupBackend backend): _cmdOnAccept(NULL), _cmdOnRead(NULL), _cmdOnDisconnect(NULL),
+                            _backend(backend) {}
 
 
 /**
@@ -46,6 +60,7 @@ void SocketGroup::remove(Socket* socket) {
 
     while(it != _vSocket.end())
         if(*it == socket) {
+            unready(socket);
             _vSocket.erase(it);
             return;
         }
@@ -54,6 +69,56 @@ void SocketGroup::remove(Socket* socket) {
 }
 
 
+/*
+* Keeps a socket removed by a callback of listen() from being dispatched after, as it may
+* be gone by then
+*/
+
+void SocketGroup::unready(Socket* socket) {
+
+    for(unsigned i=0; i < _ready.size(); i++)
+        if(_ready[i] == socket) {
+            _ready[i] = NULL;
+            return;
+        }
+}
+
+
+/**
+* Takes a snapshot of the diagnostics of every socket of the group
+*
+* Their counters, and what the OS knows of their memory and TCP connections, in one call. Those
+* already disconnected only have their counters.
+*
+* @param[out] snapshot Here the function will store the diagnostics, one per socket in the
+*   order of the group, replacing what it had
+*/
+
+void SocketGroup::diagnostics(vector<SocketDiagnostics>* snapshot) const {
+
+    snapshot->resize(_vSocket.size());
+
+    for(unsigned i=0; i < _vSocket.size(); i++) {
+
+        Socket* socket = _vSocket[i];
+        SocketDiagnostics& diagnostics = (*snapshot)[i];
+
+        diagnostics.socket = socket;
+        diagnostics.stats = socket->stats();
+        diagnostics.hasMemory = false;
+        diagnostics.hasTcpInfo = false;
+
+        if(socket->socketHandler() == -1)
+            continue;
+
+        diagnostics.hasMemory = socket->memoryInfo(&diagnostics.memory);
+
+        if(socket->protocol() == TCP && socket->type() == CLIENT && !socket->local())
+            diagnostics.hasTcpInfo = socket->tcpInfo(&diagnostics.tcpInfo);
+    }
+}
+
+
 /**
 * Listens for incoming data/connections
 *
@@ -67,7 +132,7 @@ void SocketGroup::remove(Socket* socket) {
 * @param reference A pointer which can be passed to the callback functions so they have a context.
 * By default NULL
 * @return false if there were no incoming data, true otherwise
-* @throw Exception ERROR_SELECT
+* @throw Exception ERROR_SELECT, also for GROUP_SELECT groups with sockets select() can not take
 */
 
 
@@ -81,55 +146,44 @@ bool SocketGroup::listen(unsigned milisec, void* reference) {
 
         executedOnce = true;
 
-        fd_set setSockets;
-        int maxHandle = 0;
-
-        FD_ZERO(&setSockets);
-
-        for(unsigned i=0; i < _vSocket.size(); i++) {
-            FD_SET(_vSocket[i]->socketHandler(), &setSockets);
-            maxHandle = iMax(maxHandle, _vSocket[i]->socketHandler());
-        }
-
-        unsigned long long milisecLeft = finTime - getTime();
-        struct timeval timeout;
+        unsigned long long now = getTime();
+        unsigned long long milisecLeft = finTime > now ? finTime - now : 0;
 
-        timeout.tv_sec = milisecLeft / 1000;
-        timeout.tv_usec = (milisecLeft % 1000) * 1000;
-
-        int status = select(maxHandle + 1, &setSockets, NULL, NULL, &timeout);
+        int status = _backend == GROUP_POLL ? waitPoll(milisecLeft) : waitSelect(milisecLeft);
+        NL_PROBE2(group_wakeup, _vSocket.size(), status);
 
         if (status == -1)
             throw Exception(Exception::ERROR_SELECT, "SocketGroup::listen: could not perform socket select");
 
-        unsigned i=0;
         int launchSockets = 0;
 
-        while(launchSockets < status && i < _vSocket.size()) {
+        // the callbacks may add and remove sockets, which does not change who was ready
+        for(unsigned i=0; i < _ready.size(); i++) {
 
-            if(FD_ISSET(_vSocket[i]->socketHandler(), &setSockets)) {
+            Socket* socket = _ready[i];
 
-                launchSockets++;
+            if(!socket)
+                continue;
 
-                if(_vSocket[i]->type() == SERVER && _vSocket[i]->protocol() == TCP) {
-                    if(_cmdOnAccept)
-                        _cmdOnAccept->exec(_vSocket[i], this, reference);
-                } //if
-                else {
-                    if(_vSocket[i]->protocol() == TCP && !_vSocket[i]->nextReadSize()) {
-                        if(_cmdOnDisconnect)
-                            _cmdOnDisconnect->exec(_vSocket[i], this, reference);
-                    }
+            launchSockets++;
 
-                    else if(_cmdOnRead)
-                        _cmdOnRead->exec(_vSocket[i], this, reference);
+            if(socket->type() == SERVER && socket->protocol() == TCP) {
+                if(_cmdOnAccept)
+                    _cmdOnAccept->exec(socket, this, reference);
+            } //if
+            else {
+                if(socket->protocol() == TCP && !socket->nextReadSize()) {
+                    if(_cmdOnDisconnect)
+                        _cmdOnDisconnect->exec(socket, this, reference);
                 }
 
+                else if(_cmdOnRead)
+                    _cmdOnRead->exec(socket, this, reference);
             }
 
-            ++i;
+        } //for
 
-        } //while
+        _ready.clear();
 
         if(launchSockets)
             result = true;
@@ -140,3 +194,79 @@ bool SocketGroup::listen(unsigned milisec, void* reference) {
 
 }
 
+
+/*
+* Waits with select() for any socket of the group to be readable, marking them in _ready
+*
+* Returns the number of ready sockets, or -1 on error.
+*/
+
+int SocketGroup::waitSelect(unsigned long long milisec) {
+
+    #ifdef OS_WIN32
+        // fd_set of Windows is an array of up to FD_SETSIZE sockets
+        if(_vSocket.size() > FD_SETSIZE)
+            throw Exception(Exception::ERROR_SELECT, "SocketGroup::listen: more sockets than select can take, use GROUP_POLL");
+    #endif
+
+    fd_set setSockets;
+    int maxHandle = 0;
+
+    FD_ZERO(&setSockets);
+
+    for(unsigned i=0; i < _vSocket.size(); i++) {
+
+        #ifndef OS_WIN32
+            // a bit past the fd_set would be written out of it
+            if(_vSocket[i]->socketHandler() >= FD_SETSIZE)
+                throw Exception(Exception::ERROR_SELECT, "SocketGroup::listen: socket descriptor too big for select, use GROUP_POLL");
+        #endif
+
+        FD_SET(_vSocket[i]->socketHandler(), &setSockets);
+        maxHandle = iMax(maxHandle, _vSocket[i]->socketHandler());
+    }
+
+    struct timeval timeout;
+
+    timeout.tv_sec = milisec / 1000;
+    timeout.tv_usec = (milisec % 1000) * 1000;
+
+    int status = select(maxHandle + 1, &setSockets, NULL, NULL, &timeout);
+
+    _ready.clear();
+
+    for(unsigned i=0; status > 0 && i < _vSocket.size(); i++)
+        if(FD_ISSET(_vSocket[i]->socketHandler(), &setSockets))
+            _ready.push_back(_vSocket[i]);
+
+    return status;
+}
+
+
+/*
+* Waits with poll() for any socket of the group to be readable, marking them in _ready
+*
+* Errors and hang ups count as ready, as select() has them. Returns the number of ready sockets,
+* or -1 on error.
+*/
+
+int SocketGroup::waitPoll(unsigned long long milisec) {
+
+    _pollFds.resize(_vSocket.size());
+
+    for(unsigned i=0; i < _vSocket.size(); i++) {
+        _pollFds[i].fd = _vSocket[i]->socketHandler();
+        _pollFds[i].events = POLLIN;
+        _pollFds[i].revents = 0;
+    }
+
+    int status = poll(_pollFds.empty() ? NULL : &_pollFds[0], _pollFds.size(), milisec < 0x7FFFFFFF ? (int)milisec : 0x7FFFFFFF);
+
+    _ready.clear();
+
+    for(unsigned i=0; status > 0 && i < _vSocket.size(); i++)
+        if(_pollFds[i].revents != 0)
+            _ready.push_back(_vSocket[i]);
+
+    return status;
+}
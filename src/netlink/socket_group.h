@@ -32,6 +32,23 @@ using std::vector;
 
 class SocketGroup;
 
+
+/**
+* @struct SocketDiagnostics socket_group.h netlink/socket_group.h
+*
+* What is known of a Socket of a SocketGroup at one time, from SocketGroup::diagnostics()
+*/
+
+struct SocketDiagnostics {
+
+    Socket*         socket;         /**< The socket it is about*/
+    SocketStats     stats;          /**< Counters of its I/O*/
+    bool            hasMemory;      /**< If memory was filled in, see Socket::memoryInfo()*/
+    SocketMemory    memory;         /**< Memory the OS has for it*/
+    bool            hasTcpInfo;     /**< If tcpInfo was filled in, only for connected TCP sockets*/
+    TcpInfo         tcpInfo;        /**< What the OS knows of its connection*/
+};
+
 /**
 * @class SocketGroupCmd socket_group.h netlink/socket_group.h
 *
@@ -55,6 +72,19 @@ class SocketGroupCmd {
 };
 
 
+/**
+* @enum GroupBackend
+*
+* Defines how a SocketGroup waits for its sockets to be ready.
+*/
+
+enum GroupBackend {
+
+    GROUP_SELECT,   /**< select(): only for descriptors below FD_SETSIZE (1024 on Linux), or up to FD_SETSIZE sockets on Windows*/
+    GROUP_POLL      /**< poll(), or WSAPoll() on Windows: any number of sockets, without their descriptors limited*/
+};
+
+
 /**
 * @class SocketGroup socket_group.h netlink/socket_group.h
 *
@@ -71,9 +101,17 @@ class SocketGroup {
         SocketGroupCmd* _cmdOnRead;
         SocketGroupCmd* _cmdOnDisconnect;
 
+        GroupBackend    _backend;
+        vector<Socket*> _ready;     // the sockets the last wait found ready, in the order of _vSocket. NULL once removed
+        vector<struct pollfd> _pollFds;
+
+        int waitSelect(unsigned long long milisec);
+        int waitPoll(unsigned long long milisec);
+        void unready(Socket* socket);
+
     public:
 
-        SocketGroup();
+        SocketGroup(GroupBackend backend = GROUP_SELECT);
 
         void add(Socket* socket);
         Socket* get(unsigned index) const;
@@ -81,6 +119,9 @@ class SocketGroup {
         void remove(Socket* socket);
 
         size_t size() const;
+        GroupBackend backend() const;
+
+        void diagnostics(vector<SocketDiagnostics>* snapshot) const;
 
         void setCmdOnAccept(SocketGroupCmd* cmd);
         void setCmdOnRead(SocketGroupCmd* cmd);
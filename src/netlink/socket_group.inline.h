@@ -67,6 +67,7 @@ inline void SocketGroup::remove(unsigned index) {
     if(index >= _vSocket.size())
         throw Exception(Exception::OUT_OF_RANGE, "SocketGroup::remove: index out of range");
 
+    unready(_vSocket[index]);
     _vSocket.erase(_vSocket.begin() + index);
 }
 
@@ -81,6 +82,17 @@ inline size_t SocketGroup::size() const {
     return _vSocket.size();
 }
 
+/**
+* Returns how the group waits for its sockets
+*
+* @return The GroupBackend given to the constructor
+*/
+
+inline GroupBackend SocketGroup::backend() const {
+
+    return _backend;
+}
+
 /**
 * Sets the onAcceptReady callback
 *
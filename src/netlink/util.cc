@@ -22,6 +22,20 @@
 
 #include "util.h"
 
+#include <string.h>
+#include <chrono>
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define NL_SSE2
+    #include <emmintrin.h>
+#endif
+
 
 unsigned long long NL_NAMESPACE_NAME::getTime() {
 
@@ -43,3 +57,167 @@ unsigned long long NL_NAMESPACE_NAME::getTime() {
 
 }
 
+
+/*
+* Milliseconds from an unspecified start, which unlike getTime() never jump when the wall
+* clock is set, so differences of them measure timeouts.
+*/
+
+unsigned long long NL_NAMESPACE_NAME::getMonotonicTime() {
+
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+#if defined(__AVX2__)
+
+    typedef __m256i Vector;
+
+    #define NL_VECTOR_SIZE      32
+    #define NL_SPLAT(byte)      _mm256_set1_epi8(byte)
+    #define NL_LOAD(data)       _mm256_loadu_si256((const __m256i*)(data))
+    #define NL_EQUAL(a, b)      _mm256_cmpeq_epi8(a, b)
+    #define NL_AND(a, b)        _mm256_and_si256(a, b)
+    #define NL_OR(a, b)         _mm256_or_si256(a, b)
+    #define NL_MASK(a)          (unsigned)_mm256_movemask_epi8(a)
+
+#elif defined(NL_SSE2)
+
+    typedef __m128i Vector;
+
+    #define NL_VECTOR_SIZE      16
+    #define NL_SPLAT(byte)      _mm_set1_epi8(byte)
+    #define NL_LOAD(data)       _mm_loadu_si128((const __m128i*)(data))
+    #define NL_EQUAL(a, b)      _mm_cmpeq_epi8(a, b)
+    #define NL_AND(a, b)        _mm_and_si128(a, b)
+    #define NL_OR(a, b)         _mm_or_si128(a, b)
+    #define NL_MASK(a)          (unsigned)_mm_movemask_epi8(a)
+
+#endif
+
+
+#ifdef NL_VECTOR_SIZE
+
+/*
+* The position of the lowest bit set in mask, not 0
+*/
+
+static unsigned firstBit(unsigned mask) {
+
+    #ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return (unsigned)index;
+    #else
+        return (unsigned)__builtin_ctz(mask);
+    #endif
+}
+
+
+/*
+* The positions of a vector of data where a two byte delimiter starts, as set bytes
+*/
+
+static inline Vector pairHits(const char* data, Vector first, Vector second) {
+
+    return NL_AND(NL_EQUAL(NL_LOAD(data), first), NL_EQUAL(NL_LOAD(data + 1), second));
+}
+
+#endif
+
+
+/*
+* Finds a two byte delimiter a whole vector at a time: the bytes equal to its first byte, at
+* each position, and to its second one, at the next position, are both compared at once.
+* Four vectors are tested together while nothing is found, so a first byte that is common in
+* the data, such as the \r of \r\n in text, costs nothing more.
+* Returns where the scan stopped, with less than a vector and a byte left, if not found.
+*/
+
+static const char* findPair(const char* data, const char* end, const char* delimiter, const char** found) {
+
+    *found = NULL;
+
+    #ifdef NL_VECTOR_SIZE
+
+        const Vector first = NL_SPLAT(delimiter[0]);
+        const Vector second = NL_SPLAT(delimiter[1]);
+
+        for(; end - data > 4 * NL_VECTOR_SIZE; data += 4 * NL_VECTOR_SIZE) {
+
+            Vector hits = NL_OR(NL_OR(pairHits(data, first, second),
+                                      pairHits(data + NL_VECTOR_SIZE, first, second)),
+                                NL_OR(pairHits(data + 2 * NL_VECTOR_SIZE, first, second),
+                                      pairHits(data + 3 * NL_VECTOR_SIZE, first, second)));
+            if(NL_MASK(hits))
+                break; // in one of these vectors, found below
+        }
+
+        for(; end - data > NL_VECTOR_SIZE; data += NL_VECTOR_SIZE) {
+
+            unsigned mask = NL_MASK(pairHits(data, first, second));
+
+            if(mask) {
+                *found = data + firstBit(mask);
+                break;
+            }
+        }
+
+    #endif
+
+    return data;
+}
+
+
+/**
+* Finds the first occurrence of a delimiter in data
+*
+* Single byte delimiters are found with memchr(), vectorized by the C library. Two byte ones,
+* such as "\r\n", compare a whole SSE2 (or AVX2, when built for it) vector at a time. Longer
+* ones are looked for at each occurrence of their first byte.
+*
+* @param data The data to search
+* @param size Size of data
+* @param delimiter The delimiter to find
+* @param delimiterSize Size of delimiter, at least 1
+* @return Where the delimiter starts in data, NULL if it is not there
+*/
+
+const char* NL_NAMESPACE_NAME::findDelimiter(const char* data, size_t size, const char* delimiter, size_t delimiterSize) {
+
+    if(!delimiterSize || delimiterSize > size)
+        return NULL;
+
+    if(delimiterSize == 1)
+        return (const char*)memchr(data, delimiter[0], size);
+
+    const char* end = data + size;
+
+    if(delimiterSize == 2) {
+
+        const char* found;
+        data = findPair(data, end, delimiter, &found);
+        if(found)
+            return found;
+    }
+
+    // the last place it can start at
+    const char* last = end - delimiterSize;
+
+    while(data <= last) {
+
+        data = (const char*)memchr(data, delimiter[0], last - data + 1);
+
+        if(!data)
+            return NULL;
+
+        if(!memcmp(data + 1, delimiter + 1, delimiterSize - 1))
+            return data;
+
+        data++;
+    }
+
+    return NULL;
+}
+
@@ -30,6 +30,9 @@ NL_NAMESPACE
     unsigned uMax(unsigned a, unsigned b);
 
     unsigned long long getTime();
+    unsigned long long getMonotonicTime();
+
+    const char* findDelimiter(const char* data, size_t size, const char* delimiter, size_t delimiterSize);
 
 NL_NAMESPACE_END
 
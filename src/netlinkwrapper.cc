@@ -1,22 +1,33 @@
 #define NOMINMAX
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <cstdint>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <nan.h>
 #include <sstream>
+#include <vector>
 #include "arg_parser.h"
+#include "binding_profile.h"
 #include "get_value.h"
 #include "netlinkwrapper.h"
+#include "option_parser.h"
 #include "netlink/exception.h"
+#include "netlink/resolver.h"
+#include "netlink/socket_group.h"
 
-#define READ_SIZE 255
+#define TRY_READ_SIZE 65536
 
 v8::Persistent<v8::FunctionTemplate> NetLinkWrapper::class_socket_base;
 v8::Persistent<v8::FunctionTemplate> NetLinkWrapper::class_socket_tcp_client;
 v8::Persistent<v8::FunctionTemplate> NetLinkWrapper::class_socket_tcp_server;
 v8::Persistent<v8::FunctionTemplate> NetLinkWrapper::class_socket_udp;
+v8::Persistent<v8::FunctionTemplate> NetLinkWrapper::class_socket_unix_client;
+v8::Persistent<v8::FunctionTemplate> NetLinkWrapper::class_socket_unix_server;
+v8::Persistent<v8::FunctionTemplate> NetLinkWrapper::class_socket_unix_datagram;
+v8::Persistent<v8::Symbol> NetLinkWrapper::would_block;
 
 v8::Local<v8::String> v8_str(const char *str)
 {
@@ -33,42 +44,225 @@ v8::Local<v8::String> v8_str(const std::string &str)
     return Nan::New(str).ToLocalChecked();
 }
 
+v8::Local<v8::Value> js_error(const NL::Exception &err)
+{
+    std::stringstream ss;
+    ss << "[NetLinkSocket Error " << err.code() << "]: " << err.msg();
+
+    return v8::Exception::Error(v8_str(ss.str()));
+}
+
 void throw_js_error(NL::Exception &err)
 {
+    BindingProfiler::throwing();
+    auto isolate = v8::Isolate::GetCurrent();
+    isolate->ThrowException(js_error(err));
+}
+
+v8::Local<v8::Object> buffer_from(const NL::SmartBuffer &smart_buffer, size_t size, size_t offset = 0)
+{
+    auto buffer = Nan::NewBuffer(static_cast<std::uint32_t>(size)).ToLocalChecked();
+    smart_buffer.peek(node::Buffer::Data(buffer), size, offset);
+    BindingProfiler::copied(size, true);
+
+    return buffer;
+}
+
+v8::Local<v8::Object> copy_buffer(const char *data, size_t size)
+{
+    BindingProfiler::copied(size, true);
+    return Nan::CopyBuffer(data, static_cast<std::uint32_t>(size)).ToLocalChecked();
+}
+
+void set_arrival(v8::Local<v8::Object> object, unsigned long long arrival)
+{
+    if (!arrival)
+    {
+        return; // not stamped, so neither key is set
+    }
+
+    // the kernel stamps with the realtime clock, as does system_clock
+    auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+                   .count();
+    auto queued = std::max<long long>(now - static_cast<long long>(arrival), 0);
+
     auto isolate = v8::Isolate::GetCurrent();
+    Nan::Set(object, v8_str("arrivalNs"), v8::BigInt::NewFromUnsigned(isolate, arrival));
+    Nan::Set(object, v8_str("queuedNs"), Nan::New<v8::Number>(static_cast<double>(queued)));
+}
+
+// the counters of NL::SocketStats, as keys of js objects and as Prometheus metrics
+struct StatsField
+{
+    const char *key;
+    const char *metric;
+    const char *help;
+    unsigned long long NL::SocketStats::*value;
+};
+
+const StatsField stats_fields[] = {
+    {"bytesSent", "bytes_sent_total", "Bytes sent.", &NL::SocketStats::bytesSent},
+    {"bytesReceived", "bytes_received_total", "Bytes received.", &NL::SocketStats::bytesReceived},
+    {"messagesSent", "messages_sent_total", "Datagrams, or successful sends for TCP.", &NL::SocketStats::messagesSent},
+    {"messagesReceived", "messages_received_total", "Datagrams, or reads that returned data for TCP.", &NL::SocketStats::messagesReceived},
+    {"syscalls", "syscalls_total", "Calls to the OS to send, receive, or accept.", &NL::SocketStats::syscalls},
+    {"wouldBlock", "would_block_total", "Calls that found a non-blocking socket not ready.", &NL::SocketStats::wouldBlock},
+    {"partialSends", "partial_sends_total", "Sends that took only part of the data.", &NL::SocketStats::partialSends},
+    {"accepts", "accepts_total", "Connections accepted.", &NL::SocketStats::accepts},
+    {"errors", "errors_total", "Calls that failed, besides would-block ones.", &NL::SocketStats::errors},
+    {"drops", "drops_total", "Datagrams the OS dropped for a full receive buffer.", &NL::SocketStats::drops},
+};
+
+v8::Local<v8::Object> stats_object(const NL::SocketStats &stats)
+{
+    auto object = Nan::New<v8::Object>();
+    for (const auto &field : stats_fields)
+    {
+        Nan::Set(object, v8_str(field.key), Nan::New<v8::Number>(static_cast<double>(stats.*field.value)));
+    }
+
+    return object;
+}
+
+std::string stats_prometheus(const NL::SocketStats &stats)
+{
     std::stringstream ss;
-    ss << "[NetLinkSocket Error " << err.code() << "]: " << err.msg();
+    for (const auto &field : stats_fields)
+    {
+        ss << "# HELP netlinkwrapper_" << field.metric << " " << field.help << "\n"
+           << "# TYPE netlinkwrapper_" << field.metric << " counter\n"
+           << "netlinkwrapper_" << field.metric << " " << stats.*field.value << "\n";
+    }
 
-    auto v8_val = v8_str(ss.str());
-    isolate->ThrowException(v8::Exception::Error(v8_val));
+    return ss.str();
 }
 
-NetLinkWrapper::NetLinkWrapper(NL::Socket *socket)
+template <typename T>
+struct InfoField
 {
-    this->socket = socket;
+    const char *key;
+    unsigned T::*value;
+};
 
-    this->blocking = this->socket->blocking();
-    this->ip_version = this->socket->ipVer();
+const InfoField<NL::TcpInfo> tcp_info_fields[] = {
+    {"state", &NL::TcpInfo::state},
+    {"caState", &NL::TcpInfo::caState},
+    {"retransmits", &NL::TcpInfo::retransmits},
+    {"probes", &NL::TcpInfo::probes},
+    {"backoff", &NL::TcpInfo::backoff},
+    {"rtoUs", &NL::TcpInfo::rto},
+    {"atoUs", &NL::TcpInfo::ato},
+    {"sndMss", &NL::TcpInfo::sndMss},
+    {"rcvMss", &NL::TcpInfo::rcvMss},
+    {"unacked", &NL::TcpInfo::unacked},
+    {"sacked", &NL::TcpInfo::sacked},
+    {"lost", &NL::TcpInfo::lost},
+    {"retrans", &NL::TcpInfo::retrans},
+    {"lastDataSentMs", &NL::TcpInfo::lastDataSent},
+    {"lastDataReceivedMs", &NL::TcpInfo::lastDataReceived},
+    {"lastAckReceivedMs", &NL::TcpInfo::lastAckReceived},
+    {"pmtu", &NL::TcpInfo::pmtu},
+    {"rcvSsthresh", &NL::TcpInfo::rcvSsthresh},
+    {"rttUs", &NL::TcpInfo::rtt},
+    {"rttVarUs", &NL::TcpInfo::rttVar},
+    {"sndSsthresh", &NL::TcpInfo::sndSsthresh},
+    {"sndCwnd", &NL::TcpInfo::sndCwnd},
+    {"advMss", &NL::TcpInfo::advMss},
+    {"reordering", &NL::TcpInfo::reordering},
+    {"rcvRttUs", &NL::TcpInfo::rcvRtt},
+    {"rcvSpace", &NL::TcpInfo::rcvSpace},
+    {"totalRetrans", &NL::TcpInfo::totalRetrans},
+};
+
+const InfoField<NL::SocketMemory> memory_fields[] = {
+    {"receiveAllocated", &NL::SocketMemory::receiveAllocated},
+    {"receiveBuffer", &NL::SocketMemory::receiveBuffer},
+    {"sendAllocated", &NL::SocketMemory::sendAllocated},
+    {"sendBuffer", &NL::SocketMemory::sendBuffer},
+    {"forwardAllocated", &NL::SocketMemory::forwardAllocated},
+    {"sendQueued", &NL::SocketMemory::sendQueued},
+    {"optionMemory", &NL::SocketMemory::optionMemory},
+    {"backlog", &NL::SocketMemory::backlog},
+    {"drops", &NL::SocketMemory::drops},
+};
+
+template <typename T, std::size_t N>
+v8::Local<v8::Object> info_object(const T &info, const InfoField<T> (&fields)[N])
+{
+    auto object = Nan::New<v8::Object>();
+    for (const auto &field : fields)
+    {
+        Nan::Set(object, v8_str(field.key), Nan::New<v8::Number>(info.*field.value));
+    }
 
-    this->port_from = this->socket->portFrom();
-    this->host_from = this->socket->hostFrom();
-    this->port_to = this->socket->portTo();
-    this->host_to = this->socket->hostTo();
+    return object;
 }
 
-NetLinkWrapper::~NetLinkWrapper()
+// the names of the NL::TraceOp events in dumped traces
+const char *const trace_ops[] = {"accept", "connect", "disconnect", "read", "send"};
+
+std::string trace_json(const std::vector<NL::TraceEvent> &events)
 {
-    if (this->socket != nullptr)
+    std::stringstream ss;
+    ss << "[";
+    for (std::size_t i = 0; i < events.size(); i++)
     {
-        this->socket->disconnect();
-        delete this->socket;
-        this->socket = nullptr;
+        auto &event = events[i];
+        ss << (i ? "," : "")
+           << "{\"timeNs\":" << event.time
+           << ",\"op\":\"" << trace_ops[event.op]
+           << "\",\"fd\":" << event.fd
+           << ",\"result\":" << event.result
+           << ",\"error\":" << event.error << "}";
     }
+    ss << "]";
+
+    return ss.str();
+}
+
+// the keys of the NL::LatencyOp histograms in js objects
+const char *const latency_ops[NL::LATENCY_OPS] = {"accept", "connect", "receive", "send"};
+
+v8::Local<v8::Object> latency_object(const NL::LatencyHistogram &histogram)
+{
+    auto object = Nan::New<v8::Object>();
+    auto set = [&object](const char *key, unsigned long long value) {
+        Nan::Set(object, v8_str(key), Nan::New<v8::Number>(static_cast<double>(value)));
+    };
+
+    set("count", histogram.count());
+    set("meanNs", histogram.mean());
+    set("p50Ns", histogram.percentile(50));
+    set("p99Ns", histogram.percentile(99));
+    set("p999Ns", histogram.percentile(99.9));
+    set("maxNs", histogram.max());
+
+    return object;
+}
+
+NetLinkWrapper::NetLinkWrapper(NL::Socket &&socket) : socket(std::move(socket))
+{
+}
+
+v8::Local<v8::Object> NetLinkWrapper::new_instance(
+    v8::Persistent<v8::FunctionTemplate> &class_template,
+    NL::Socket &&socket)
+{
+    auto isolate = v8::Isolate::GetCurrent();
+    auto function_template = class_template.Get(isolate);
+    auto object_template = function_template->InstanceTemplate();
+    auto instance = Nan::NewInstance(object_template).ToLocalChecked();
+
+    auto wrapper = new NetLinkWrapper(std::move(socket));
+    wrapper->Wrap(instance);
+
+    return instance;
 }
 
 bool NetLinkWrapper::throw_if_destroyed()
 {
-    if (this->socket != nullptr)
+    if (this->socket.socketHandler() != -1)
     {
         return false;
     }
@@ -79,6 +273,103 @@ bool NetLinkWrapper::throw_if_destroyed()
     return true;
 }
 
+void NetLinkWrapper::drain_unread()
+{
+    // TCP clients need to be drained
+    // on Linux will others will throw an exception. Windows ignores it.
+    if (this->socket.protocol() == NL::Protocol::TCP && this->socket.type() == NL::SocketType::CLIENT)
+    {
+        auto size = this->socket.nextReadSize();
+        if (size > 0)
+        {
+            // we need to drain the socket. Otherwise it will hang on closing the
+            // socket if there is still data in the buffer.
+            char *buffer = new char[size + 1];
+            this->socket.read(buffer, size);
+            delete[] buffer;
+        }
+    }
+}
+
+bool NetLinkWrapper::buffer_frame(size_t *frame_size)
+{
+    if (!this->read_buffer)
+    {
+        this->read_buffer.reset(new NL::SmartBuffer());
+    }
+
+    *frame_size = 0; // until the prefix is in
+    while (!this->read_buffer->nextFrame(this->frame_format, frame_size))
+    {
+        // once the prefix is in, room for the rest so it is read in one go
+        auto whole = this->frame_format.prefixSize + *frame_size;
+        if (whole > this->read_buffer->size())
+        {
+            this->read_buffer->reserve(whole - this->read_buffer->size());
+        }
+
+        if (!this->read_buffer->read(&this->socket))
+        {
+            return false; // would block, or the server closed the connection
+        }
+    }
+
+    return true;
+}
+
+bool NetLinkWrapper::buffer_record(const std::string &delimiter, size_t max_size, size_t *record_size)
+{
+    if (!this->read_buffer)
+    {
+        this->read_buffer.reset(new NL::SmartBuffer());
+    }
+
+    size_t scanned = 0;
+    while (!this->read_buffer->find(delimiter.data(), delimiter.size(), record_size, scanned))
+    {
+        auto buffered = this->read_buffer->size();
+        if (buffered >= max_size + delimiter.size())
+        {
+            throw NL::Exception(NL::Exception::OUT_OF_RANGE, "receiveUntil: no delimiter within maxBytes");
+        }
+
+        // a delimiter can still end in what comes next
+        scanned = buffered >= delimiter.size() ? buffered - delimiter.size() + 1 : 0;
+
+        if (!this->read_buffer->read(&this->socket))
+        {
+            return false; // would block, or the server closed the connection
+        }
+    }
+
+    if (*record_size > max_size)
+    {
+        throw NL::Exception(NL::Exception::OUT_OF_RANGE, "receiveUntil: no delimiter within maxBytes");
+    }
+
+    return true;
+}
+
+void NetLinkWrapper::return_sent(
+    const v8::FunctionCallbackInfo<v8::Value> &args,
+    const NL::IOResult &result,
+    const char *error_message)
+{
+    if (result.status == NL::IO_ERROR)
+    {
+        NL::Exception err(NL::Exception::ERROR_SEND, error_message, result.error);
+        throw_js_error(err);
+    }
+    else if (result.status == NL::IO_WOULD_BLOCK && !result.size)
+    {
+        args.GetReturnValue().Set(would_block.Get(args.GetIsolate()));
+    }
+    else
+    {
+        args.GetReturnValue().Set(Nan::New<v8::Number>(static_cast<double>(result.size)));
+    }
+}
+
 void NetLinkWrapper::init(v8::Local<v8::Object> exports)
 {
     auto isolate = v8::Isolate::GetCurrent();
@@ -90,6 +381,11 @@ void NetLinkWrapper::init(v8::Local<v8::Object> exports)
     auto base_instance_template = base_template->InstanceTemplate();
     base_instance_template->SetInternalFieldCount(1);
 
+    base_instance_template->SetAccessor(
+        v8_str("fd"),
+        getter_fd,
+        setter_throw_exception);
+
     base_instance_template->SetAccessor(
         v8_str("isBlocking"),
         getter_is_blocking,
@@ -115,7 +411,23 @@ void NetLinkWrapper::init(v8::Local<v8::Object> exports)
         getter_port_from,
         setter_throw_exception);
 
+    base_instance_template->SetAccessor(
+        v8_str("stats"),
+        getter_stats,
+        setter_throw_exception);
+
+    base_instance_template->SetAccessor(
+        v8_str("isTrackingLatency"),
+        getter_is_tracking_latency,
+        setter_is_tracking_latency);
+
+    base_instance_template->SetAccessor(
+        v8_str("latency"),
+        getter_latency,
+        setter_throw_exception);
+
     NODE_SET_PROTOTYPE_METHOD(base_template, "disconnect", disconnect);
+    NODE_SET_PROTOTYPE_METHOD(base_template, "memoryInfo", memory_info);
 
     /* -- TCP Client -- */
     auto name_tcp_client = v8_str("SocketClientTCP");
@@ -133,9 +445,50 @@ void NetLinkWrapper::init(v8::Local<v8::Object> exports)
         v8_str("portTo"),
         getter_port_to,
         setter_throw_exception);
+    tcp_client_instance_template->SetAccessor(
+        v8_str("hostFrom"),
+        getter_host_from,
+        setter_throw_exception);
+
+    tcp_client_instance_template->SetAccessor(
+        v8_str("bufferedSize"),
+        getter_buffered_size,
+        setter_throw_exception);
 
+    tcp_client_instance_template->SetAccessor(
+        v8_str("isZeroCopy"),
+        getter_is_zero_copy,
+        setter_is_zero_copy);
+
+    tcp_client_instance_template->SetAccessor(
+        v8_str("isTimestamping"),
+        getter_is_timestamping,
+        setter_is_timestamping);
+
+    tcp_client_template->Set(
+        v8_str("connectMany"),
+        v8::FunctionTemplate::New(isolate, connect_many));
+    tcp_client_template->Set(
+        v8_str("fromFd"),
+        v8::FunctionTemplate::New(isolate, from_fd));
+
+    NODE_SET_PROTOTYPE_METHOD(tcp_client_template, "consume", consume);
+    NODE_SET_PROTOTYPE_METHOD(tcp_client_template, "fill", fill);
+    NODE_SET_PROTOTYPE_METHOD(tcp_client_template, "peek", peek);
+    NODE_SET_PROTOTYPE_METHOD(tcp_client_template, "pollZeroCopy", poll_zero_copy);
     NODE_SET_PROTOTYPE_METHOD(tcp_client_template, "receive", receive);
+    NODE_SET_PROTOTYPE_METHOD(tcp_client_template, "receiveAllUntil", receive_all_until);
+    NODE_SET_PROTOTYPE_METHOD(tcp_client_template, "receiveFrame", receive_frame);
+    NODE_SET_PROTOTYPE_METHOD(tcp_client_template, "receiveFrames", receive_frames);
+    NODE_SET_PROTOTYPE_METHOD(tcp_client_template, "receiveTimestamped", receive_timestamped);
+    NODE_SET_PROTOTYPE_METHOD(tcp_client_template, "receiveUntil", receive_until);
     NODE_SET_PROTOTYPE_METHOD(tcp_client_template, "send", send);
+    NODE_SET_PROTOTYPE_METHOD(tcp_client_template, "sendFrame", send_frame);
+    NODE_SET_PROTOTYPE_METHOD(tcp_client_template, "sendZeroCopy", send_zero_copy);
+    NODE_SET_PROTOTYPE_METHOD(tcp_client_template, "setFrameFormat", set_frame_format);
+    NODE_SET_PROTOTYPE_METHOD(tcp_client_template, "tcpInfo", tcp_info);
+    NODE_SET_PROTOTYPE_METHOD(tcp_client_template, "tryReceive", try_receive);
+    NODE_SET_PROTOTYPE_METHOD(tcp_client_template, "trySend", try_send);
 
     /* -- TCP Server -- */
     auto name_tcp_server = v8_str("SocketServerTCP");
@@ -151,6 +504,7 @@ void NetLinkWrapper::init(v8::Local<v8::Object> exports)
         setter_throw_exception);
 
     NODE_SET_PROTOTYPE_METHOD(tcp_server_template, "accept", accept);
+    NODE_SET_PROTOTYPE_METHOD(tcp_server_template, "tryAccept", try_accept);
 
     /* -- UDP -- */
     auto name_udp = v8_str("SocketUDP");
@@ -165,20 +519,140 @@ void NetLinkWrapper::init(v8::Local<v8::Object> exports)
         v8_str("hostFrom"),
         getter_host_from,
         setter_throw_exception);
+    udp_instance_template->SetAccessor(
+        v8_str("hostTo"),
+        getter_host_to,
+        setter_throw_exception);
+    udp_instance_template->SetAccessor(
+        v8_str("portTo"),
+        getter_port_to,
+        setter_throw_exception);
+    udp_instance_template->SetAccessor(
+        v8_str("isCountingDrops"),
+        getter_is_counting_drops,
+        setter_is_counting_drops);
+    udp_instance_template->SetAccessor(
+        v8_str("isReceiveOffload"),
+        getter_is_receive_offload,
+        setter_is_receive_offload);
+    udp_instance_template->SetAccessor(
+        v8_str("isTimestamping"),
+        getter_is_timestamping,
+        setter_is_timestamping);
 
+    NODE_SET_PROTOTYPE_METHOD(udp_template, "connect", connect_to);
+    NODE_SET_PROTOTYPE_METHOD(udp_template, "receive", receive_datagram);
     NODE_SET_PROTOTYPE_METHOD(udp_template, "receiveFrom", receive_from);
+    NODE_SET_PROTOTYPE_METHOD(udp_template, "receiveSegments", receive_segments);
+    NODE_SET_PROTOTYPE_METHOD(udp_template, "receiveTimestamped", receive_timestamped);
+    NODE_SET_PROTOTYPE_METHOD(udp_template, "send", send);
+    NODE_SET_PROTOTYPE_METHOD(udp_template, "sendSegments", send_segments);
+    NODE_SET_PROTOTYPE_METHOD(udp_template, "sendSegmentsTo", send_segments_to);
     NODE_SET_PROTOTYPE_METHOD(udp_template, "sendTo", send_to);
+    NODE_SET_PROTOTYPE_METHOD(udp_template, "tryReceive", try_receive);
+    NODE_SET_PROTOTYPE_METHOD(udp_template, "trySend", try_send);
+    NODE_SET_PROTOTYPE_METHOD(udp_template, "trySendTo", try_send_to);
+
+    /* -- Unix Client -- */
+    auto name_unix_client = v8_str("SocketClientUnix");
+    auto unix_client_template = v8::FunctionTemplate::New(isolate, new_unix_client);
+    unix_client_template->SetClassName(name_unix_client);
+    unix_client_template->Inherit(base_template);
+    auto unix_client_instance_template = unix_client_template->InstanceTemplate();
+    unix_client_instance_template->SetInternalFieldCount(1);
+
+    unix_client_instance_template->SetAccessor(
+        v8_str("path"),
+        getter_path,
+        setter_throw_exception);
+
+    unix_client_instance_template->SetAccessor(
+        v8_str("bufferedSize"),
+        getter_buffered_size,
+        setter_throw_exception);
+
+    unix_client_template->Set(
+        v8_str("pair"),
+        v8::FunctionTemplate::New(isolate, unix_pair));
+
+    NODE_SET_PROTOTYPE_METHOD(unix_client_template, "consume", consume);
+    NODE_SET_PROTOTYPE_METHOD(unix_client_template, "fill", fill);
+    NODE_SET_PROTOTYPE_METHOD(unix_client_template, "peek", peek);
+    NODE_SET_PROTOTYPE_METHOD(unix_client_template, "receive", receive);
+    NODE_SET_PROTOTYPE_METHOD(unix_client_template, "receiveFd", receive_fd);
+    NODE_SET_PROTOTYPE_METHOD(unix_client_template, "send", send);
+    NODE_SET_PROTOTYPE_METHOD(unix_client_template, "sendFd", send_fd);
+    NODE_SET_PROTOTYPE_METHOD(unix_client_template, "tryReceive", try_receive);
+    NODE_SET_PROTOTYPE_METHOD(unix_client_template, "trySend", try_send);
+
+    /* -- Unix Server -- */
+    auto name_unix_server = v8_str("SocketServerUnix");
+    auto unix_server_template = v8::FunctionTemplate::New(isolate, new_unix_server);
+    unix_server_template->SetClassName(name_unix_server);
+    unix_server_template->Inherit(base_template);
+    auto unix_server_instance_template = unix_server_template->InstanceTemplate();
+    unix_server_instance_template->SetInternalFieldCount(1);
+
+    unix_server_instance_template->SetAccessor(
+        v8_str("path"),
+        getter_path,
+        setter_throw_exception);
+
+    NODE_SET_PROTOTYPE_METHOD(unix_server_template, "accept", accept);
+    NODE_SET_PROTOTYPE_METHOD(unix_server_template, "tryAccept", try_accept);
+
+    /* -- Unix Datagram -- */
+    auto name_unix_datagram = v8_str("SocketUnixDatagram");
+    auto unix_datagram_template = v8::FunctionTemplate::New(isolate, new_unix_datagram);
+    unix_datagram_template->SetClassName(name_unix_datagram);
+    unix_datagram_template->Inherit(base_template);
+    auto unix_datagram_instance_template = unix_datagram_template->InstanceTemplate();
+    unix_datagram_instance_template->SetInternalFieldCount(1);
+
+    unix_datagram_instance_template->SetAccessor(
+        v8_str("path"),
+        getter_path,
+        setter_throw_exception);
+
+    NODE_SET_PROTOTYPE_METHOD(unix_datagram_template, "receiveFrom", receive_from_path);
+    NODE_SET_PROTOTYPE_METHOD(unix_datagram_template, "sendTo", send_to_path);
+    NODE_SET_PROTOTYPE_METHOD(unix_datagram_template, "trySendTo", try_send_to_path);
 
     // Actually expose them to our module's exports
     Nan::Set(exports, name_base, Nan::GetFunction(base_template).ToLocalChecked());
     Nan::Set(exports, name_tcp_client, Nan::GetFunction(tcp_client_template).ToLocalChecked());
     Nan::Set(exports, name_tcp_server, Nan::GetFunction(tcp_server_template).ToLocalChecked());
     Nan::Set(exports, name_udp, Nan::GetFunction(udp_template).ToLocalChecked());
+    Nan::Set(exports, name_unix_client, Nan::GetFunction(unix_client_template).ToLocalChecked());
+    Nan::Set(exports, name_unix_server, Nan::GetFunction(unix_server_template).ToLocalChecked());
+    Nan::Set(exports, name_unix_datagram, Nan::GetFunction(unix_datagram_template).ToLocalChecked());
+
+    /* -- Module Functions -- */
+    NODE_SET_METHOD(exports, "flushDNS", flush_dns);
+    NODE_SET_METHOD(exports, "prewarmDNS", prewarm_dns);
+    NODE_SET_METHOD(exports, "setDNSCacheTTL", set_dns_cache_ttl);
+    NODE_SET_METHOD(exports, "disconnectAll", disconnect_all);
+    NODE_SET_METHOD(exports, "dumpTrace", dump_trace);
+    NODE_SET_METHOD(exports, "getBindingProfile", get_binding_profile);
+    NODE_SET_METHOD(exports, "getDiagnostics", get_diagnostics);
+    NODE_SET_METHOD(exports, "getLatency", get_latency);
+    NODE_SET_METHOD(exports, "getStats", get_stats);
+    NODE_SET_METHOD(exports, "resetBindingProfile", reset_binding_profile);
+    NODE_SET_METHOD(exports, "resetLatency", reset_latency);
+    NODE_SET_METHOD(exports, "setBindingProfiling", set_binding_profiling);
+
+    /* -- Module Constants -- */
+    auto would_block_symbol = v8::Symbol::New(isolate, v8_str("WOULD_BLOCK"));
+    Nan::Set(exports, v8_str("WOULD_BLOCK"), would_block_symbol);
 
     class_socket_base.Reset(isolate, v8::Persistent<v8::FunctionTemplate>(isolate, base_template));
     class_socket_tcp_client.Reset(isolate, v8::Persistent<v8::FunctionTemplate>(isolate, tcp_client_template));
     class_socket_tcp_server.Reset(isolate, v8::Persistent<v8::FunctionTemplate>(isolate, tcp_server_template));
     class_socket_udp.Reset(isolate, v8::Persistent<v8::FunctionTemplate>(isolate, udp_template));
+    class_socket_unix_client.Reset(isolate, v8::Persistent<v8::FunctionTemplate>(isolate, unix_client_template));
+    class_socket_unix_server.Reset(isolate, v8::Persistent<v8::FunctionTemplate>(isolate, unix_server_template));
+    class_socket_unix_datagram.Reset(isolate, v8::Persistent<v8::FunctionTemplate>(isolate, unix_datagram_template));
+    would_block.Reset(isolate, would_block_symbol);
 }
 
 /* -- JS Constructors -- */
@@ -202,20 +676,42 @@ void NetLinkWrapper::new_tcp_client(const v8::FunctionCallbackInfo<v8::Value> &a
     std::string host;
     std::uint16_t port = 0;
     NL::IPVer ip_version = NL::IPVer::IP4;
+    v8::Local<v8::Object> options;
 
     if (ArgParser(args)
             .arg("port", port)
             .arg("host", host)
             .opt("ipVersion", ip_version)
+            .opt("options", options)
+            .isInvalid())
+    {
+        return;
+    }
+
+    NL::ConnectOptions connect_options;
+    std::uint32_t connect_timeout = connect_options.timeout;
+    std::uint32_t attempt_delay = connect_options.attemptDelay;
+
+    std::uint16_t port_from = 0;
+
+    if (OptionParser("options", options)
+            .opt("connectTimeoutMs", connect_timeout)
+            .opt("attemptDelayMs", attempt_delay)
+            .opt("hostFrom", connect_options.hostsFrom)
+            .opt("portFrom", port_from)
             .isInvalid())
     {
         return;
     }
 
-    NL::Socket *socket;
+    connect_options.timeout = connect_timeout;
+    connect_options.attemptDelay = attempt_delay;
+    connect_options.portFrom = port_from;
+
+    NetLinkWrapper *obj;
     try
     {
-        socket = new NL::Socket(host, port, NL::Protocol::TCP, ip_version);
+        obj = new NetLinkWrapper(NL::Socket(host, port, connect_options, ip_version));
     }
     catch (NL::Exception &err)
     {
@@ -223,7 +719,6 @@ void NetLinkWrapper::new_tcp_client(const v8::FunctionCallbackInfo<v8::Value> &a
         return;
     }
 
-    NetLinkWrapper *obj = new NetLinkWrapper(socket);
     obj->Wrap(args.This());
     args.GetReturnValue().Set(args.This());
 }
@@ -252,10 +747,10 @@ void NetLinkWrapper::new_udp(const v8::FunctionCallbackInfo<v8::Value> &args)
         return;
     }
 
-    NL::Socket *socket;
+    NetLinkWrapper *obj;
     try
     {
-        socket = new NL::Socket(port_from, NL::Protocol::UDP, ip_version, host_from);
+        obj = new NetLinkWrapper(NL::Socket(port_from, NL::Protocol::UDP, ip_version, host_from));
     }
     catch (NL::Exception &err)
     {
@@ -263,7 +758,6 @@ void NetLinkWrapper::new_udp(const v8::FunctionCallbackInfo<v8::Value> &args)
         return;
     }
 
-    NetLinkWrapper *obj = new NetLinkWrapper(socket);
     obj->Wrap(args.This());
     args.GetReturnValue().Set(args.This());
 }
@@ -290,10 +784,10 @@ void NetLinkWrapper::new_tcp_server(const v8::FunctionCallbackInfo<v8::Value> &a
         return;
     }
 
-    NL::Socket *socket;
+    NetLinkWrapper *obj;
     try
     {
-        socket = new NL::Socket(port_from, NL::Protocol::TCP, ip_version, host_from);
+        obj = new NetLinkWrapper(NL::Socket(port_from, NL::Protocol::TCP, ip_version, host_from));
     }
     catch (NL::Exception &err)
     {
@@ -301,25 +795,32 @@ void NetLinkWrapper::new_tcp_server(const v8::FunctionCallbackInfo<v8::Value> &a
         return;
     }
 
-    NetLinkWrapper *obj = new NetLinkWrapper(socket);
     obj->Wrap(args.This());
     args.GetReturnValue().Set(args.This());
 }
 
-/* -- JS methods -- */
-
-void NetLinkWrapper::accept(const v8::FunctionCallbackInfo<v8::Value> &args)
+void NetLinkWrapper::new_unix_client(const v8::FunctionCallbackInfo<v8::Value> &args)
 {
-    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
-    if (obj->throw_if_destroyed())
+    if (!args.IsConstructCall())
+    {
+        auto isolate = v8::Isolate::GetCurrent();
+        isolate->ThrowException(v8::Exception::Error(v8_str("SocketClientUnix constructor must be invoked via 'new'.")));
+        return;
+    }
+
+    std::string path;
+    if (ArgParser(args)
+            .arg("path", path)
+            .isInvalid())
     {
         return;
     }
 
-    NL::Socket *accepted = NULL;
+    NetLinkWrapper *obj;
     try
     {
-        accepted = obj->socket->accept();
+        std::unique_ptr<NL::Socket> socket(NL::Socket::unixClient(path));
+        obj = new NetLinkWrapper(std::move(*socket));
     }
     catch (NL::Exception &err)
     {
@@ -327,56 +828,32 @@ void NetLinkWrapper::accept(const v8::FunctionCallbackInfo<v8::Value> &args)
         return;
     }
 
-    if (accepted != NULL)
-    {
-        auto new_wrapper = new NetLinkWrapper(accepted);
-        // accept() only works on TCP servers,
-        // So we know for certain wrapped instances always must be TCP clients
-        auto isolate = v8::Isolate::GetCurrent();
-        auto function_template = NetLinkWrapper::class_socket_tcp_client.Get(isolate);
-        auto object_template = function_template->InstanceTemplate();
-        auto instance = Nan::NewInstance(object_template).ToLocalChecked();
-        new_wrapper->Wrap(instance);
-
-        args.GetReturnValue().Set(instance);
-    }
+    obj->Wrap(args.This());
+    args.GetReturnValue().Set(args.This());
 }
 
-void NetLinkWrapper::disconnect(const v8::FunctionCallbackInfo<v8::Value> &args)
+void NetLinkWrapper::new_unix_server(const v8::FunctionCallbackInfo<v8::Value> &args)
 {
-    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
-    if (obj->throw_if_destroyed())
+    if (!args.IsConstructCall())
     {
+        auto isolate = v8::Isolate::GetCurrent();
+        isolate->ThrowException(v8::Exception::Error(v8_str("SocketServerUnix constructor must be invoked via 'new'.")));
         return;
     }
 
-    try
-    {
-        // TCP clients need to be drained
-        // on Linux will others will throw an exception. Windows ignores it.
-        if (obj->socket->protocol() == NL::Protocol::TCP && obj->socket->type() == NL::SocketType::CLIENT)
-        {
-            auto size = obj->socket->nextReadSize();
-            if (size > 0)
-            {
-                // we need to drain the socket. Otherwise it will hang on closing the
-                // socket if there is still data in the buffer.
-                char *buffer = new char[size + 1];
-                obj->socket->read(buffer, size);
-                delete[] buffer;
-            }
-        }
-    }
-    catch (NL::Exception &err)
+    std::string path;
+    if (ArgParser(args)
+            .arg("path", path)
+            .isInvalid())
     {
-        throw_js_error(err);
         return;
     }
 
+    NetLinkWrapper *obj;
     try
     {
-        obj->socket->disconnect();
-        delete obj->socket;
+        std::unique_ptr<NL::Socket> socket(NL::Socket::unixServer(path));
+        obj = new NetLinkWrapper(std::move(*socket));
     }
     catch (NL::Exception &err)
     {
@@ -384,55 +861,32 @@ void NetLinkWrapper::disconnect(const v8::FunctionCallbackInfo<v8::Value> &args)
         return;
     }
 
-    obj->socket = nullptr;
+    obj->Wrap(args.This());
+    args.GetReturnValue().Set(args.This());
 }
 
-void NetLinkWrapper::receive(const v8::FunctionCallbackInfo<v8::Value> &args)
+void NetLinkWrapper::new_unix_datagram(const v8::FunctionCallbackInfo<v8::Value> &args)
 {
-    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
-    if (obj->throw_if_destroyed())
-    {
-        return;
-    }
-
-    int next_read_size = 0;
-    bool blocking = false;
-    try
-    {
-        next_read_size = obj->socket->nextReadSize();
-        blocking = obj->socket->blocking();
-    }
-    catch (NL::Exception &err)
+    if (!args.IsConstructCall())
     {
-        throw_js_error(err);
+        auto isolate = v8::Isolate::GetCurrent();
+        isolate->ThrowException(v8::Exception::Error(v8_str("SocketUnixDatagram constructor must be invoked via 'new'.")));
         return;
     }
 
-    if (next_read_size < 1 && !blocking)
+    std::string path;
+    if (ArgParser(args)
+            .opt("path", path)
+            .isInvalid())
     {
-        // we're not blocking and there is nothing to read, returning here
-        // will return undefined to the js function, as there was nothing
-        // to read.
         return;
     }
 
-    std::stringstream ss;
+    NetLinkWrapper *obj;
     try
     {
-        bool keep_reading = true;
-        while (keep_reading)
-        {
-            auto buffer = std::array<char, READ_SIZE>();
-            auto buffer_read = obj->socket->read(buffer.data(), READ_SIZE);
-            if (buffer_read > 0)
-            {
-                ss << std::string(buffer.data(), buffer_read);
-            }
-            if (buffer_read != READ_SIZE)
-            {
-                keep_reading = false;
-            }
-        }
+        std::unique_ptr<NL::Socket> socket(NL::Socket::unixServer(path, NL::Protocol::UDP));
+        obj = new NetLinkWrapper(std::move(*socket));
     }
     catch (NL::Exception &err)
     {
@@ -440,41 +894,88 @@ void NetLinkWrapper::receive(const v8::FunctionCallbackInfo<v8::Value> &args)
         return;
     }
 
-    auto str = ss.str();
-    if (str.length()) // range check
-    {
-        args.GetReturnValue().Set(Nan::CopyBuffer(str.c_str(), str.length()).ToLocalChecked());
-    }
-    // else it did not read any data, so this will return undefined
+    obj->Wrap(args.This());
+    args.GetReturnValue().Set(args.This());
 }
 
-void NetLinkWrapper::receive_from(const v8::FunctionCallbackInfo<v8::Value> &args)
+/* -- JS static methods -- */
+
+void NetLinkWrapper::connect_many(const v8::FunctionCallbackInfo<v8::Value> &args)
 {
-    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
-    if (obj->throw_if_destroyed())
+    v8::Local<v8::Array> targets_array;
+    std::uint32_t timeout = 0;
+    v8::Local<v8::Object> options;
+
+    if (ArgParser(args)
+            .arg("targets", targets_array)
+            .opt("timeoutMs", timeout)
+            .opt("options", options)
+            .isInvalid())
     {
         return;
     }
 
-    std::stringstream read_ss;
-    std::string host_from = "";
-    unsigned int port_from = 0;
-    try
+    NL::ConnectOptions connect_options;
+    std::uint32_t attempt_delay = connect_options.attemptDelay;
+
+    std::uint16_t port_from = 0;
+
+    if (OptionParser("options", options)
+            .opt("attemptDelayMs", attempt_delay)
+            .opt("hostFrom", connect_options.hostsFrom)
+            .opt("portFrom", port_from)
+            .isInvalid())
     {
-        bool keep_reading = true;
-        while (keep_reading)
-        {
-            auto buffer = std::array<char, READ_SIZE>();
-            auto buffer_read = obj->socket->readFrom(buffer.data(), READ_SIZE, &host_from, &port_from);
-            if (buffer_read > 0)
-            {
-                read_ss << std::string(buffer.data(), buffer_read);
-            }
-            if (buffer_read != READ_SIZE)
-            {
-                keep_reading = false;
-            }
+        return;
+    }
+
+    connect_options.timeout = timeout;
+    connect_options.attemptDelay = attempt_delay;
+    connect_options.portFrom = port_from;
+
+    std::vector<NL::ConnectTarget> targets;
+    targets.reserve(targets_array->Length());
+
+    for (std::uint32_t i = 0; i < targets_array->Length(); i++)
+    {
+        std::stringstream ss;
+        ss << "targets[" << i << "]";
+        auto target_name = ss.str();
+
+        v8::Local<v8::Value> element;
+        if (!Nan::Get(targets_array, i).ToLocal(&element))
+        {
+            return;
+        }
+
+        if (!element->IsObject())
+        {
+            auto isolate = v8::Isolate::GetCurrent();
+            auto message = target_name + " must be an object. " + GetValue::get_typeof_str(element);
+            isolate->ThrowException(v8::Exception::TypeError(v8_str(message)));
+            return;
+        }
+
+        std::uint16_t port = 0;
+        std::string host;
+        NL::IPVer ip_version = NL::IPVer::IP4;
+
+        if (OptionParser(target_name.c_str(), element.As<v8::Object>())
+                .arg("port", port)
+                .arg("host", host)
+                .opt("ipVersion", ip_version)
+                .isInvalid())
+        {
+            return;
         }
+
+        targets.push_back(NL::ConnectTarget(host, port, ip_version));
+    }
+
+    std::vector<NL::ConnectResult> results;
+    try
+    {
+        NL::Socket::connectMany(targets, results, connect_options);
     }
     catch (NL::Exception &err)
     {
@@ -482,114 +983,1754 @@ void NetLinkWrapper::receive_from(const v8::FunctionCallbackInfo<v8::Value> &arg
         return;
     }
 
-    auto read = read_ss.str();
-    if (host_from.length() || port_from || read.length())
+    auto socket_key = v8_str("socket");
+    auto error_key = v8_str("error");
+    auto results_array = Nan::New<v8::Array>(static_cast<int>(results.size()));
+
+    for (std::uint32_t i = 0; i < results.size(); i++)
     {
-        auto return_object = Nan::New<v8::Object>();
+        auto result = Nan::New<v8::Object>();
 
-        auto host_key = v8_str("host");
-        auto host_value = v8_str(host_from);
-        Nan::Set(return_object, host_key, host_value);
+        if (results[i].socket != NULL)
+        {
+            std::unique_ptr<NL::Socket> socket(results[i].socket);
+            auto instance = NetLinkWrapper::new_instance(
+                NetLinkWrapper::class_socket_tcp_client,
+                std::move(*socket));
+            Nan::Set(result, socket_key, instance);
+        }
+        else
+        {
+            Nan::Set(result, error_key, js_error(results[i].error));
+        }
 
-        auto port_key = v8_str("port");
-        auto port_value = Nan::New(port_from);
-        Nan::Set(return_object, port_key, port_value);
+        Nan::Set(results_array, i, result);
+    }
 
-        auto data_key = v8_str("data");
-        auto data_value = Nan::CopyBuffer(read.c_str(), read.length()).ToLocalChecked();
-        Nan::Set(return_object, data_key, data_value);
+    args.GetReturnValue().Set(results_array);
+}
 
-        args.GetReturnValue().Set(return_object);
+void NetLinkWrapper::from_fd(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    std::uint32_t fd = 0;
+    if (ArgParser(args)
+            .arg("fd", fd)
+            .isInvalid())
+    {
+        return;
+    }
+
+    std::unique_ptr<NL::Socket> socket;
+    try
+    {
+        socket.reset(NL::Socket::fromHandler(static_cast<int>(fd)));
+
+        if (socket->protocol() != NL::Protocol::TCP || socket->type() != NL::SocketType::CLIENT || socket->local())
+        {
+            // not ours to close then
+            socket->release();
+            throw NL::Exception(NL::Exception::EXPECTED_CLIENT_SOCKET, "fromFd: fd must be a connected TCP socket");
+        }
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+
+    args.GetReturnValue().Set(NetLinkWrapper::new_instance(
+        NetLinkWrapper::class_socket_tcp_client,
+        std::move(*socket)));
+}
+
+void NetLinkWrapper::unix_pair(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    NL::Socket *first = nullptr;
+    NL::Socket *second = nullptr;
+    try
+    {
+        NL::Socket::unixPair(&first, &second);
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+
+    std::unique_ptr<NL::Socket> first_socket(first);
+    std::unique_ptr<NL::Socket> second_socket(second);
+
+    auto pair = Nan::New<v8::Array>(2);
+    Nan::Set(pair, 0, NetLinkWrapper::new_instance(NetLinkWrapper::class_socket_unix_client, std::move(*first_socket)));
+    Nan::Set(pair, 1, NetLinkWrapper::new_instance(NetLinkWrapper::class_socket_unix_client, std::move(*second_socket)));
+
+    args.GetReturnValue().Set(pair);
+}
+
+/* -- JS methods -- */
+
+void NetLinkWrapper::accept(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    std::unique_ptr<NL::Socket> accepted;
+    try
+    {
+        accepted.reset(obj->socket.accept());
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+
+    if (accepted)
+    {
+        // accept() only works on TCP and Unix stream servers,
+        // So we know for certain wrapped instances always must be their clients
+        auto instance = NetLinkWrapper::new_instance(
+            accepted->local() ? NetLinkWrapper::class_socket_unix_client : NetLinkWrapper::class_socket_tcp_client,
+            std::move(*accepted));
+
+        args.GetReturnValue().Set(instance);
+    }
+}
+
+void NetLinkWrapper::connect_to(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    std::string host;
+    std::uint16_t port = 0;
+    if (ArgParser(args)
+            .arg("host", host)
+            .arg("port", port)
+            .isInvalid())
+    {
+        return;
+    }
+
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    try
+    {
+        obj->socket.connectTo(host, port);
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+}
+
+void NetLinkWrapper::disconnect(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    NL::DisconnectMode mode = NL::DisconnectMode::CLOSE;
+    std::uint32_t timeout = DEFAULT_DISCONNECT_TIMEOUT;
+    if (ArgParser(args)
+            .opt("mode", mode)
+            .opt("timeoutMs", timeout)
+            .isInvalid())
+    {
+        return;
+    }
+
+    try
+    {
+        // aborting discards the unread data anyways, and graceful reads it all
+        if (mode == NL::DisconnectMode::CLOSE)
+        {
+            obj->drain_unread();
+        }
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+
+    try
+    {
+        obj->socket.disconnect(mode, timeout);
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+
+    // the OS keeps what it still has to send on its own
+    obj->zero_copy_sends.reset();
+}
+
+void NetLinkWrapper::receive(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    BindingProfiler profiler(BindingCall::Receive, BindingPhase::Unwrap);
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    profiler.phase(BindingPhase::Native);
+
+    // data accumulated by fill() comes first
+    if (obj->read_buffer && obj->read_buffer->size())
+    {
+        profiler.phase(BindingPhase::Convert);
+        auto size = obj->read_buffer->size();
+        args.GetReturnValue().Set(buffer_from(*obj->read_buffer, size));
+        obj->read_buffer->consume(size);
+        return;
+    }
+
+    int next_read_size = 0;
+    bool blocking = false;
+    try
+    {
+        next_read_size = obj->socket.nextReadSize();
+        blocking = obj->socket.blocking();
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+
+    if (next_read_size < 1 && !blocking)
+    {
+        // we're not blocking and there is nothing to read, returning here
+        // will return undefined to the js function, as there was nothing
+        // to read.
+        return;
+    }
+
+    // shared by all the sockets of this thread, as it is emptied on each call
+    static thread_local NL::SmartBuffer scratch;
+
+    try
+    {
+        scratch.read(&obj->socket);
+    }
+    catch (NL::Exception &err)
+    {
+        scratch.clear();
+        throw_js_error(err);
+        return;
+    }
+
+    profiler.phase(BindingPhase::Convert);
+    if (scratch.size()) // range check
+    {
+        args.GetReturnValue().Set(buffer_from(scratch, scratch.size()));
+        scratch.consume(scratch.size());
     }
     // else it did not read any data, so this will return undefined
 }
 
-void NetLinkWrapper::set_blocking(const v8::FunctionCallbackInfo<v8::Value> &args)
+void NetLinkWrapper::receive_frame(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    BindingProfiler profiler(BindingCall::ReceiveFrame, BindingPhase::Unwrap);
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    profiler.phase(BindingPhase::Native);
+
+    size_t frame_size = 0;
+    try
+    {
+        if (!obj->buffer_frame(&frame_size))
+        {
+            return; // undefined, what arrived of the frame stays buffered
+        }
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+
+    profiler.phase(BindingPhase::Convert);
+    auto prefix_size = obj->frame_format.prefixSize;
+    args.GetReturnValue().Set(buffer_from(*obj->read_buffer, frame_size, prefix_size));
+    obj->read_buffer->consume(prefix_size + frame_size);
+}
+
+void NetLinkWrapper::receive_frames(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    BindingProfiler profiler(BindingCall::ReceiveFrames);
+    std::uint32_t max = std::numeric_limits<std::uint32_t>::max();
+    if (ArgParser(args)
+            .opt("max", max)
+            .isInvalid())
+    {
+        return;
+    }
+
+    profiler.phase(BindingPhase::Unwrap);
+
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    profiler.phase(BindingPhase::Native);
+
+    auto frames = Nan::New<v8::Array>();
+    size_t frame_size = 0;
+    try
+    {
+        // reads only until the first frame is whole, with all that came along
+        if (max && obj->buffer_frame(&frame_size))
+        {
+            profiler.phase(BindingPhase::Convert);
+            auto prefix_size = obj->frame_format.prefixSize;
+            std::uint32_t count = 0;
+            do
+            {
+                Nan::Set(frames, count++, buffer_from(*obj->read_buffer, frame_size, prefix_size));
+                obj->read_buffer->consume(prefix_size + frame_size);
+            } while (count < max && obj->read_buffer->nextFrame(obj->frame_format, &frame_size));
+        }
+    }
+    catch (NL::Exception &err)
+    {
+        // the frames taken before are lost with the stream
+        throw_js_error(err);
+        return;
+    }
+
+    args.GetReturnValue().Set(frames);
+}
+
+void NetLinkWrapper::receive_until(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    BindingProfiler profiler(BindingCall::ReceiveUntil);
+    std::string delimiter;
+    std::uint32_t max_bytes = DEFAULT_MAX_FRAME_SIZE;
+    if (ArgParser(args)
+            .arg("delimiter", delimiter, GetValue::SubType::SendableData)
+            .opt("maxBytes", max_bytes)
+            .isInvalid())
+    {
+        return;
+    }
+
+    if (delimiter.empty())
+    {
+        auto isolate = v8::Isolate::GetCurrent();
+        isolate->ThrowException(v8::Exception::TypeError(v8_str("Argument \"delimiter\" must not be empty.")));
+        return;
+    }
+
+    profiler.phase(BindingPhase::Unwrap);
+
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    profiler.phase(BindingPhase::Native);
+
+    size_t record_size = 0;
+    try
+    {
+        if (!obj->buffer_record(delimiter, max_bytes, &record_size))
+        {
+            return; // undefined, what arrived of the record stays buffered
+        }
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+
+    profiler.phase(BindingPhase::Convert);
+    args.GetReturnValue().Set(buffer_from(*obj->read_buffer, record_size));
+    obj->read_buffer->consume(record_size + delimiter.size());
+}
+
+void NetLinkWrapper::receive_all_until(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    BindingProfiler profiler(BindingCall::ReceiveAllUntil);
+    std::string delimiter;
+    std::uint32_t max_bytes = DEFAULT_MAX_FRAME_SIZE;
+    if (ArgParser(args)
+            .arg("delimiter", delimiter, GetValue::SubType::SendableData)
+            .opt("maxBytes", max_bytes)
+            .isInvalid())
+    {
+        return;
+    }
+
+    if (delimiter.empty())
+    {
+        auto isolate = v8::Isolate::GetCurrent();
+        isolate->ThrowException(v8::Exception::TypeError(v8_str("Argument \"delimiter\" must not be empty.")));
+        return;
+    }
+
+    profiler.phase(BindingPhase::Unwrap);
+
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    profiler.phase(BindingPhase::Native);
+
+    auto records = Nan::New<v8::Array>();
+    size_t record_size = 0;
+    try
+    {
+        // reads only until the first record is whole, with all that came along
+        if (obj->buffer_record(delimiter, max_bytes, &record_size))
+        {
+            profiler.phase(BindingPhase::Convert);
+            std::uint32_t count = 0;
+            do
+            {
+                if (record_size > max_bytes)
+                {
+                    throw NL::Exception(NL::Exception::OUT_OF_RANGE, "receiveUntil: no delimiter within maxBytes");
+                }
+
+                Nan::Set(records, count++, buffer_from(*obj->read_buffer, record_size));
+                obj->read_buffer->consume(record_size + delimiter.size());
+            } while (obj->read_buffer->find(delimiter.data(), delimiter.size(), &record_size));
+        }
+    }
+    catch (NL::Exception &err)
+    {
+        // the records taken before are lost with the stream
+        throw_js_error(err);
+        return;
+    }
+
+    args.GetReturnValue().Set(records);
+}
+
+void NetLinkWrapper::fill(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    size_t read = 0;
+    try
+    {
+        if (!obj->read_buffer)
+        {
+            obj->read_buffer.reset(new NL::SmartBuffer());
+        }
+
+        read = obj->read_buffer->read(&obj->socket);
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+
+    args.GetReturnValue().Set(Nan::New<v8::Number>(static_cast<double>(read)));
+}
+
+void NetLinkWrapper::memory_info(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    NL::SocketMemory memory;
+    if (obj->socket.memoryInfo(&memory))
+    {
+        args.GetReturnValue().Set(info_object(memory, memory_fields));
+    }
+    // else the OS does not tell, so undefined
+}
+
+void NetLinkWrapper::peek(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    size_t buffered = obj->read_buffer ? obj->read_buffer->size() : 0;
+    std::uint32_t size = std::numeric_limits<std::uint32_t>::max();
+    if (ArgParser(args)
+            .opt("size", size)
+            .isInvalid())
+    {
+        return;
+    }
+
+    if (!buffered)
+    {
+        args.GetReturnValue().Set(Nan::NewBuffer(0).ToLocalChecked());
+        return;
+    }
+
+    args.GetReturnValue().Set(buffer_from(*obj->read_buffer, std::min<size_t>(size, buffered)));
+}
+
+void NetLinkWrapper::consume(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    size_t buffered = obj->read_buffer ? obj->read_buffer->size() : 0;
+    std::uint32_t size = std::numeric_limits<std::uint32_t>::max();
+    if (ArgParser(args)
+            .opt("size", size)
+            .isInvalid())
+    {
+        return;
+    }
+
+    if (!buffered)
+    {
+        args.GetReturnValue().Set(Nan::NewBuffer(0).ToLocalChecked());
+        return;
+    }
+
+    auto consumed = std::min<size_t>(size, buffered);
+    args.GetReturnValue().Set(buffer_from(*obj->read_buffer, consumed));
+    obj->read_buffer->consume(consumed);
+}
+
+void NetLinkWrapper::receive_from(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    BindingProfiler profiler(BindingCall::ReceiveFrom, BindingPhase::Unwrap);
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    profiler.phase(BindingPhase::Native);
+
+    // one datagram per call, and none of them is bigger than this
+    static thread_local std::array<char, TRY_READ_SIZE> scratch;
+
+    std::string host_from = "";
+    unsigned int port_from = 0;
+    unsigned long long arrival = 0;
+    int read = 0;
+    try
+    {
+        read = obj->socket.readTimestamped(scratch.data(), scratch.size(), &arrival, &host_from, &port_from);
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+
+    profiler.phase(BindingPhase::Convert);
+    if (read != -1)
+    {
+        auto return_object = Nan::New<v8::Object>();
+
+        auto host_key = v8_str("host");
+        auto host_value = v8_str(host_from);
+        Nan::Set(return_object, host_key, host_value);
+
+        auto port_key = v8_str("port");
+        auto port_value = Nan::New(port_from);
+        Nan::Set(return_object, port_key, port_value);
+
+        auto data_key = v8_str("data");
+        auto data_value = copy_buffer(scratch.data(), read);
+        Nan::Set(return_object, data_key, data_value);
+
+        set_arrival(return_object, arrival);
+
+        args.GetReturnValue().Set(return_object);
+    }
+    // else it is not blocking and there was no datagram, so this will return undefined
+}
+
+void NetLinkWrapper::receive_from_path(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    // one datagram per call, sized to the pending one when it is known
+    static thread_local std::vector<char> scratch(TRY_READ_SIZE);
+
+    std::string path_from;
+    int read = 0;
+    try
+    {
+        auto pending = static_cast<size_t>(std::max(obj->socket.nextReadSize(), 0));
+        scratch.resize(std::max<size_t>(pending, TRY_READ_SIZE));
+        read = obj->socket.readFrom(scratch.data(), scratch.size(), &path_from);
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+
+    if (read != -1)
+    {
+        auto return_object = Nan::New<v8::Object>();
+
+        auto path_key = v8_str("path");
+        auto path_value = v8_str(path_from);
+        Nan::Set(return_object, path_key, path_value);
+
+        auto data_key = v8_str("data");
+        auto data_value = copy_buffer(scratch.data(), read);
+        Nan::Set(return_object, data_key, data_value);
+
+        args.GetReturnValue().Set(return_object);
+    }
+    // else it is not blocking and there was no datagram, so this will return undefined
+}
+
+void NetLinkWrapper::receive_datagram(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    // one datagram per call, and none of them is bigger than this
+    static thread_local std::array<char, TRY_READ_SIZE> scratch;
+
+    int read = 0;
+    try
+    {
+        read = obj->socket.read(scratch.data(), scratch.size());
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+
+    if (read != -1)
+    {
+        args.GetReturnValue().Set(copy_buffer(scratch.data(), read));
+    }
+    // else it is not blocking and there was no datagram, so this will return undefined
+}
+
+void NetLinkWrapper::poll_zero_copy(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    auto completed_array = Nan::New<v8::Array>();
+    args.GetReturnValue().Set(completed_array);
+
+    auto sends = obj->zero_copy_sends.get();
+    if (!sends)
+    {
+        return;
+    }
+
+    unsigned first = 0;
+    unsigned last = 0;
+    try
+    {
+        while (!sends->pending.empty() && obj->socket.readZeroCopyCompletion(&first, &last))
+        {
+            // completions can cover many sends, and arrive out of order
+            for (auto it = sends->pending.begin(); it != sends->pending.end();)
+            {
+                auto from = std::max(first, it->first);
+                auto to = std::min(last, it->last);
+                if (from <= to)
+                {
+                    it->left -= to - from + 1;
+                }
+
+                if (it->left)
+                {
+                    ++it;
+                    continue;
+                }
+
+                sends->completed.push_back(it->id);
+                it = sends->pending.erase(it);
+            }
+        }
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+
+    for (std::uint32_t i = 0; i < sends->completed.size(); i++)
+    {
+        Nan::Set(completed_array, i, Nan::New(sends->completed[i]));
+    }
+    sends->completed.clear();
+}
+
+void NetLinkWrapper::receive_segments(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    // the OS coalesces no more than 64 KiB of datagrams
+    static thread_local std::array<char, TRY_READ_SIZE> scratch;
+
+    std::string host_from;
+    unsigned int port_from = 0;
+    unsigned int segment_size = 0;
+    int read = 0;
+    try
+    {
+        read = obj->socket.readSegments(scratch.data(), scratch.size(), &segment_size, &host_from, &port_from);
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+
+    if (read != -1)
+    {
+        auto return_object = Nan::New<v8::Object>();
+
+        auto host_key = v8_str("host");
+        auto host_value = v8_str(host_from);
+        Nan::Set(return_object, host_key, host_value);
+
+        auto port_key = v8_str("port");
+        auto port_value = Nan::New(port_from);
+        Nan::Set(return_object, port_key, port_value);
+
+        auto data_key = v8_str("data");
+        auto data_value = copy_buffer(scratch.data(), read);
+        Nan::Set(return_object, data_key, data_value);
+
+        auto segment_size_key = v8_str("segmentSize");
+        auto segment_size_value = Nan::New(segment_size);
+        Nan::Set(return_object, segment_size_key, segment_size_value);
+
+        args.GetReturnValue().Set(return_object);
+    }
+    // else it is not blocking and there was no datagram, so this will return undefined
+}
+
+void NetLinkWrapper::receive_timestamped(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    // data accumulated by fill() comes first, though it is no longer known when it arrived
+    if (obj->read_buffer && obj->read_buffer->size())
+    {
+        auto size = obj->read_buffer->size();
+        auto return_object = Nan::New<v8::Object>();
+        Nan::Set(return_object, v8_str("data"), buffer_from(*obj->read_buffer, size));
+        obj->read_buffer->consume(size);
+
+        args.GetReturnValue().Set(return_object);
+        return;
+    }
+
+    // one datagram, or what TCP has for now, per call
+    static thread_local std::array<char, TRY_READ_SIZE> scratch;
+
+    unsigned long long arrival = 0;
+    int read = 0;
+    try
+    {
+        read = obj->socket.readTimestamped(scratch.data(), scratch.size(), &arrival);
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+
+    if (read == -1 || (read == 0 && obj->socket.protocol() == NL::TCP))
+    {
+        // nothing to read while not blocking, or the peer closed the
+        // connection, so this will return undefined
+        return;
+    }
+
+    auto return_object = Nan::New<v8::Object>();
+
+    auto data_key = v8_str("data");
+    auto data_value = copy_buffer(scratch.data(), read);
+    Nan::Set(return_object, data_key, data_value);
+
+    set_arrival(return_object, arrival);
+
+    args.GetReturnValue().Set(return_object);
+}
+
+void NetLinkWrapper::receive_fd(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    int fd = -1;
+    try
+    {
+        fd = obj->socket.receiveFd();
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+
+    if (fd != -1)
+    {
+        args.GetReturnValue().Set(Nan::New(fd));
+    }
+    // else it is not blocking and nothing was sent, so this will return undefined
+}
+
+void NetLinkWrapper::set_blocking(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    bool blocking = true;
+    if (ArgParser(args)
+            .arg("blocking", blocking)
+            .isInvalid())
+    {
+        return;
+    }
+
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    try
+    {
+
+        obj->socket.blocking(blocking);
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+}
+
+void NetLinkWrapper::send(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    BindingProfiler profiler(BindingCall::Send);
+    std::string data;
+    if (ArgParser(args)
+            .arg("data", data, GetValue::SubType::SendableData)
+            .isInvalid())
+    {
+        return;
+    }
+
+    profiler.phase(BindingPhase::Unwrap);
+
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    profiler.phase(BindingPhase::Native);
+
+    try
+    {
+
+        obj->socket.send(data.c_str(), data.length());
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+}
+
+void NetLinkWrapper::send_frame(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    BindingProfiler profiler(BindingCall::SendFrame);
+    std::string data;
+    if (ArgParser(args)
+            .arg("data", data, GetValue::SubType::SendableData)
+            .isInvalid())
+    {
+        return;
+    }
+
+    profiler.phase(BindingPhase::Unwrap);
+
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    profiler.phase(BindingPhase::Native);
+
+    try
+    {
+        obj->socket.sendFrame(data.c_str(), data.length(), obj->frame_format);
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+}
+
+void NetLinkWrapper::set_frame_format(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    v8::Local<v8::Object> format;
+    if (ArgParser(args)
+            .opt("format", format)
+            .isInvalid())
+    {
+        return;
+    }
+
+    NL::FrameFormat frame_format;
+    std::uint32_t prefix_bytes = frame_format.prefixSize;
+    if (OptionParser("format", format)
+            .opt("prefixBytes", prefix_bytes)
+            .opt("littleEndian", frame_format.littleEndian)
+            .opt("maxFrameSize", frame_format.maxSize)
+            .isInvalid())
+    {
+        return;
+    }
+
+    if (prefix_bytes != 1 && prefix_bytes != 2 && prefix_bytes != 4)
+    {
+        auto isolate = v8::Isolate::GetCurrent();
+        std::stringstream ss;
+        ss << "Option \"prefixBytes\" of \"format\" " << prefix_bytes << " must be 1, 2, or 4.";
+        isolate->ThrowException(v8::Exception::TypeError(v8_str(ss.str())));
+        return;
+    }
+
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    frame_format.prefixSize = static_cast<unsigned char>(prefix_bytes);
+    obj->frame_format = frame_format;
+}
+
+void NetLinkWrapper::send_to(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    BindingProfiler profiler(BindingCall::SendTo);
+    std::string host;
+    std::uint16_t port = 0;
+    std::string data;
+    if (ArgParser(args)
+            .arg("host", host)
+            .arg("port", port)
+            .arg("data", data, GetValue::SubType::SendableData)
+            .isInvalid())
+    {
+        return;
+    }
+
+    profiler.phase(BindingPhase::Unwrap);
+
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    profiler.phase(BindingPhase::Native);
+
+    try
+    {
+
+        obj->socket.sendTo(data.c_str(), data.length(), host, port);
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+}
+
+void NetLinkWrapper::try_accept(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    NL::Socket *socket = nullptr;
+    NL::IOResult result;
+    try
+    {
+        result = obj->socket.tryAccept(&socket);
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+
+    std::unique_ptr<NL::Socket> accepted(socket);
+    auto isolate = args.GetIsolate();
+    switch (result.status)
+    {
+    case NL::IO_DONE:
+        args.GetReturnValue().Set(NetLinkWrapper::new_instance(
+            accepted->local() ? NetLinkWrapper::class_socket_unix_client : NetLinkWrapper::class_socket_tcp_client,
+            std::move(*accepted)));
+        break;
+    case NL::IO_ERROR:
+    {
+        NL::Exception err(NL::Exception::ERROR_CONNECT_SOCKET, "Socket::tryAccept: could not accept a connection", result.error);
+        throw_js_error(err);
+        break;
+    }
+    default:
+        args.GetReturnValue().Set(would_block.Get(isolate));
+    }
+}
+
+void NetLinkWrapper::try_receive(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    BindingProfiler profiler(BindingCall::TryReceive, BindingPhase::Unwrap);
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    profiler.phase(BindingPhase::Native);
+
+    // data accumulated by fill() comes first
+    if (obj->read_buffer && obj->read_buffer->size())
+    {
+        profiler.phase(BindingPhase::Convert);
+        auto size = obj->read_buffer->size();
+        args.GetReturnValue().Set(buffer_from(*obj->read_buffer, size));
+        obj->read_buffer->consume(size);
+        return;
+    }
+
+    static thread_local std::array<char, TRY_READ_SIZE> scratch;
+
+    auto result = obj->socket.tryRead(scratch.data(), scratch.size());
+    profiler.phase(BindingPhase::Convert);
+    switch (result.status)
+    {
+    case NL::IO_DONE:
+        args.GetReturnValue().Set(copy_buffer(scratch.data(), result.size));
+        break;
+    case NL::IO_WOULD_BLOCK:
+        args.GetReturnValue().Set(would_block.Get(args.GetIsolate()));
+        break;
+    case NL::IO_ERROR:
+    {
+        NL::Exception err(NL::Exception::ERROR_READ, "Socket::tryRead: error detected", result.error);
+        throw_js_error(err);
+        break;
+    }
+    default:
+        break; // closed by the peer, so this will return undefined
+    }
+}
+
+void NetLinkWrapper::try_send(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    BindingProfiler profiler(BindingCall::TrySend);
+    std::string data;
+    if (ArgParser(args)
+            .arg("data", data, GetValue::SubType::SendableData)
+            .isInvalid())
+    {
+        return;
+    }
+
+    profiler.phase(BindingPhase::Unwrap);
+
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    profiler.phase(BindingPhase::Native);
+
+    NL::IOResult result;
+    try
+    {
+        result = obj->socket.trySend(data.c_str(), data.length());
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+
+    profiler.phase(BindingPhase::Convert);
+    return_sent(args, result, "Socket::trySend: could not send the data");
+}
+
+void NetLinkWrapper::try_send_to(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    BindingProfiler profiler(BindingCall::TrySendTo);
+    std::string host;
+    std::uint16_t port = 0;
+    std::string data;
+    if (ArgParser(args)
+            .arg("host", host)
+            .arg("port", port)
+            .arg("data", data, GetValue::SubType::SendableData)
+            .isInvalid())
+    {
+        return;
+    }
+
+    profiler.phase(BindingPhase::Unwrap);
+
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    profiler.phase(BindingPhase::Native);
+
+    NL::IOResult result;
+    try
+    {
+        result = obj->socket.trySendTo(data.c_str(), data.length(), host, port);
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+
+    profiler.phase(BindingPhase::Convert);
+    return_sent(args, result, "Socket::trySendTo: could not send the data");
+}
+
+void NetLinkWrapper::send_to_path(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    std::string path;
+    std::string data;
+    if (ArgParser(args)
+            .arg("path", path)
+            .arg("data", data, GetValue::SubType::SendableData)
+            .isInvalid())
+    {
+        return;
+    }
+
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    try
+    {
+        obj->socket.sendTo(data.c_str(), data.length(), path, 0);
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+}
+
+void NetLinkWrapper::send_fd(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    // a socket of ours is handed over, anything else must be a descriptor number
+    auto isolate = args.GetIsolate();
+    NetLinkWrapper *handed = nullptr;
+    std::uint32_t fd = 0;
+    if (args.Length() > 0 && NetLinkWrapper::class_socket_base.Get(isolate)->HasInstance(args[0]))
+    {
+        handed = node::ObjectWrap::Unwrap<NetLinkWrapper>(args[0].As<v8::Object>());
+        if (handed->throw_if_destroyed())
+        {
+            return;
+        }
+
+        // already out of the OS, so the receiver could never read it
+        if (handed->read_buffer && handed->read_buffer->size())
+        {
+            isolate->ThrowException(v8::Exception::Error(v8_str("Cannot sendFd a socket with buffered data, consume() it first.")));
+            return;
+        }
+    }
+    else if (ArgParser(args)
+                 .arg("fd", fd)
+                 .isInvalid())
+    {
+        return;
+    }
+
+    try
+    {
+        if (handed)
+        {
+            obj->socket.sendFd(handed->socket);
+            handed->zero_copy_sends.reset();
+        }
+        else
+        {
+            obj->socket.sendFd(static_cast<int>(fd));
+        }
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+}
+
+void NetLinkWrapper::send_zero_copy(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    v8::Local<v8::Uint8Array> data;
+    if (ArgParser(args)
+            .arg("data", data)
+            .isInvalid())
+    {
+        return;
+    }
+
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    if (!obj->zero_copy_sends)
+    {
+        obj->zero_copy_sends.reset(new ZeroCopySends());
+    }
+    auto sends = obj->zero_copy_sends.get();
+
+    Nan::TypedArrayContents<char> contents(data);
+    unsigned notifications = 0;
+    try
+    {
+        obj->socket.sendZeroCopy(*contents, contents.length(), &notifications);
+    }
+    catch (NL::Exception &err)
+    {
+        // what went out before stays in use by the OS, and numbers the notifications after
+        if (notifications)
+        {
+            sends->add_pending(args.GetIsolate(), data, notifications);
+        }
+
+        throw_js_error(err);
+        return;
+    }
+
+    std::uint32_t id;
+    if (notifications)
+    {
+        id = sends->add_pending(args.GetIsolate(), data, notifications);
+    }
+    else
+    {
+        // copied, so already done with
+        id = sends->next_id++;
+        sends->completed.push_back(id);
+    }
+
+    args.GetReturnValue().Set(Nan::New(id));
+}
+
+void NetLinkWrapper::send_segments(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    std::string data;
+    std::uint16_t segment_size = 0;
+    if (ArgParser(args)
+            .arg("data", data, GetValue::SubType::SendableData)
+            .arg("segmentSize", segment_size)
+            .isInvalid())
+    {
+        return;
+    }
+
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    try
+    {
+        obj->socket.sendSegments(data.c_str(), data.length(), segment_size);
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+}
+
+void NetLinkWrapper::send_segments_to(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    std::string host;
+    std::uint16_t port = 0;
+    std::string data;
+    std::uint16_t segment_size = 0;
+    if (ArgParser(args)
+            .arg("host", host)
+            .arg("port", port)
+            .arg("data", data, GetValue::SubType::SendableData)
+            .arg("segmentSize", segment_size)
+            .isInvalid())
+    {
+        return;
+    }
+
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    try
+    {
+        obj->socket.sendSegmentsTo(data.c_str(), data.length(), segment_size, host, port);
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+}
+
+void NetLinkWrapper::tcp_info(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    NL::TcpInfo info;
+    try
+    {
+        if (!obj->socket.tcpInfo(&info))
+        {
+            return; // the OS does not tell, so undefined
+        }
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+
+    args.GetReturnValue().Set(info_object(info, tcp_info_fields));
+}
+
+void NetLinkWrapper::try_send_to_path(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    std::string path;
+    std::string data;
+    if (ArgParser(args)
+            .arg("path", path)
+            .arg("data", data, GetValue::SubType::SendableData)
+            .isInvalid())
+    {
+        return;
+    }
+
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    NL::IOResult result;
+    try
+    {
+        result = obj->socket.trySendTo(data.c_str(), data.length(), path, 0);
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+
+    return_sent(args, result, "Socket::trySendTo: could not send the data");
+}
+
+/* -- Module Functions -- */
+
+void NetLinkWrapper::flush_dns(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    std::string host;
+    if (ArgParser(args)
+            .opt("host", host)
+            .isInvalid())
+    {
+        return;
+    }
+
+    if (host.length())
+    {
+        NL::Resolver::flush(host);
+    }
+    else
+    {
+        NL::Resolver::flush();
+    }
+}
+
+void NetLinkWrapper::prewarm_dns(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    std::string host;
+    NL::IPVer ip_version = NL::IPVer::ANY;
+    if (ArgParser(args)
+            .arg("host", host)
+            .opt("ipVersion", ip_version)
+            .isInvalid())
+    {
+        return;
+    }
+
+    std::vector<std::string> addresses;
+    try
+    {
+        NL::Resolver::prewarm(host, ip_version, &addresses);
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+
+    auto array = Nan::New<v8::Array>(static_cast<int>(addresses.size()));
+    for (std::uint32_t i = 0; i < addresses.size(); i++)
+    {
+        Nan::Set(array, i, v8_str(addresses[i]));
+    }
+
+    args.GetReturnValue().Set(array);
+}
+
+void NetLinkWrapper::set_dns_cache_ttl(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    std::uint32_t milliseconds = 0;
+    if (ArgParser(args)
+            .arg("milliseconds", milliseconds)
+            .isInvalid())
+    {
+        return;
+    }
+
+    NL::Resolver::ttl(milliseconds);
+}
+
+void NetLinkWrapper::disconnect_all(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    v8::Local<v8::Array> sockets_array;
+    NL::DisconnectMode mode = NL::DisconnectMode::CLOSE;
+    std::uint32_t timeout = DEFAULT_DISCONNECT_TIMEOUT;
+    if (ArgParser(args)
+            .arg("sockets", sockets_array)
+            .opt("mode", mode)
+            .opt("timeoutMs", timeout)
+            .isInvalid())
+    {
+        return;
+    }
+
+    auto isolate = v8::Isolate::GetCurrent();
+    auto base_template = NetLinkWrapper::class_socket_base.Get(isolate);
+
+    std::vector<NetLinkWrapper *> wrappers;
+    wrappers.reserve(sockets_array->Length());
+
+    // check them all first, so nothing is disconnected on invalid arguments
+    for (std::uint32_t i = 0; i < sockets_array->Length(); i++)
+    {
+        v8::Local<v8::Value> element;
+        if (!Nan::Get(sockets_array, i).ToLocal(&element))
+        {
+            return;
+        }
+
+        if (!base_template->HasInstance(element))
+        {
+            std::stringstream ss;
+            ss << "sockets[" << i << "] must be a socket. " << GetValue::get_typeof_str(element);
+            isolate->ThrowException(v8::Exception::TypeError(v8_str(ss.str())));
+            return;
+        }
+
+        auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(element.As<v8::Object>());
+
+        // already destroyed sockets are done with, and the same socket may be listed twice
+        if (obj->socket.socketHandler() != -1 && std::find(wrappers.begin(), wrappers.end(), obj) == wrappers.end())
+        {
+            wrappers.push_back(obj);
+        }
+    }
+
+    std::vector<NL::Socket *> sockets;
+    sockets.reserve(wrappers.size());
+
+    for (auto obj : wrappers)
+    {
+        if (mode == NL::DisconnectMode::CLOSE)
+        {
+            try
+            {
+                obj->drain_unread();
+            }
+            catch (NL::Exception &)
+            {
+                // the socket is closed regardless
+            }
+        }
+
+        sockets.push_back(&obj->socket);
+    }
+
+    NL::Socket::disconnectAll(sockets, mode, timeout);
+
+    for (auto obj : wrappers)
+    {
+        obj->zero_copy_sends.reset();
+    }
+}
+
+void NetLinkWrapper::dump_trace(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    TraceFormat format = TraceFormat::Json;
+    if (ArgParser(args)
+            .opt("format", format)
+            .isInvalid())
+    {
+        return;
+    }
+
+    static thread_local std::vector<NL::TraceEvent> events;
+    NL::FlightRecorder::snapshot(&events);
+
+    if (format == TraceFormat::Binary)
+    {
+        auto size = events.size() * sizeof(NL::TraceEvent);
+        auto buffer = Nan::CopyBuffer(reinterpret_cast<const char *>(events.data()), static_cast<std::uint32_t>(size));
+        args.GetReturnValue().Set(buffer.ToLocalChecked());
+    }
+    else
+    {
+        args.GetReturnValue().Set(v8_str(trace_json(events)));
+    }
+}
+
+void NetLinkWrapper::get_diagnostics(const v8::FunctionCallbackInfo<v8::Value> &args)
 {
-    bool blocking = true;
+    v8::Local<v8::Array> sockets_array;
     if (ArgParser(args)
-            .arg("blocking", blocking)
+            .arg("sockets", sockets_array)
             .isInvalid())
     {
         return;
     }
 
-    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
-    if (obj->throw_if_destroyed())
-    {
-        return;
-    }
+    auto isolate = v8::Isolate::GetCurrent();
+    auto base_template = NetLinkWrapper::class_socket_base.Get(isolate);
 
-    try
+    NL::SocketGroup group;
+    for (std::uint32_t i = 0; i < sockets_array->Length(); i++)
     {
+        v8::Local<v8::Value> element;
+        if (!Nan::Get(sockets_array, i).ToLocal(&element))
+        {
+            return;
+        }
 
-        obj->socket->blocking(blocking);
+        if (!base_template->HasInstance(element))
+        {
+            std::stringstream ss;
+            ss << "sockets[" << i << "] must be a socket. " << GetValue::get_typeof_str(element);
+            isolate->ThrowException(v8::Exception::TypeError(v8_str(ss.str())));
+            return;
+        }
+
+        group.add(&node::ObjectWrap::Unwrap<NetLinkWrapper>(element.As<v8::Object>())->socket);
     }
-    catch (NL::Exception &err)
+
+    static thread_local std::vector<NL::SocketDiagnostics> snapshot;
+    group.diagnostics(&snapshot);
+
+    auto return_array = Nan::New<v8::Array>(static_cast<int>(snapshot.size()));
+    for (std::uint32_t i = 0; i < snapshot.size(); i++)
     {
-        throw_js_error(err);
-        return;
+        auto &diagnostics = snapshot[i];
+        auto object = Nan::New<v8::Object>();
+        Nan::Set(object, v8_str("stats"), stats_object(diagnostics.stats));
+        if (diagnostics.hasMemory)
+        {
+            Nan::Set(object, v8_str("memory"), info_object(diagnostics.memory, memory_fields));
+        }
+        if (diagnostics.hasTcpInfo)
+        {
+            Nan::Set(object, v8_str("tcpInfo"), info_object(diagnostics.tcpInfo, tcp_info_fields));
+        }
+
+        Nan::Set(return_array, i, object);
     }
+
+    args.GetReturnValue().Set(return_array);
 }
 
-void NetLinkWrapper::send(const v8::FunctionCallbackInfo<v8::Value> &args)
+void NetLinkWrapper::get_latency(const v8::FunctionCallbackInfo<v8::Value> &args)
 {
-    std::string data;
-    if (ArgParser(args)
-            .arg("data", data, GetValue::SubType::SendableData)
-            .isInvalid())
+    auto return_object = Nan::New<v8::Object>();
+    for (unsigned op = 0; op < NL::LATENCY_OPS; ++op)
     {
-        return;
+        auto &histogram = NL::Socket::processLatency(static_cast<NL::LatencyOp>(op));
+        Nan::Set(return_object, v8_str(latency_ops[op]), latency_object(histogram));
     }
 
-    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
-    if (obj->throw_if_destroyed())
-    {
-        return;
-    }
+    args.GetReturnValue().Set(return_object);
+}
 
-    try
+void NetLinkWrapper::reset_latency(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    NL::Socket::resetProcessLatency();
+}
+
+void NetLinkWrapper::get_binding_profile(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    auto return_object = Nan::New<v8::Object>();
+    for (std::size_t call = 0; call < static_cast<std::size_t>(BindingCall::Count); call++)
     {
+        auto &profile = binding_profiles[call];
+        auto object = Nan::New<v8::Object>();
+        auto set = [&object](const char *key, const std::atomic<unsigned long long> &value) {
+            Nan::Set(object, v8_str(key), Nan::New<v8::Number>(static_cast<double>(value.load(std::memory_order_relaxed))));
+        };
+
+        set("calls", profile.calls);
+        set("allocations", profile.allocations);
+        set("bytesCopied", profile.bytes_copied);
+        for (std::size_t phase = 0; phase < static_cast<std::size_t>(BindingPhase::Count); phase++)
+        {
+            set(binding_phases[phase], profile.phase_ns[phase]);
+        }
 
-        obj->socket->send(data.c_str(), data.length());
+        Nan::Set(return_object, v8_str(binding_calls[call]), object);
     }
-    catch (NL::Exception &err)
+
+    args.GetReturnValue().Set(return_object);
+}
+
+void NetLinkWrapper::reset_binding_profile(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    for (auto &profile : binding_profiles)
     {
-        throw_js_error(err);
-        return;
+        profile.calls = 0;
+        profile.allocations = 0;
+        profile.bytes_copied = 0;
+        for (auto &phase_ns : profile.phase_ns)
+        {
+            phase_ns = 0;
+        }
     }
 }
 
-void NetLinkWrapper::send_to(const v8::FunctionCallbackInfo<v8::Value> &args)
+void NetLinkWrapper::set_binding_profiling(const v8::FunctionCallbackInfo<v8::Value> &args)
 {
-
-    std::string host;
-    std::uint16_t port = 0;
-    std::string data;
+    bool enabled = false;
     if (ArgParser(args)
-            .arg("host", host)
-            .arg("port", port)
-            .arg("data", data, GetValue::SubType::SendableData)
+            .arg("enabled", enabled)
             .isInvalid())
     {
         return;
     }
 
-    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(args.Holder());
-    if (obj->throw_if_destroyed())
+    binding_profiling = enabled;
+}
+
+void NetLinkWrapper::get_stats(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    StatsFormat format = StatsFormat::Object;
+    if (ArgParser(args)
+            .opt("format", format)
+            .isInvalid())
     {
         return;
     }
 
-    try
+    auto stats = NL::Socket::processStats();
+    if (format == StatsFormat::Prometheus)
     {
-
-        obj->socket->sendTo(data.c_str(), data.length(), host, port);
+        args.GetReturnValue().Set(v8_str(stats_prometheus(stats)));
     }
-    catch (NL::Exception &err)
+    else
     {
-        throw_js_error(err);
-        return;
+        args.GetReturnValue().Set(stats_object(stats));
     }
 }
 
@@ -601,7 +2742,7 @@ void NetLinkWrapper::getter_is_blocking(
 {
 
     auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(info.Holder());
-    info.GetReturnValue().Set(Nan::New(obj->blocking));
+    info.GetReturnValue().Set(Nan::New(obj->socket.blocking()));
 };
 
 void NetLinkWrapper::getter_is_destroyed(
@@ -609,7 +2750,7 @@ void NetLinkWrapper::getter_is_destroyed(
     const v8::PropertyCallbackInfo<v8::Value> &info)
 {
     auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(info.Holder());
-    info.GetReturnValue().Set(Nan::New(obj->socket == nullptr));
+    info.GetReturnValue().Set(Nan::New(obj->socket.socketHandler() == -1));
 };
 
 void NetLinkWrapper::getter_is_ipv4(
@@ -617,7 +2758,7 @@ void NetLinkWrapper::getter_is_ipv4(
     const v8::PropertyCallbackInfo<v8::Value> &info)
 {
     auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(info.Holder());
-    bool is_ipv4 = obj->ip_version == NL::IPVer::IP4;
+    bool is_ipv4 = obj->socket.ipVer() == NL::IPVer::IP4;
     info.GetReturnValue().Set(Nan::New(is_ipv4));
 };
 
@@ -626,16 +2767,110 @@ void NetLinkWrapper::getter_is_ipv6(
     const v8::PropertyCallbackInfo<v8::Value> &info)
 {
     auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(info.Holder());
-    bool is_ipv6 = obj->ip_version == NL::IPVer::IP6;
+    bool is_ipv6 = obj->socket.ipVer() == NL::IPVer::IP6;
     info.GetReturnValue().Set(Nan::New(is_ipv6));
 };
 
+void NetLinkWrapper::getter_is_counting_drops(
+    v8::Local<v8::String>,
+    const v8::PropertyCallbackInfo<v8::Value> &info)
+{
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(info.Holder());
+    info.GetReturnValue().Set(Nan::New(obj->socket.dropCounting()));
+};
+
+void NetLinkWrapper::getter_is_receive_offload(
+    v8::Local<v8::String>,
+    const v8::PropertyCallbackInfo<v8::Value> &info)
+{
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(info.Holder());
+    info.GetReturnValue().Set(Nan::New(obj->socket.receiveOffload()));
+};
+
+void NetLinkWrapper::getter_is_timestamping(
+    v8::Local<v8::String>,
+    const v8::PropertyCallbackInfo<v8::Value> &info)
+{
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(info.Holder());
+    info.GetReturnValue().Set(Nan::New(obj->socket.receiveTimestamps()));
+};
+
+void NetLinkWrapper::getter_is_tracking_latency(
+    v8::Local<v8::String>,
+    const v8::PropertyCallbackInfo<v8::Value> &info)
+{
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(info.Holder());
+    info.GetReturnValue().Set(Nan::New(obj->socket.latencyTracking()));
+};
+
+void NetLinkWrapper::getter_is_zero_copy(
+    v8::Local<v8::String>,
+    const v8::PropertyCallbackInfo<v8::Value> &info)
+{
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(info.Holder());
+    info.GetReturnValue().Set(Nan::New(obj->socket.zeroCopy()));
+};
+
+void NetLinkWrapper::getter_buffered_size(
+    v8::Local<v8::String>,
+    const v8::PropertyCallbackInfo<v8::Value> &info)
+{
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(info.Holder());
+    auto size = obj->read_buffer ? obj->read_buffer->size() : 0;
+    info.GetReturnValue().Set(Nan::New<v8::Number>(static_cast<double>(size)));
+};
+
+void NetLinkWrapper::getter_fd(
+    v8::Local<v8::String>,
+    const v8::PropertyCallbackInfo<v8::Value> &info)
+{
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(info.Holder());
+    info.GetReturnValue().Set(Nan::New(obj->socket.socketHandler()));
+};
+
+void NetLinkWrapper::getter_stats(
+    v8::Local<v8::String>,
+    const v8::PropertyCallbackInfo<v8::Value> &info)
+{
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(info.Holder());
+    info.GetReturnValue().Set(stats_object(obj->socket.stats()));
+};
+
+void NetLinkWrapper::getter_latency(
+    v8::Local<v8::String>,
+    const v8::PropertyCallbackInfo<v8::Value> &info)
+{
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(info.Holder());
+    if (!obj->socket.latencyTracking())
+    {
+        return; // so undefined
+    }
+
+    auto return_object = Nan::New<v8::Object>();
+    for (unsigned op = 0; op < NL::LATENCY_OPS; ++op)
+    {
+        auto histogram = obj->socket.latency(static_cast<NL::LatencyOp>(op));
+        Nan::Set(return_object, v8_str(latency_ops[op]), latency_object(*histogram));
+    }
+
+    info.GetReturnValue().Set(return_object);
+};
+
 void NetLinkWrapper::getter_host_from(
     v8::Local<v8::String>,
     const v8::PropertyCallbackInfo<v8::Value> &info)
 {
     auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(info.Holder());
-    info.GetReturnValue().Set(v8_str(obj->host_from));
+    info.GetReturnValue().Set(v8_str(obj->socket.hostFrom()));
+};
+
+void NetLinkWrapper::getter_path(
+    v8::Local<v8::String>,
+    const v8::PropertyCallbackInfo<v8::Value> &info)
+{
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(info.Holder());
+    auto &socket = obj->socket;
+    info.GetReturnValue().Set(v8_str(socket.type() == NL::SocketType::CLIENT ? socket.hostTo() : socket.hostFrom()));
 };
 
 void NetLinkWrapper::getter_host_to(
@@ -643,7 +2878,7 @@ void NetLinkWrapper::getter_host_to(
     const v8::PropertyCallbackInfo<v8::Value> &info)
 {
     auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(info.Holder());
-    info.GetReturnValue().Set(v8_str(obj->host_to));
+    info.GetReturnValue().Set(v8_str(obj->socket.hostTo()));
 };
 
 void NetLinkWrapper::getter_port_from(
@@ -651,7 +2886,7 @@ void NetLinkWrapper::getter_port_from(
     const v8::PropertyCallbackInfo<v8::Value> &info)
 {
     auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(info.Holder());
-    info.GetReturnValue().Set(Nan::New(obj->port_from));
+    info.GetReturnValue().Set(Nan::New(obj->socket.portFrom()));
 };
 
 void NetLinkWrapper::getter_port_to(
@@ -659,7 +2894,7 @@ void NetLinkWrapper::getter_port_to(
     const v8::PropertyCallbackInfo<v8::Value> &info)
 {
     auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(info.Holder());
-    info.GetReturnValue().Set(Nan::New(obj->port_to));
+    info.GetReturnValue().Set(Nan::New(obj->socket.portTo()));
 };
 
 /* -- Setters -- */
@@ -705,13 +2940,143 @@ void NetLinkWrapper::setter_is_blocking(
     try
     {
 
-        obj->socket->blocking(blocking);
+        obj->socket.blocking(blocking);
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+}
+
+void NetLinkWrapper::setter_is_counting_drops(
+    v8::Local<v8::String>,
+    v8::Local<v8::Value> value,
+    const v8::PropertyCallbackInfo<void> &info)
+{
+    if (!value->IsBoolean())
+    {
+        auto isolate = v8::Isolate::GetCurrent();
+        isolate->ThrowException(v8::Exception::Error(v8_str("Value to set \"isCountingDrops\" to must be a boolean.")));
+        return;
+    }
+
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(info.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    try
+    {
+        obj->socket.dropCounting(value->IsTrue());
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+}
+
+void NetLinkWrapper::setter_is_receive_offload(
+    v8::Local<v8::String>,
+    v8::Local<v8::Value> value,
+    const v8::PropertyCallbackInfo<void> &info)
+{
+    if (!value->IsBoolean())
+    {
+        auto isolate = v8::Isolate::GetCurrent();
+        isolate->ThrowException(v8::Exception::Error(v8_str("Value to set \"isReceiveOffload\" to must be a boolean.")));
+        return;
+    }
+
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(info.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    try
+    {
+        obj->socket.receiveOffload(value->IsTrue());
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
+}
+
+void NetLinkWrapper::setter_is_timestamping(
+    v8::Local<v8::String>,
+    v8::Local<v8::Value> value,
+    const v8::PropertyCallbackInfo<void> &info)
+{
+    if (!value->IsBoolean())
+    {
+        auto isolate = v8::Isolate::GetCurrent();
+        isolate->ThrowException(v8::Exception::Error(v8_str("Value to set \"isTimestamping\" to must be a boolean.")));
+        return;
+    }
+
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(info.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
+
+    try
+    {
+        obj->socket.receiveTimestamps(value->IsTrue());
     }
     catch (NL::Exception &err)
     {
         throw_js_error(err);
         return;
     }
+}
+
+void NetLinkWrapper::setter_is_tracking_latency(
+    v8::Local<v8::String>,
+    v8::Local<v8::Value> value,
+    const v8::PropertyCallbackInfo<void> &info)
+{
+    if (!value->IsBoolean())
+    {
+        auto isolate = v8::Isolate::GetCurrent();
+        isolate->ThrowException(v8::Exception::Error(v8_str("Value to set \"isTrackingLatency\" to must be a boolean.")));
+        return;
+    }
+
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(info.Holder());
+    obj->socket.latencyTracking(value->IsTrue());
+}
+
+void NetLinkWrapper::setter_is_zero_copy(
+    v8::Local<v8::String>,
+    v8::Local<v8::Value> value,
+    const v8::PropertyCallbackInfo<void> &info)
+{
+    if (!value->IsBoolean())
+    {
+        auto isolate = v8::Isolate::GetCurrent();
+        isolate->ThrowException(v8::Exception::Error(v8_str("Value to set \"isZeroCopy\" to must be a boolean.")));
+        return;
+    }
+
+    auto obj = node::ObjectWrap::Unwrap<NetLinkWrapper>(info.Holder());
+    if (obj->throw_if_destroyed())
+    {
+        return;
+    }
 
-    obj->blocking = blocking;
+    try
+    {
+        obj->socket.zeroCopy(value->IsTrue());
+    }
+    catch (NL::Exception &err)
+    {
+        throw_js_error(err);
+        return;
+    }
 }
@@ -2,66 +2,201 @@
 #define NETLINKOBJECT_H
 
 #include <cstdint>
+#include <deque>
+#include <memory>
 #include <node.h>
 #include <node_object_wrap.h>
 #include <string>
+#include "netlink/flight_recorder.h"
+#include "netlink/smart_buffer.h"
 #include "netlink/socket.h"
 
+// how getStats() returns the counters
+enum class StatsFormat
+{
+    Object,
+    Prometheus,
+};
+
+// how dumpTrace() exports the events
+enum class TraceFormat
+{
+    Binary,
+    Json,
+};
+
 class NetLinkWrapper : public node::ObjectWrap
 {
 public:
     static void init(v8::Local<v8::Object> exports);
 
 private:
-    NL::Socket *socket;
+    // embedded, so each connection is a single allocation. It keeps its state
+    // (for the getters) after being disconnected, which destroys it.
+    NL::Socket socket;
+
+    // where fill() accumulates received data, created on first use
+    std::unique_ptr<NL::SmartBuffer> read_buffer;
 
-    // accessed via getters, so we cache them here
-    bool blocking = true;
-    NL::IPVer ip_version;
+    // how sendFrame() and receiveFrame() delimit messages
+    NL::FrameFormat frame_format;
 
-    std::uint16_t port_from;
-    std::string host_from;
-    std::uint16_t port_to;
-    std::string host_to;
+    // a sendZeroCopy() buffer, kept alive until the OS is done reading it
+    struct ZeroCopySend
+    {
+        std::uint32_t id;
+        unsigned first; // the OS notifications of the send, first to last
+        unsigned last;
+        unsigned left; // those not completed yet
+        v8::Global<v8::Uint8Array> data;
+    };
 
-    explicit NetLinkWrapper(NL::Socket *socket);
-    ~NetLinkWrapper();
+    struct ZeroCopySends
+    {
+        std::uint32_t next_id = 0;
+        unsigned next_notification = 0;
+        std::deque<ZeroCopySend> pending;
+        std::vector<std::uint32_t> completed; // not polled yet
+
+        // keeps data alive until its notifications complete, returning the id of the send
+        std::uint32_t add_pending(v8::Isolate *isolate, v8::Local<v8::Uint8Array> data, unsigned notifications)
+        {
+            this->pending.emplace_back();
+            auto &send = this->pending.back();
+            send.id = this->next_id++;
+            send.first = this->next_notification;
+            send.last = this->next_notification + notifications - 1;
+            send.left = notifications;
+            send.data.Reset(isolate, data);
+
+            this->next_notification += notifications;
+            return send.id;
+        }
+    };
+
+    // created on the first sendZeroCopy(), and dropped on disconnection
+    std::unique_ptr<ZeroCopySends> zero_copy_sends;
+
+    explicit NetLinkWrapper(NL::Socket &&socket);
 
     bool throw_if_destroyed();
+    void drain_unread();
+    bool buffer_frame(size_t *frame_size);
+    bool buffer_record(const std::string &delimiter, size_t max_size, size_t *record_size);
+
+    static v8::Local<v8::Object> new_instance(
+        v8::Persistent<v8::FunctionTemplate> &class_template,
+        NL::Socket &&socket);
+
+    static void return_sent(
+        const v8::FunctionCallbackInfo<v8::Value> &args,
+        const NL::IOResult &result,
+        const char *error_message);
 
     static v8::Persistent<v8::FunctionTemplate> class_socket_base;
     static v8::Persistent<v8::FunctionTemplate> class_socket_tcp_client;
     static v8::Persistent<v8::FunctionTemplate> class_socket_tcp_server;
     static v8::Persistent<v8::FunctionTemplate> class_socket_udp;
+    static v8::Persistent<v8::FunctionTemplate> class_socket_unix_client;
+    static v8::Persistent<v8::FunctionTemplate> class_socket_unix_server;
+    static v8::Persistent<v8::FunctionTemplate> class_socket_unix_datagram;
+
+    // returned by the try* methods when the socket is not ready
+    static v8::Persistent<v8::Symbol> would_block;
 
     /* -- Class Constructors -- */
     static void new_base(const v8::FunctionCallbackInfo<v8::Value> &args);
     static void new_tcp_client(const v8::FunctionCallbackInfo<v8::Value> &args);
     static void new_tcp_server(const v8::FunctionCallbackInfo<v8::Value> &args);
     static void new_udp(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void new_unix_client(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void new_unix_server(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void new_unix_datagram(const v8::FunctionCallbackInfo<v8::Value> &args);
+
+    /* -- Static Methods -- */
+    static void connect_many(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void from_fd(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void unix_pair(const v8::FunctionCallbackInfo<v8::Value> &args);
 
     /* -- Methods -- */
     static void accept(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void connect_to(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void consume(const v8::FunctionCallbackInfo<v8::Value> &args);
     static void disconnect(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void fill(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void memory_info(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void peek(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void poll_zero_copy(const v8::FunctionCallbackInfo<v8::Value> &args);
     static void receive(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void receive_all_until(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void receive_datagram(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void receive_frame(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void receive_frames(const v8::FunctionCallbackInfo<v8::Value> &args);
     static void receive_from(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void receive_from_path(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void receive_segments(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void receive_timestamped(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void receive_until(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void receive_fd(const v8::FunctionCallbackInfo<v8::Value> &args);
     static void set_blocking(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void set_frame_format(const v8::FunctionCallbackInfo<v8::Value> &args);
     static void send(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void send_frame(const v8::FunctionCallbackInfo<v8::Value> &args);
     static void send_to(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void send_to_path(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void send_zero_copy(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void send_fd(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void send_segments(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void send_segments_to(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void tcp_info(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void try_accept(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void try_receive(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void try_send(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void try_send_to(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void try_send_to_path(const v8::FunctionCallbackInfo<v8::Value> &args);
+
+    /* -- Module Functions -- */
+    static void flush_dns(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void prewarm_dns(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void set_dns_cache_ttl(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void disconnect_all(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void dump_trace(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void get_binding_profile(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void get_diagnostics(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void get_latency(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void get_stats(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void reset_binding_profile(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void reset_latency(const v8::FunctionCallbackInfo<v8::Value> &args);
+    static void set_binding_profiling(const v8::FunctionCallbackInfo<v8::Value> &args);
 
     /* -- Getters -- */
+    static void getter_buffered_size(
+        v8::Local<v8::String>,
+        const v8::PropertyCallbackInfo<v8::Value> &info);
+    static void getter_fd(
+        v8::Local<v8::String>,
+        const v8::PropertyCallbackInfo<v8::Value> &info);
     static void getter_host_from(
         v8::Local<v8::String>,
         const v8::PropertyCallbackInfo<v8::Value> &info);
+    static void getter_path(
+        v8::Local<v8::String>,
+        const v8::PropertyCallbackInfo<v8::Value> &info);
     static void getter_host_to(
         v8::Local<v8::String>,
         const v8::PropertyCallbackInfo<v8::Value> &info);
+    static void getter_latency(
+        v8::Local<v8::String>,
+        const v8::PropertyCallbackInfo<v8::Value> &info);
     static void getter_port_from(
         v8::Local<v8::String>,
         const v8::PropertyCallbackInfo<v8::Value> &info);
     static void getter_port_to(
         v8::Local<v8::String>,
         const v8::PropertyCallbackInfo<v8::Value> &info);
+    static void getter_stats(
+        v8::Local<v8::String>,
+        const v8::PropertyCallbackInfo<v8::Value> &info);
 
     static void getter_is_blocking(
         v8::Local<v8::String>,
@@ -75,6 +210,21 @@ private:
     static void getter_is_ipv6(
         v8::Local<v8::String>,
         const v8::PropertyCallbackInfo<v8::Value> &info);
+    static void getter_is_counting_drops(
+        v8::Local<v8::String>,
+        const v8::PropertyCallbackInfo<v8::Value> &info);
+    static void getter_is_receive_offload(
+        v8::Local<v8::String>,
+        const v8::PropertyCallbackInfo<v8::Value> &info);
+    static void getter_is_tracking_latency(
+        v8::Local<v8::String>,
+        const v8::PropertyCallbackInfo<v8::Value> &info);
+    static void getter_is_timestamping(
+        v8::Local<v8::String>,
+        const v8::PropertyCallbackInfo<v8::Value> &info);
+    static void getter_is_zero_copy(
+        v8::Local<v8::String>,
+        const v8::PropertyCallbackInfo<v8::Value> &info);
 
     /* -- Setters -- */
     static void setter_throw_exception(
@@ -85,6 +235,26 @@ private:
         v8::Local<v8::String>,
         v8::Local<v8::Value> value,
         const v8::PropertyCallbackInfo<void> &info);
+    static void setter_is_counting_drops(
+        v8::Local<v8::String>,
+        v8::Local<v8::Value> value,
+        const v8::PropertyCallbackInfo<void> &info);
+    static void setter_is_receive_offload(
+        v8::Local<v8::String>,
+        v8::Local<v8::Value> value,
+        const v8::PropertyCallbackInfo<void> &info);
+    static void setter_is_tracking_latency(
+        v8::Local<v8::String>,
+        v8::Local<v8::Value> value,
+        const v8::PropertyCallbackInfo<void> &info);
+    static void setter_is_timestamping(
+        v8::Local<v8::String>,
+        v8::Local<v8::Value> value,
+        const v8::PropertyCallbackInfo<void> &info);
+    static void setter_is_zero_copy(
+        v8::Local<v8::String>,
+        v8::Local<v8::Value> value,
+        const v8::PropertyCallbackInfo<void> &info);
 };
 
 #endif
@@ -0,0 +1,102 @@
+#ifndef OPTION_PARSER_H
+#define OPTION_PARSER_H
+
+#include <nan.h>
+#include <node.h>
+#include <sstream>
+#include "get_value.h"
+
+class OptionParser
+{
+private:
+    bool valid = true;
+    const char *options_name;
+    v8::Local<v8::Object> options;
+
+    void invalidate(const char *option_name, std::string reason)
+    {
+        this->valid = false;
+
+        auto isolate = v8::Isolate::GetCurrent();
+        std::stringstream ss;
+
+        ss << "Option \"" << option_name << "\" of \""
+           << this->options_name << "\" " << reason;
+        auto error = Nan::New(ss.str()).ToLocalChecked();
+        isolate->ThrowException(v8::Exception::TypeError(error));
+    }
+
+public:
+    // options may be empty, when the optional argument was not passed
+    OptionParser(const char *options_name, v8::Local<v8::Object> options)
+    {
+        this->options_name = options_name;
+        this->options = options;
+    }
+
+    bool isInvalid()
+    {
+        return !this->valid;
+    }
+
+    template <typename T>
+    OptionParser &opt(
+        const char *option_name,
+        T &&value,
+        GetValue::SubType sub_type = GetValue::SubType::None)
+    {
+        return this->parse(option_name, value, sub_type, false);
+    }
+
+    template <typename T>
+    OptionParser &arg(
+        const char *option_name,
+        T &&value,
+        GetValue::SubType sub_type = GetValue::SubType::None)
+    {
+        return this->parse(option_name, value, sub_type, true);
+    }
+
+private:
+    template <typename T>
+    OptionParser &parse(
+        const char *option_name,
+        T &&value,
+        GetValue::SubType sub_type,
+        bool required)
+    {
+        if (!this->valid || this->options.IsEmpty())
+        {
+            return *this; // no reason to keep parsing
+        }
+
+        v8::Local<v8::Value> option;
+        if (!Nan::Get(this->options, Nan::New(option_name).ToLocalChecked()).ToLocal(&option))
+        {
+            // a getter threw, that exception is already pending
+            this->valid = false;
+            return *this;
+        }
+
+        if (option->IsUndefined())
+        {
+            if (required)
+            {
+                this->invalidate(option_name, "is required.");
+            }
+
+            return *this;
+        }
+
+        std::string error_message = GetValue::get_value<T>(value, option, sub_type);
+
+        if (error_message.length() > 0)
+        {
+            this->invalidate(option_name, error_message);
+        }
+
+        return *this;
+    }
+};
+
+#endif
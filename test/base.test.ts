@@ -1,4 +1,13 @@
-import { SocketBase } from "../lib";
+import {
+    disconnectAll,
+    dumpTrace,
+    getDiagnostics,
+    getLatency,
+    getStats,
+    resetLatency,
+    SocketBase,
+    TraceEvent,
+} from "../lib";
 import {
     badArg,
     BadConstructor,
@@ -86,12 +95,216 @@ describe("base functionality", function () {
                 }).to.throw();
             });
 
+            it("can get fd", function () {
+                expect(testing.netLink.fd).to.be.a("number");
+                expect(testing.netLink.fd).to.be.at.least(0);
+                testing.netLink.disconnect();
+                expect(testing.netLink.fd).to.equal(-1);
+            });
+
+            it("cannot set fd", function () {
+                expect(() => {
+                    testing.settableNetLink.fd = badArg();
+                }).to.throw();
+            });
+
+            it("can get stats", function () {
+                const stats = testing.netLink.stats;
+                expect(stats).to.have.all.keys(
+                    "bytesSent",
+                    "bytesReceived",
+                    "messagesSent",
+                    "messagesReceived",
+                    "syscalls",
+                    "wouldBlock",
+                    "partialSends",
+                    "accepts",
+                    "errors",
+                    "drops",
+                );
+                expect(stats.errors).to.equal(0);
+
+                testing.netLink.disconnect();
+                expect(testing.netLink.stats).to.deep.equal(stats);
+            });
+
+            it("cannot set stats", function () {
+                expect(() => {
+                    testing.settableNetLink.stats = badArg();
+                }).to.throw();
+            });
+
+            it("can getStats", function () {
+                const stats = getStats();
+                expect(stats.bytesSent).to.be.at.least(
+                    testing.netLink.stats.bytesSent,
+                );
+
+                const text = getStats("prometheus");
+                expect(text).to.include(
+                    "# TYPE netlinkwrapper_bytes_sent_total counter",
+                );
+                expect(text).to.match(/^netlinkwrapper_accepts_total \d+$/m);
+            });
+
+            it("cannot getStats in an invalid format", function () {
+                expect(() => getStats(badArg<"object">())).to.throw(TypeError);
+            });
+
+            it("can get memoryInfo", function () {
+                const memory = testing.netLink.memoryInfo();
+                if (process.platform !== "linux") {
+                    expect(memory).to.be.undefined;
+                    return;
+                }
+
+                expect(memory?.receiveBuffer).to.be.above(0);
+                expect(memory?.sendBuffer).to.be.above(0);
+            });
+
+            it("cannot get memoryInfo once disconnected", function () {
+                testing.netLink.disconnect();
+                expect(() => testing.netLink.memoryInfo()).to.throw();
+            });
+
+            it("can getDiagnostics", function () {
+                const diagnostics = getDiagnostics([testing.netLink]);
+                expect(diagnostics).to.have.length(1);
+                expect(diagnostics[0].stats).to.deep.equal(
+                    testing.netLink.stats,
+                );
+                if (process.platform === "linux") {
+                    expect(diagnostics[0].memory).to.deep.equal(
+                        testing.netLink.memoryInfo(),
+                    );
+                }
+
+                testing.netLink.disconnect();
+                expect(getDiagnostics([testing.netLink])[0]).to.have.all.keys(
+                    "stats",
+                );
+            });
+
+            it("cannot getDiagnostics of non sockets", function () {
+                expect(() => getDiagnostics(badArg())).to.throw(TypeError);
+                expect(() =>
+                    getDiagnostics([testing.netLink, badArg<SocketBase>()]),
+                ).to.throw(TypeError);
+            });
+
+            it("can dumpTrace", function () {
+                testing.netLink.disconnect("abort");
+
+                const events = JSON.parse(dumpTrace()) as TraceEvent[];
+                expect(events).to.have.length.within(1, 4096);
+                expect(events[events.length - 1]).to.deep.include({
+                    op: "disconnect",
+                    result: 1,
+                    error: 0,
+                });
+
+                const binary = dumpTrace("binary");
+                expect(binary.length).to.be.at.least(events.length * 24);
+                expect(binary.length % 24).to.equal(0);
+                expect(binary.readInt32LE(binary.length - 8)).to.equal(2);
+            });
+
+            it("cannot dumpTrace in an invalid format", function () {
+                expect(() => dumpTrace(badArg<"json">())).to.throw(TypeError);
+            });
+
+            it("does not track latency by default", function () {
+                expect(testing.netLink.isTrackingLatency).to.be.false;
+                expect(testing.netLink.latency).to.be.undefined;
+            });
+
+            it("can track latency", function () {
+                testing.netLink.isTrackingLatency = true;
+                expect(testing.netLink.isTrackingLatency).to.be.true;
+
+                const latency = testing.netLink.latency;
+                expect(latency).to.have.all.keys(
+                    "accept",
+                    "connect",
+                    "receive",
+                    "send",
+                );
+                expect(latency?.send).to.have.all.keys(
+                    "count",
+                    "meanNs",
+                    "p50Ns",
+                    "p99Ns",
+                    "p999Ns",
+                    "maxNs",
+                );
+
+                testing.netLink.isTrackingLatency = false;
+                expect(testing.netLink.latency).to.be.undefined;
+            });
+
+            it("cannot set isTrackingLatency to a non boolean", function () {
+                expect(() => {
+                    testing.settableNetLink.isTrackingLatency = badArg();
+                }).to.throw();
+            });
+
+            it("cannot set latency", function () {
+                expect(() => {
+                    testing.settableNetLink.latency = badArg();
+                }).to.throw();
+            });
+
+            it("can getLatency and resetLatency", function () {
+                const latency = getLatency();
+                expect(latency).to.have.all.keys(
+                    "accept",
+                    "connect",
+                    "receive",
+                    "send",
+                );
+                expect(latency.connect.p50Ns).to.be.at.most(
+                    latency.connect.maxNs,
+                );
+
+                resetLatency();
+                expect(getLatency().accept.count).to.equal(0);
+            });
+
             it("cannot disconnect after disconnecting", function () {
                 testing.netLink.disconnect();
                 expect(testing.netLink.isDestroyed).to.be.true;
                 expect(() => testing.netLink.disconnect()).to.throw();
             });
 
+            for (const mode of ["close", "abort", "graceful"] as const) {
+                it(`can disconnect with mode "${mode}"`, function () {
+                    testing.netLink.disconnect(mode, 250);
+                    expect(testing.netLink.isDestroyed).to.be.true;
+                });
+            }
+
+            it("cannot disconnect with an invalid mode", function () {
+                expect(() =>
+                    testing.netLink.disconnect(badArg<"abort">()),
+                ).to.throw(TypeError);
+                expect(testing.netLink.isDestroyed).to.be.false;
+            });
+
+            it("can disconnectAll", function () {
+                disconnectAll([testing.netLink, testing.netLink], "abort");
+                expect(testing.netLink.isDestroyed).to.be.true;
+
+                // already destroyed sockets are skipped
+                expect(() => disconnectAll([testing.netLink])).not.to.throw();
+            });
+
+            it("cannot disconnectAll what are not sockets", function () {
+                expect(() =>
+                    disconnectAll([testing.netLink, badArg()]),
+                ).to.throw(TypeError);
+                expect(testing.netLink.isDestroyed).to.be.false;
+            });
+
             it("can get isIPv4", function () {
                 expect(typeof testing.netLink.isIPv4).to.equal("boolean");
             });
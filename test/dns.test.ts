@@ -0,0 +1,90 @@
+import { expect } from "chai";
+import {
+    flushDNS,
+    prewarmDNS,
+    setDNSCacheTTL,
+    SocketClientTCP,
+    SocketUDP,
+} from "../lib";
+import { badArg, EchoClientTCP, getNextTestingPort } from "./utils";
+
+describe("DNS cache", function () {
+    afterEach(function () {
+        setDNSCacheTTL(30_000);
+        flushDNS();
+    });
+
+    it("can prewarm host names", function () {
+        const addresses = prewarmDNS("localhost", "IPv4");
+
+        expect(addresses).to.be.an("array");
+        expect(addresses).to.include("127.0.0.1");
+    });
+
+    it("can prewarm IP literals", function () {
+        expect(prewarmDNS("127.0.0.1")).to.deep.equal(["127.0.0.1"]);
+        expect(prewarmDNS("::1")).to.deep.equal(["::1"]);
+    });
+
+    it("throws when prewarming unknown hosts", function () {
+        expect(() => prewarmDNS("netlinkwrapper.invalid")).to.throw();
+    });
+
+    it("throws when prewarming without a host", function () {
+        expect(() => (prewarmDNS as () => void)()).to.throw(TypeError);
+    });
+
+    it("can flush hosts", function () {
+        prewarmDNS("localhost", "IPv4");
+
+        expect(() => flushDNS("localhost")).not.to.throw();
+        expect(() => flushDNS()).not.to.throw();
+    });
+
+    it("can set the cache TTL", function () {
+        expect(() => setDNSCacheTTL(0)).not.to.throw();
+        expect(() => setDNSCacheTTL(1_000)).not.to.throw();
+    });
+
+    it("throws on invalid cache TTLs", function () {
+        const notANumber = badArg<number>();
+
+        expect(() => setDNSCacheTTL(-1)).to.throw(TypeError);
+        expect(() => setDNSCacheTTL(notANumber)).to.throw(TypeError);
+    });
+
+    for (const ttl of [0, 30_000]) {
+        describe(`with a cache TTL of ${ttl}`, function () {
+            beforeEach(function () {
+                setDNSCacheTTL(ttl);
+            });
+
+            it("connects repeatedly to the same host", async function () {
+                const echoServer = new EchoClientTCP();
+                const port = getNextTestingPort();
+                await echoServer.start({ port });
+
+                for (let i = 0; i < 5; i++) {
+                    const client = new SocketClientTCP(port, "localhost");
+                    expect(client.hostTo).to.equal("localhost");
+                    client.disconnect();
+                }
+
+                await echoServer.stop();
+            });
+
+            it("sends repeatedly to the same host", function () {
+                const udp = new SocketUDP();
+                const port = getNextTestingPort();
+
+                for (let i = 0; i < 5; i++) {
+                    expect(() =>
+                        udp.sendTo("localhost", port, "cached"),
+                    ).not.to.throw();
+                }
+
+                udp.disconnect();
+            });
+        });
+    }
+});
@@ -9,6 +9,10 @@ describe("module", function () {
         expect(module.SocketUDP).to.exist;
     });
 
+    it("exports the WOULD_BLOCK sentinel", function () {
+        expect(typeof module.WOULD_BLOCK).to.equal("symbol");
+    });
+
     it("cannot be constructed as a base class.", function () {
         expect(() => {
             new (module.SocketBase as {
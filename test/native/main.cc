@@ -0,0 +1,36 @@
+// Runs the native test suites, for what the JS API can not reach or observe.
+//
+// build: node-gyp rebuild --nl_tests=true
+// usage: build/Release/netlink_tests
+
+#include <iostream>
+#include "netlink/exception.h"
+#include "tests.h"
+
+unsigned failures = 0;
+
+void check(bool passed, const std::string &what)
+{
+    std::cout << (passed ? "ok - " : "not ok - ") << what << std::endl;
+    failures += passed ? 0 : 1;
+}
+
+void run(void (*suite)(), const std::string &name)
+{
+    try
+    {
+        suite();
+    }
+    catch (NL::Exception &err)
+    {
+        check(false, name + ": unexpected exception: " + err.msg());
+    }
+}
+
+int main()
+{
+    run(resolver_tests, "resolver");
+    run(socket_group_tests, "socket group");
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,69 @@
+// Tests of the NL::Resolver cache, which the JS API can only flush and
+// configure: lookups() counts the getaddrinfo() calls the cache avoids.
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "netlink/resolver.h"
+#include "tests.h"
+
+// getaddrinfo() takes 127.0.0.1 as a number, without asking DNS, but it is not
+// an IP literal to the resolver, so it is cached as host names are
+const unsigned long long LOOPBACK_NUMBER = 2130706433;
+
+std::string loopback_name(size_t index)
+{
+    return std::to_string(LOOPBACK_NUMBER + index);
+}
+
+// the getaddrinfo() calls resolving host takes
+unsigned long long lookups_of(const std::string &host)
+{
+    std::vector<NL::Address> addresses;
+    auto before = NL::Resolver::lookups();
+    NL::Resolver::resolve(host, 80, NL::TCP, NL::ANY, false, addresses);
+
+    return NL::Resolver::lookups() - before;
+}
+
+void resolver_tests()
+{
+    NL::Resolver::ttl(DEFAULT_RESOLVER_TTL);
+    NL::Resolver::flush();
+
+    check(lookups_of("localhost") == 1, "resolver: resolves hosts not cached");
+    check(lookups_of("localhost") == 0, "resolver: serves the second lookup from the cache");
+    check(lookups_of("127.0.0.1") == 0, "resolver: converts IP literals without resolving them");
+
+    check(lookups_of(loopback_name(0)) == 1, "resolver: caches each host on its own");
+    NL::Resolver::flush("localhost");
+    check(lookups_of(loopback_name(0)) == 0, "resolver: keeps the other hosts on flush(host)");
+    check(lookups_of("localhost") == 1, "resolver: forgets the host on flush(host)");
+
+    NL::Resolver::flush();
+    check(lookups_of("localhost") == 1, "resolver: forgets every host on flush()");
+
+    NL::Resolver::ttl(0);
+    lookups_of("localhost");
+    check(lookups_of("localhost") == 1, "resolver: resolves again with a TTL of 0");
+
+    NL::Resolver::ttl(50);
+    lookups_of("localhost");
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    check(lookups_of("localhost") == 1, "resolver: resolves again once the TTL expires");
+
+    // one more than fit, all of the same length so the first is the smallest
+    NL::Resolver::ttl(DEFAULT_RESOLVER_TTL);
+    NL::Resolver::flush();
+    for (size_t i = 0; i <= DEFAULT_RESOLVER_CACHE_SIZE; i++)
+    {
+        lookups_of(loopback_name(i));
+    }
+    check(lookups_of(loopback_name(DEFAULT_RESOLVER_CACHE_SIZE)) == 0,
+          "resolver: keeps the newest host when full");
+    check(lookups_of(loopback_name(0)) == 1,
+          "resolver: evicts a host once DEFAULT_RESOLVER_CACHE_SIZE are cached");
+
+    NL::Resolver::flush();
+}
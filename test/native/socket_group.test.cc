@@ -0,0 +1,141 @@
+// Tests of NL::SocketGroup that the JS API can not reach, as listen() is not
+// exposed: which callbacks run when other callbacks change the group.
+
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "netlink/socket.h"
+#include "netlink/socket_group.h"
+#include "tests.h"
+
+#define HOST "127.0.0.1"
+#define PORT 40415
+
+struct Backend
+{
+    const char *name;
+    NL::GroupBackend backend;
+};
+
+const Backend backends[] = {
+    {"select", NL::GROUP_SELECT},
+    {"poll", NL::GROUP_POLL},
+};
+
+// the events of the callbacks, in order, such as "read B 2"
+class Recorder : public NL::SocketGroupCmd
+{
+public:
+    std::vector<std::string> &events;
+    std::vector<std::unique_ptr<NL::Socket>> &accepted;
+    const char *kind;
+    bool remove = false;        // removes the socket of the event from the group
+    NL::Socket *also = nullptr; // removes this one too, on the first event
+    NL::Socket *spare = nullptr; // and adds and removes this one then
+
+    Recorder(const char *kind, std::vector<std::string> &events,
+             std::vector<std::unique_ptr<NL::Socket>> &accepted)
+        : events(events), accepted(accepted), kind(kind)
+    {
+    }
+
+    std::string name(NL::Socket *socket)
+    {
+        for (size_t i = 0; i < accepted.size(); i++)
+        {
+            if (accepted[i].get() == socket)
+            {
+                return std::string(1, 'A' + i);
+            }
+        }
+
+        return "?";
+    }
+
+    void exec(NL::Socket *socket, NL::SocketGroup *group, void *reference)
+    {
+        std::ostringstream event;
+        event << kind << " " << name(socket);
+        if (std::strcmp(kind, "read") == 0)
+        {
+            char buffer[16];
+            event << " " << socket->read(buffer, sizeof(buffer));
+        }
+        events.push_back(event.str());
+
+        if (remove)
+        {
+            group->remove(socket);
+        }
+        if (also)
+        {
+            group->remove(also);
+            group->add(spare);
+            group->remove(spare);
+            also = nullptr;
+        }
+    }
+};
+
+// A's peer closes, B's peer sends 2 bytes and C stays idle, with A removed
+// from the group by the disconnect callback, and B too if remove_b, along
+// with D added and removed, which is not in the group
+void removal_during_listen(NL::Socket &server, const Backend &backend, bool remove_b)
+{
+    std::vector<std::unique_ptr<NL::Socket>> clients;
+    std::vector<std::unique_ptr<NL::Socket>> accepted;
+    for (int i = 0; i < 4; i++)
+    {
+        clients.emplace_back(new NL::Socket(HOST, PORT, NL::TCP, NL::IP4));
+        accepted.emplace_back(server.accept());
+    }
+
+    NL::SocketGroup group(backend.backend);
+    for (int i = 0; i < 3; i++)
+    {
+        group.add(accepted[i].get());
+    }
+
+    std::vector<std::string> events;
+    Recorder on_read("read", events, accepted);
+    Recorder on_disconnect("disconnect", events, accepted);
+    on_disconnect.remove = true;
+    on_disconnect.also = remove_b ? accepted[1].get() : nullptr;
+    on_disconnect.spare = accepted[3].get();
+    group.setCmdOnRead(&on_read);
+    group.setCmdOnDisconnect(&on_disconnect);
+
+    clients[0]->disconnect();
+    clients[1]->send("hi", 2);
+
+    // both are ready once this returns true, as loopback is immediate
+    for (int i = 0; i < 100 && events.size() < (remove_b ? 1u : 2u); i++)
+    {
+        group.listen(10);
+    }
+
+    std::string prefix = std::string(backend.name) + (remove_b ? ": removing a ready socket " : ": removing a socket ");
+    std::string expected = remove_b ? "disconnect A" : "disconnect A,read B 2";
+    std::string got;
+    for (auto &event : events)
+    {
+        got += (got.empty() ? "" : ",") + event;
+    }
+
+    check(got == expected, prefix + "calls back the others as they are (" + got + ")");
+    check(group.size() == (remove_b ? 1u : 2u) && group.get(group.size() - 1) == accepted[2].get(),
+          prefix + "keeps the idle one in the group");
+}
+
+void socket_group_tests()
+{
+    NL::Socket server(PORT, NL::TCP, NL::IP4, HOST);
+
+    for (const Backend &backend : backends)
+    {
+        removal_during_listen(server, backend, false);
+        removal_during_listen(server, backend, true);
+    }
+}
@@ -0,0 +1,14 @@
+// The native test suites, each reporting through check() in TAP-like lines.
+
+#ifndef NETLINK_TESTS_H
+#define NETLINK_TESTS_H
+
+#include <string>
+
+// prints the outcome of one test, which makes the run fail if not passed
+void check(bool passed, const std::string &what);
+
+void resolver_tests();
+void socket_group_tests();
+
+#endif
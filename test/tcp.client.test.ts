@@ -1,10 +1,19 @@
 import { expect } from "chai";
 import { Socket } from "net";
-import { SocketClientTCP } from "../lib";
+import {
+    getBindingProfile,
+    getDiagnostics,
+    getLatency,
+    resetBindingProfile,
+    setBindingProfiling,
+    SocketClientTCP,
+    SocketServerTCP,
+} from "../lib";
 import {
     badArg,
     BadConstructor,
     badIPAddress,
+    badIPv6Address,
     EchoClientTCP,
     getNextTestingPort,
     tcpClientTester,
@@ -23,6 +32,142 @@ describe("TCP Client", function () {
         }).to.throw(TypeError);
     });
 
+    it("should throw with invalid options", function () {
+        expect(() => {
+            new SocketClientTCP(12345, "localhost", "IPv4", badArg());
+        }).to.throw(TypeError);
+
+        expect(() => {
+            new SocketClientTCP(12345, "localhost", "IPv4", {
+                connectTimeoutMs: badArg(),
+            });
+        }).to.throw(TypeError);
+
+        expect(() => {
+            new SocketClientTCP(12345, "localhost", "IPv4", {
+                attemptDelayMs: -1,
+            });
+        }).to.throw(TypeError);
+
+        expect(() => {
+            new SocketClientTCP(12345, "localhost", "IPv4", {
+                hostFrom: [badArg()],
+            });
+        }).to.throw(TypeError);
+    });
+
+    it("should throw on invalid connectMany targets", function () {
+        expect(() => SocketClientTCP.connectMany(badArg())).to.throw(TypeError);
+        expect(() => SocketClientTCP.connectMany([badArg()])).to.throw(
+            TypeError,
+        );
+        expect(() =>
+            SocketClientTCP.connectMany([{ port: 12345, host: badArg() }]),
+        ).to.throw(TypeError);
+    });
+
+    it("cannot setBindingProfiling to non booleans", function () {
+        expect(() => setBindingProfiling(badArg())).to.throw(TypeError);
+    });
+
+    it("can connectMany to no targets", function () {
+        expect(SocketClientTCP.connectMany([])).to.deep.equal([]);
+    });
+
+    it("spreads connections over the hostFrom addresses", async function () {
+        if (process.platform !== "linux") {
+            // other platforms only configure 127.0.0.1 by default
+            this.skip();
+        }
+
+        const echoServer = new EchoClientTCP();
+        const port = getNextTestingPort();
+        await echoServer.start({ port });
+
+        const target = { port, host: "127.0.0.1" };
+        const results = SocketClientTCP.connectMany(
+            [target, target, target, target],
+            5_000,
+            { hostFrom: ["127.0.0.2", "127.0.0.3"] },
+        );
+
+        const hosts = new Set<string>();
+        for (const { socket, error } of results) {
+            expect(error).to.be.undefined;
+            hosts.add(socket?.hostFrom || "");
+            socket?.disconnect();
+        }
+
+        expect([...hosts].sort()).to.deep.equal(["127.0.0.2", "127.0.0.3"]);
+        await echoServer.stop();
+    });
+
+    it("keeps sendZeroCopy ids in step when a send fails part way", async function () {
+        if (process.platform !== "linux") {
+            // only Linux sends without copying
+            this.skip();
+        }
+
+        const port = getNextTestingPort();
+        const server = new SocketServerTCP(port, "127.0.0.1");
+        const client = new SocketClientTCP(port, "127.0.0.1");
+        const accepted = server.accept();
+        if (!accepted) {
+            throw new Error("accepted should exist");
+        }
+
+        client.isZeroCopy = true;
+        client.isBlocking = false;
+        accepted.isBlocking = false;
+
+        let received = 0;
+        const drain = () => {
+            const data = accepted.receive();
+            received += data ? data.length : 0;
+        };
+
+        // fill the socket until a send fails after part of it went out
+        const big = Buffer.alloc(1024 * 1024, 1);
+        let lastId = -1;
+        let partial = false;
+        for (let i = 0; i < 1_000 && !partial; i++) {
+            const sentBefore = client.stats.bytesSent;
+            try {
+                lastId = client.sendZeroCopy(big);
+            } catch {
+                partial = client.stats.bytesSent > sentBefore;
+                drain();
+            }
+        }
+        expect(partial).to.be.true;
+
+        while (received < client.stats.bytesSent) {
+            drain();
+        }
+
+        // the failed send took the id after lastId, and its notifications
+        client.isBlocking = true;
+        const finalId = client.sendZeroCopy(Buffer.alloc(128 * 1024, 1));
+        expect(finalId).to.equal(lastId + 2);
+        while (received < client.stats.bytesSent) {
+            drain();
+        }
+
+        const completed: number[] = [];
+        for (let i = 0; i < 100; i++) {
+            completed.push(...client.pollZeroCopy());
+            if (completed.indexOf(finalId) >= 0) {
+                break;
+            }
+            await new Promise((resolve) => setTimeout(resolve, 10));
+        }
+        expect(completed).to.include.members([lastId + 1, finalId]);
+
+        client.disconnect();
+        accepted.disconnect();
+        server.disconnect();
+    });
+
     tcpClientTester.permutations("standalone", ({ ipVersion }) => {
         it("can register as a TCP listener", async function () {
             const echoServer = new EchoClientTCP();
@@ -57,6 +202,113 @@ describe("TCP Client", function () {
                 () => new SocketClientTCP(1234, badIPAddress, ipVersion),
             ).to.throw();
         });
+
+        it("can connect with options", async function () {
+            const echoServer = new EchoClientTCP();
+            const port = getNextTestingPort();
+            await echoServer.start({ port });
+
+            const connected = echoServer.events.newConnection.once();
+            const tcp = new SocketClientTCP(port, "localhost", ipVersion, {
+                connectTimeoutMs: 5_000,
+                attemptDelayMs: 0,
+            });
+            void (await connected);
+
+            expect(tcp.isBlocking).to.be.true;
+            expect(tcp.portTo).to.equal(port);
+
+            tcp.disconnect();
+            await echoServer.stop();
+        });
+
+        it("can connectMany", async function () {
+            const echoServer = new EchoClientTCP();
+            const port = getNextTestingPort();
+            await echoServer.start({ port });
+
+            const target = { port, host: "localhost", ipVersion };
+            const results = SocketClientTCP.connectMany(
+                [target, target, target],
+                5_000,
+            );
+
+            expect(results).to.have.length(3);
+            for (const { socket, error } of results) {
+                expect(error).to.be.undefined;
+                expect(socket).to.be.an.instanceOf(SocketClientTCP);
+                expect(socket?.portTo).to.equal(port);
+                socket?.disconnect();
+            }
+
+            await echoServer.stop();
+        });
+
+        it("reports connectMany errors per target", async function () {
+            const echoServer = new EchoClientTCP();
+            const port = getNextTestingPort();
+            await echoServer.start({ port });
+
+            const [good, bad] = SocketClientTCP.connectMany(
+                [
+                    { port, host: "localhost", ipVersion },
+                    { port: 1234, host: badIPAddress, ipVersion },
+                ],
+                250,
+            );
+
+            expect(good.socket).to.be.an.instanceOf(SocketClientTCP);
+            expect(good.error).to.be.undefined;
+            expect(bad.socket).to.be.undefined;
+            expect(bad.error).to.be.an.instanceOf(Error);
+
+            good.socket?.disconnect();
+            await echoServer.stop();
+        });
+
+        it("can connect from a local address", async function () {
+            const echoServer = new EchoClientTCP();
+            const port = getNextTestingPort();
+            await echoServer.start({ port });
+
+            const hostFrom = ipVersion === "IPv6" ? "::1" : "127.0.0.1";
+            const connected = echoServer.events.newConnection.once();
+            const tcp = new SocketClientTCP(port, hostFrom, ipVersion, {
+                hostFrom,
+            });
+            const listener = await connected;
+
+            expect(tcp.hostFrom).to.equal(hostFrom);
+            expect(listener.remoteAddress).to.contain(hostFrom);
+
+            tcp.disconnect();
+            await echoServer.stop();
+        });
+
+        it("throws when the connect timeout expires", function () {
+            const connectTimeoutMs = 250;
+            const host = ipVersion === "IPv6" ? badIPv6Address : badIPAddress;
+            const started = Date.now();
+
+            let message = "";
+            try {
+                new SocketClientTCP(1234, host, ipVersion, {
+                    connectTimeoutMs,
+                });
+            } catch (err) {
+                message = String(err.message);
+            }
+            const elapsed = Date.now() - started;
+
+            expect(message).to.not.equal("");
+            if (!/timed out/.test(message)) {
+                // the route failed fast instead of dropping the SYNs
+                this.skip();
+            }
+            expect(message).to.match(/timed out/);
+            expect(elapsed).to.be.at.least(connectTimeoutMs);
+            expect(elapsed).to.be.below(10_000);
+        });
     });
 
     tcpClientTester.testPermutations((testing) => {
@@ -85,5 +337,289 @@ describe("TCP Client", function () {
                 testing.settableNetLink.portTo = badArg();
             }).to.throw();
         });
+
+        it("can get hostFrom", function () {
+            const { hostFrom } = testing.netLink;
+
+            expect(typeof hostFrom).to.equal("string");
+            expect(hostFrom).to.equal("");
+        });
+
+        it("cannot set hostFrom", function () {
+            expect(() => {
+                testing.settableNetLink.hostFrom = badArg();
+            }).to.throw();
+        });
+
+        it("has nothing buffered before fill", function () {
+            expect(testing.netLink.bufferedSize).to.equal(0);
+            expect(testing.netLink.peek().length).to.equal(0);
+            expect(testing.netLink.consume().length).to.equal(0);
+        });
+
+        it("can fill, peek, and consume", async function () {
+            const dataPromise = testing.echo.events.sentData.once();
+            testing.netLink.send(testing.str);
+            const sent = await dataPromise;
+
+            const read = testing.netLink.fill();
+            expect(read).to.equal(sent.buffer.length);
+            expect(testing.netLink.bufferedSize).to.equal(read);
+
+            expect(testing.netLink.peek().compare(sent.buffer)).to.equal(0);
+            expect(testing.netLink.peek(1).toString()).to.equal(
+                testing.str[0],
+            );
+
+            const first = testing.netLink.consume(1);
+            expect(first.toString()).to.equal(testing.str[0]);
+            expect(testing.netLink.bufferedSize).to.equal(read - 1);
+
+            // receive returns what is buffered first
+            const rest = testing.netLink.receive();
+            expect(rest?.toString()).to.equal(testing.str.slice(1));
+            expect(testing.netLink.bufferedSize).to.equal(0);
+        });
+
+        it("cannot peek or consume invalid sizes", function () {
+            expect(() => testing.netLink.peek(badArg())).to.throw();
+            expect(() => testing.netLink.consume(badArg())).to.throw();
+        });
+
+        it("can sendFrame and receiveFrame", async function () {
+            const dataPromise = testing.echo.events.sentData.once();
+            testing.netLink.sendFrame(testing.str);
+            const sent = await dataPromise;
+            expect(sent.buffer.length).to.equal(4 + testing.str.length);
+            expect(sent.buffer.readUInt32BE(0)).to.equal(testing.str.length);
+
+            const frame = testing.netLink.receiveFrame();
+            expect(frame?.toString()).to.equal(testing.str);
+            expect(testing.netLink.bufferedSize).to.equal(0);
+        });
+
+        it("can receiveFrames in one call", function () {
+            testing.netLink.setFrameFormat({
+                prefixBytes: 2,
+                littleEndian: true,
+            });
+            const messages = ["one", "", "three"];
+            for (const message of messages) {
+                testing.netLink.sendFrame(message);
+            }
+
+            let frames: Buffer[] = [];
+            while (frames.length < messages.length) {
+                frames = frames.concat(testing.netLink.receiveFrames());
+            }
+            expect(frames.map((frame) => frame.toString())).to.deep.equal(
+                messages,
+            );
+        });
+
+        it("can receiveUntil a delimiter", async function () {
+            const dataPromise = testing.echo.events.sentData.once();
+            testing.netLink.send("first\r\nsecond\r\nthi");
+            void (await dataPromise);
+
+            expect(testing.netLink.receiveUntil("\r\n")?.toString()).to.equal(
+                "first",
+            );
+
+            testing.netLink.isBlocking = false;
+            const records = testing.netLink.receiveAllUntil(
+                Buffer.from("\r\n"),
+            );
+            expect(records.map((record) => record.toString())).to.deep.equal([
+                "second",
+            ]);
+            expect(testing.netLink.receiveUntil("\r\n")).to.be.undefined;
+            expect(testing.netLink.peek().toString()).to.equal("thi");
+        });
+
+        it("cannot receiveUntil beyond maxBytes", async function () {
+            const dataPromise = testing.echo.events.sentData.once();
+            testing.netLink.send(testing.str);
+            void (await dataPromise);
+
+            expect(() => testing.netLink.receiveUntil("\n", 1)).to.throw(
+                Error,
+            );
+        });
+
+        it("cannot receiveUntil invalid delimiters", function () {
+            expect(() => testing.netLink.receiveUntil(badArg())).to.throw(
+                TypeError,
+            );
+            expect(() => testing.netLink.receiveUntil("")).to.throw(TypeError);
+            expect(() =>
+                testing.netLink.receiveAllUntil("\n", badArg()),
+            ).to.throw(TypeError);
+        });
+
+        it("cannot sendFrame beyond the frame format", function () {
+            testing.netLink.setFrameFormat({ maxFrameSize: 2 });
+            expect(() => testing.netLink.sendFrame(testing.str)).to.throw(
+                Error,
+            );
+        });
+
+        it("cannot setFrameFormat to invalid formats", function () {
+            expect(() => testing.netLink.setFrameFormat(badArg())).to.throw(
+                TypeError,
+            );
+            expect(() =>
+                testing.netLink.setFrameFormat({ prefixBytes: badArg() }),
+            ).to.throw(TypeError);
+            expect(() =>
+                testing.netLink.setFrameFormat({ littleEndian: badArg() }),
+            ).to.throw(TypeError);
+            expect(() => testing.netLink.receiveFrames(badArg())).to.throw(
+                TypeError,
+            );
+        });
+
+        it("cannot set bufferedSize", function () {
+            expect(() => {
+                testing.settableNetLink.bufferedSize = badArg();
+            }).to.throw();
+        });
+
+        it("can sendZeroCopy and poll the completions", async function () {
+            expect(testing.netLink.isZeroCopy).to.be.false;
+            testing.netLink.isZeroCopy = true;
+            expect(testing.netLink.isZeroCopy).to.equal(
+                process.platform === "linux",
+            );
+
+            const ids = [
+                testing.netLink.sendZeroCopy(Buffer.alloc(128 * 1024, 1)),
+                testing.netLink.sendZeroCopy(Buffer.from(testing.str)),
+            ];
+            expect(ids).to.deep.equal([0, 1]);
+
+            const completed: number[] = [];
+            for (let i = 0; i < 100 && completed.length < ids.length; i++) {
+                completed.push(...testing.netLink.pollZeroCopy());
+                await new Promise((resolve) => setTimeout(resolve, 10));
+            }
+            expect(completed.sort()).to.deep.equal(ids);
+            expect(testing.netLink.pollZeroCopy()).to.deep.equal([]);
+        });
+
+        it("cannot sendZeroCopy strings", function () {
+            expect(() =>
+                testing.netLink.sendZeroCopy(
+                    (testing.str as unknown) as Buffer,
+                ),
+            ).to.throw();
+        });
+
+        it("cannot set isZeroCopy to non booleans", function () {
+            expect(() => {
+                testing.settableNetLink.isZeroCopy = badArg();
+            }).to.throw();
+        });
+
+        it("counts what it sends and receives in stats", async function () {
+            const dataPromise = testing.echo.events.sentData.once();
+            testing.netLink.send(testing.str);
+            const sent = await dataPromise;
+
+            const received = testing.netLink.receive();
+            const stats = testing.netLink.stats;
+            expect(stats.bytesSent).to.equal(sent.buffer.length);
+            expect(stats.messagesSent).to.equal(1);
+            expect(stats.bytesReceived).to.equal(received?.length);
+            expect(stats.syscalls).to.be.at.least(2);
+        });
+
+        it("can get tcpInfo", async function () {
+            const dataPromise = testing.echo.events.sentData.once();
+            testing.netLink.send(testing.str);
+            void (await dataPromise);
+            testing.netLink.receive();
+
+            const info = testing.netLink.tcpInfo();
+            if (process.platform !== "linux") {
+                expect(info).to.be.undefined;
+                return;
+            }
+
+            expect(info?.state).to.equal(1); // established
+            expect(info?.rttUs).to.be.above(0);
+            expect(info?.sndCwnd).to.be.above(0);
+            const diagnostics = getDiagnostics([testing.netLink]);
+            expect(diagnostics[0].tcpInfo).to.have.all.keys(
+                Object.keys(info ?? {}),
+            );
+        });
+
+        it("records the latency of its calls when tracking", async function () {
+            testing.netLink.isTrackingLatency = true;
+            const dataPromise = testing.echo.events.sentData.once();
+            testing.netLink.send(testing.str);
+            void (await dataPromise);
+            testing.netLink.receive();
+
+            const latency = testing.netLink.latency;
+            expect(latency?.send.count).to.equal(1);
+            expect(latency?.receive.count).to.equal(1);
+            expect(latency?.receive.maxNs).to.be.above(0);
+            expect(latency?.receive.p99Ns).to.be.at.most(
+                latency?.receive.maxNs ?? 0,
+            );
+            expect(latency?.connect.count).to.equal(0);
+            expect(getLatency().send.count).to.be.at.least(1);
+        });
+
+        it("profiles the binding overhead of its calls", async function () {
+            resetBindingProfile();
+            setBindingProfiling(true);
+            const dataPromise = testing.echo.events.sentData.once();
+            testing.netLink.send(testing.str);
+            void (await dataPromise);
+            testing.netLink.receive();
+            setBindingProfiling(false);
+            testing.netLink.send(testing.str);
+
+            const profile = getBindingProfile();
+            expect(profile.send.calls).to.equal(1);
+            expect(profile.send.bytesCopied).to.be.at.least(
+                testing.str.length,
+            );
+            expect(profile.receive.calls).to.equal(1);
+            expect(profile.receive.allocations).to.equal(1);
+            expect(profile.receive.nativeNs).to.be.above(0);
+            expect(profile.trySend.calls).to.equal(0);
+
+            resetBindingProfile();
+            expect(getBindingProfile().send.calls).to.equal(0);
+        });
+
+        it("can receiveTimestamped", async function () {
+            expect(testing.netLink.isTimestamping).to.be.false;
+            testing.netLink.isTimestamping = true;
+            expect(testing.netLink.isTimestamping).to.equal(
+                process.platform !== "win32",
+            );
+
+            const dataPromise = testing.echo.events.sentData.once();
+            testing.netLink.send(testing.str);
+            void (await dataPromise);
+
+            const read = testing.netLink.receiveTimestamped();
+            expect(read?.data.toString()).to.equal(testing.str);
+            if (process.platform !== "win32") {
+                expect(Number(read?.arrivalNs)).to.be.above(0);
+                expect(read?.queuedNs).to.be.at.least(0);
+            }
+        });
+
+        it("cannot set isTimestamping to non booleans", function () {
+            expect(() => {
+                testing.settableNetLink.isTimestamping = badArg();
+            }).to.throw();
+        });
     });
 });
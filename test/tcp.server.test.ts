@@ -1,6 +1,6 @@
 import { expect } from "chai";
 import { badArg, BadConstructor, tcpServerTester } from "./utils";
-import { SocketClientTCP, SocketServerTCP } from "../lib";
+import { SocketClientTCP, SocketServerTCP, WOULD_BLOCK } from "../lib";
 
 describe("TCP Server", function () {
     it("should throw without a port passed", function () {
@@ -99,5 +99,40 @@ describe("TCP Server", function () {
 
             client?.disconnect();
         });
+
+        it("can tryAccept until WOULD_BLOCK", function () {
+            testing.netLink.isBlocking = false;
+
+            const client = testing.netLink.tryAccept();
+            expect(client).to.be.an.instanceOf(SocketClientTCP);
+
+            expect(testing.netLink.tryAccept()).to.equal(WOULD_BLOCK);
+
+            if (client instanceof SocketClientTCP) {
+                client.disconnect();
+            }
+        });
+
+        it("can trySend and tryReceive with the client", async function () {
+            const client = testing.netLink.tryAccept();
+            if (!(client instanceof SocketClientTCP)) {
+                throw new Error("client should exist");
+            }
+
+            const sentData = testing.echo.events.sentData.once();
+            client.isBlocking = false;
+            expect(client.tryReceive()).to.equal(WOULD_BLOCK);
+            expect(client.trySend(testing.str)).to.equal(
+                Buffer.byteLength(testing.str),
+            );
+            const sent = await sentData;
+            expect(sent.str).to.equal(testing.str);
+
+            client.isBlocking = true;
+            const echoed = client.tryReceive();
+            expect(echoed?.toString()).to.equal(testing.str);
+
+            client.disconnect();
+        });
     });
 });
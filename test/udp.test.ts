@@ -1,6 +1,7 @@
 import { TextEncoder } from "util";
 import { expect } from "chai";
-import { udpTester, getNextTestingPort } from "./utils";
+import { badArg, udpTester, getNextTestingPort } from "./utils";
+import { SocketUDP, WOULD_BLOCK } from "../lib";
 
 describe("UDP specific tests", function () {
     udpTester.testPermutations((testing) => {
@@ -66,6 +67,276 @@ describe("UDP specific tests", function () {
             expect(sent.str).to.equal(testing.str);
         });
 
+        it("can trySendTo other UDP sockets", async function () {
+            const sentPromise = testing.echo.events.sentData.once();
+            testing.netLink.isBlocking = false;
+            const sentBytes = testing.netLink.trySendTo(
+                testing.host,
+                testing.echo.getPort(),
+                testing.str,
+            );
+            expect(sentBytes).not.to.equal(WOULD_BLOCK);
+            expect(sentBytes).to.equal(Buffer.byteLength(testing.str));
+
+            const sent = await sentPromise;
+            expect(sent.str).to.equal(testing.str);
+        });
+
+        it("cannot send before connecting", function () {
+            expect(() => testing.netLink.send(testing.str)).to.throw();
+            expect(testing.netLink.hostTo).to.equal("");
+            expect(testing.netLink.portTo).to.equal(0);
+        });
+
+        it("can connect, send, and receive", async function () {
+            testing.netLink.connect(testing.host, testing.echo.getPort());
+            expect(testing.netLink.portTo).to.equal(testing.echo.getPort());
+            const isIPv4 = testing.ipVersion === "IPv4";
+            expect(testing.netLink.hostTo).to.equal(isIPv4 ? "127.0.0.1" : "::1");
+
+            const sentPromise = testing.echo.events.sentData.once();
+            testing.netLink.send(testing.str);
+            const sent = await sentPromise;
+            expect(sent.from.port).to.equal(testing.netLink.portFrom);
+
+            expect(testing.netLink.receive()?.toString()).to.equal(testing.str);
+        });
+
+        it("can trySend and tryReceive when connected", async function () {
+            testing.netLink.connect(testing.host, testing.echo.getPort());
+            testing.netLink.isBlocking = false;
+            expect(testing.netLink.tryReceive()).to.equal(WOULD_BLOCK);
+
+            const sentPromise = testing.echo.events.sentData.once();
+            const sentBytes = testing.netLink.trySend(testing.str);
+            expect(sentBytes).to.equal(Buffer.byteLength(testing.str));
+            void (await sentPromise);
+
+            const read = testing.netLink.tryReceive();
+            expect(read).to.be.instanceOf(Buffer);
+            expect((read as Buffer).toString()).to.equal(testing.str);
+        });
+
+        it("drops datagrams from other sources once connected", function () {
+            testing.netLink.connect(testing.host, testing.echo.getPort());
+            const other = new SocketUDP(
+                getNextTestingPort(),
+                testing.host,
+                testing.ipVersion,
+            );
+
+            other.sendTo(testing.host, testing.netLink.portFrom, testing.str);
+            testing.netLink.isBlocking = false;
+            expect(testing.netLink.receive()).to.be.undefined;
+
+            other.disconnect();
+        });
+
+        it("can receiveFrom datagrams bigger than 255 bytes", function () {
+            const other = new SocketUDP(
+                getNextTestingPort(),
+                testing.host,
+                testing.ipVersion,
+            );
+            const data = Buffer.alloc(4000, "big");
+
+            other.sendTo(testing.host, testing.netLink.portFrom, data);
+            other.sendTo(testing.host, testing.netLink.portFrom, "small");
+            expect(testing.netLink.receiveFrom()?.data.equals(data)).to.be.true;
+            expect(testing.netLink.receiveFrom()?.data.toString()).to.equal(
+                "small",
+            );
+
+            other.disconnect();
+        });
+
+        it("can sendSegmentsTo as many datagrams", function () {
+            const other = new SocketUDP(
+                getNextTestingPort(),
+                testing.host,
+                testing.ipVersion,
+            );
+            const data = Buffer.alloc(2500, testing.str);
+
+            testing.netLink.sendSegmentsTo(
+                testing.host,
+                other.portFrom,
+                data,
+                1000,
+            );
+            const sizes = [1, 2, 3].map(
+                () => other.receiveFrom()?.data.length,
+            );
+            expect(sizes).to.deep.equal([1000, 1000, 500]);
+
+            testing.netLink.connect(testing.host, other.portFrom);
+            testing.netLink.sendSegments(data, 2000);
+            expect(other.receiveFrom()?.data.length).to.equal(2000);
+            expect(other.receiveFrom()?.data.length).to.equal(500);
+
+            other.disconnect();
+        });
+
+        it("can receiveSegments coalesced", function () {
+            const other = new SocketUDP(
+                getNextTestingPort(),
+                testing.host,
+                testing.ipVersion,
+            );
+            const data = Buffer.alloc(2500, testing.str);
+
+            testing.netLink.isReceiveOffload = true;
+            other.sendSegmentsTo(
+                testing.host,
+                testing.netLink.portFrom,
+                data,
+                1000,
+            );
+
+            testing.netLink.isBlocking = false;
+            const reads = [];
+            for (
+                let read = testing.netLink.receiveSegments();
+                read;
+                read = testing.netLink.receiveSegments()
+            ) {
+                expect(read.port).to.equal(other.portFrom);
+                reads.push(read);
+            }
+
+            const received = Buffer.concat(reads.map((read) => read.data));
+            expect(received.equals(data)).to.be.true;
+            expect(reads[0].segmentSize).to.equal(1000);
+            if (process.platform === "linux") {
+                expect(testing.netLink.isReceiveOffload).to.be.true;
+            }
+
+            other.disconnect();
+        });
+
+        it("can receiveSegments with arrival timestamps", function () {
+            const other = new SocketUDP(
+                getNextTestingPort(),
+                testing.host,
+                testing.ipVersion,
+            );
+            const data = Buffer.alloc(2500, testing.str);
+
+            // all their control data has to fit along with the datagram size
+            testing.netLink.isReceiveOffload = true;
+            testing.netLink.isTimestamping = true;
+            testing.netLink.isCountingDrops = true;
+            other.sendSegmentsTo(
+                testing.host,
+                testing.netLink.portFrom,
+                data,
+                1000,
+            );
+
+            testing.netLink.isBlocking = false;
+            const reads = [];
+            for (
+                let read = testing.netLink.receiveSegments();
+                read;
+                read = testing.netLink.receiveSegments()
+            ) {
+                reads.push(read);
+            }
+
+            const received = Buffer.concat(reads.map((read) => read.data));
+            expect(received.equals(data)).to.be.true;
+            expect(reads[0].segmentSize).to.equal(1000);
+
+            other.disconnect();
+        });
+
+        it("can receiveFrom with arrival timestamps", function () {
+            const other = new SocketUDP(
+                getNextTestingPort(),
+                testing.host,
+                testing.ipVersion,
+            );
+
+            other.sendTo(testing.host, testing.netLink.portFrom, testing.str);
+            expect(testing.netLink.receiveFrom()?.arrivalNs).to.be.undefined;
+
+            testing.netLink.isTimestamping = true;
+            other.sendTo(testing.host, testing.netLink.portFrom, testing.str);
+            const read = testing.netLink.receiveFrom();
+            expect(read?.data.toString()).to.equal(testing.str);
+            if (process.platform !== "win32") {
+                expect(testing.netLink.isTimestamping).to.be.true;
+                expect(typeof read?.arrivalNs).to.equal("bigint");
+                expect(read?.queuedNs).to.be.at.least(0);
+            }
+
+            other.connect(testing.host, testing.netLink.portFrom);
+            testing.netLink.connect(testing.host, other.portFrom);
+            other.send(testing.str);
+            const timestamped = testing.netLink.receiveTimestamped();
+            expect(timestamped?.data.toString()).to.equal(testing.str);
+            if (process.platform !== "win32") {
+                expect(Number(timestamped?.arrivalNs)).to.be.above(0);
+            }
+
+            testing.netLink.isBlocking = false;
+            expect(testing.netLink.receiveTimestamped()).to.be.undefined;
+
+            other.disconnect();
+        });
+
+        it("counts the datagrams dropped when isCountingDrops", function () {
+            const other = new SocketUDP(
+                getNextTestingPort(),
+                testing.host,
+                testing.ipVersion,
+            );
+            const data = Buffer.alloc(30000);
+
+            testing.netLink.isCountingDrops = true;
+            // more than the receive buffer holds
+            for (let i = 0; i < 100; i++) {
+                other.sendTo(testing.host, testing.netLink.portFrom, data);
+            }
+
+            testing.netLink.isBlocking = false;
+            while (testing.netLink.receiveFrom()) {
+                // the datagrams that fit were queued before any drop
+            }
+            other.sendTo(testing.host, testing.netLink.portFrom, "after");
+            expect(testing.netLink.receiveFrom()?.data.toString()).to.equal(
+                "after",
+            );
+
+            if (process.platform === "linux") {
+                expect(testing.netLink.isCountingDrops).to.be.true;
+                expect(testing.netLink.stats.drops).to.be.above(0);
+                expect(testing.netLink.memoryInfo()?.drops).to.equal(
+                    testing.netLink.stats.drops,
+                );
+            }
+
+            other.disconnect();
+        });
+
+        it("cannot set isCountingDrops to non booleans", function () {
+            expect(() => {
+                testing.settableNetLink.isCountingDrops = badArg();
+            }).to.throw();
+        });
+
+        it("cannot set isTimestamping to non booleans", function () {
+            expect(() => {
+                testing.settableNetLink.isTimestamping = badArg();
+            }).to.throw();
+        });
+
+        it("cannot set isReceiveOffload to non booleans", function () {
+            expect(() => {
+                testing.settableNetLink.isReceiveOffload = badArg();
+            }).to.throw();
+        });
+
         it("can sendTo nothing", function () {
             expect(() =>
                 testing.netLink.sendTo(
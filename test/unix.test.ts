@@ -0,0 +1,248 @@
+import { expect } from "chai";
+import { existsSync } from "fs";
+import { createServer } from "net";
+import { tmpdir } from "os";
+import { join } from "path";
+import {
+    SocketBase,
+    SocketClientTCP,
+    SocketClientUnix,
+    SocketServerTCP,
+    SocketServerUnix,
+    SocketUnixDatagram,
+    WOULD_BLOCK,
+} from "../lib";
+import { badArg, getNextTestingPort } from "./utils";
+
+let nextPath = 0;
+const getNextTestingPath = () =>
+    join(tmpdir(), `netlinkwrapper-test-${process.pid}-${nextPath++}.sock`);
+
+(process.platform === "win32" ? describe.skip : describe)(
+    "Unix sockets",
+    function () {
+        it("should throw without a path passed", function () {
+            expect(() => new SocketServerUnix(badArg())).to.throw();
+            expect(() => new SocketClientUnix(badArg())).to.throw();
+        });
+
+        it("throws when no server listens on the path", function () {
+            expect(() => new SocketClientUnix(getNextTestingPath())).to.throw();
+        });
+
+        it("can connect, send, and receive", function () {
+            const path = getNextTestingPath();
+            const server = new SocketServerUnix(path);
+            expect(server).to.be.instanceOf(SocketBase);
+            expect(server.path).to.equal(path);
+
+            const client = new SocketClientUnix(path);
+            expect(client.path).to.equal(path);
+            const accepted = server.accept();
+            expect(accepted).to.be.instanceOf(SocketClientUnix);
+
+            client.send("hello");
+            expect(accepted?.receive()?.toString()).to.equal("hello");
+            accepted?.send(Buffer.from("world"));
+            expect(client.receive()?.toString()).to.equal("world");
+
+            client.disconnect();
+            accepted?.disconnect();
+            server.disconnect();
+        });
+
+        it("removes the socket file on disconnect", function () {
+            const path = getNextTestingPath();
+            const server = new SocketServerUnix(path);
+            expect(existsSync(path)).to.be.true;
+
+            server.disconnect();
+            expect(existsSync(path)).to.be.false;
+        });
+
+        it("can tryAccept and tryReceive when not blocking", function () {
+            const path = getNextTestingPath();
+            const server = new SocketServerUnix(path);
+            server.isBlocking = false;
+            expect(server.tryAccept()).to.equal(WOULD_BLOCK);
+
+            const client = new SocketClientUnix(path);
+            const accepted = server.tryAccept();
+            if (!(accepted instanceof SocketClientUnix)) {
+                throw new Error("accepted should exist");
+            }
+
+            accepted.isBlocking = false;
+            expect(accepted.tryReceive()).to.equal(WOULD_BLOCK);
+            client.disconnect();
+            expect(accepted.tryReceive()).to.be.undefined;
+
+            accepted.disconnect();
+            server.disconnect();
+        });
+
+        it("can connect to a net server", async function () {
+            const path = getNextTestingPath();
+            const received = new Promise<string>((resolve) => {
+                const server = createServer((socket) => {
+                    socket.once("data", (data) => {
+                        resolve(data.toString());
+                        socket.end();
+                        server.close();
+                    });
+                });
+                server.listen(path);
+            });
+            await new Promise((resolve) => setTimeout(resolve, 50));
+
+            const client = new SocketClientUnix(path);
+            client.send("from netlinkwrapper");
+            expect(await received).to.equal("from netlinkwrapper");
+            client.disconnect();
+        });
+
+        if (process.platform === "linux") {
+            it("can use abstract names", function () {
+                const server = new SocketServerUnix(`@${getNextTestingPath()}`);
+                const client = new SocketClientUnix(server.path);
+                const accepted = server.accept();
+
+                client.send("abstract");
+                expect(accepted?.receive()?.toString()).to.equal("abstract");
+
+                client.disconnect();
+                accepted?.disconnect();
+                server.disconnect();
+            });
+        }
+
+        it("can create pairs", function () {
+            const [first, second] = SocketClientUnix.pair();
+            expect(first).to.be.instanceOf(SocketClientUnix);
+            expect(second).to.be.instanceOf(SocketClientUnix);
+
+            first.send("ping");
+            expect(second.receive()?.toString()).to.equal("ping");
+            second.send("pong");
+            expect(first.receive()?.toString()).to.equal("pong");
+
+            first.disconnect();
+            second.disconnect();
+        });
+
+        it("can pass connections with sendFd and receiveFd", function () {
+            const port = getNextTestingPort();
+            const server = new SocketServerTCP(port, "127.0.0.1");
+            const client = new SocketClientTCP(port, "127.0.0.1");
+            const accepted = server.accept();
+            if (!accepted) {
+                throw new Error("accepted should exist");
+            }
+
+            // sent before the hand over, so must not be lost by it
+            client.send("early");
+
+            const [sender, receiver] = SocketClientUnix.pair();
+            sender.sendFd(accepted);
+            expect(accepted.isDestroyed).to.be.true;
+
+            const fd = receiver.receiveFd();
+            expect(fd).to.be.a("number");
+            const adopted = SocketClientTCP.fromFd(fd as number);
+            expect(adopted.portFrom).to.equal(port);
+            expect(adopted.receive()?.toString()).to.equal("early");
+
+            adopted.send("adopted");
+            expect(client.receive()?.toString()).to.equal("adopted");
+
+            receiver.isBlocking = false;
+            expect(receiver.receiveFd()).to.be.undefined;
+
+            for (const socket of [adopted, client, server, sender, receiver]) {
+                socket.disconnect();
+            }
+        });
+
+        it("cannot sendFd sockets with data buffered by fill", function () {
+            const port = getNextTestingPort();
+            const server = new SocketServerTCP(port, "127.0.0.1");
+            const client = new SocketClientTCP(port, "127.0.0.1");
+            const accepted = server.accept();
+            if (!accepted) {
+                throw new Error("accepted should exist");
+            }
+
+            client.send("buffered");
+            expect(accepted.fill()).to.equal(8);
+
+            const [sender, receiver] = SocketClientUnix.pair();
+            expect(() => sender.sendFd(accepted)).to.throw(/buffered/);
+            expect(accepted.isDestroyed).to.be.false;
+
+            expect(accepted.consume().toString()).to.equal("buffered");
+            sender.sendFd(accepted);
+            expect(accepted.isDestroyed).to.be.true;
+
+            const fd = receiver.receiveFd();
+            const adopted = SocketClientTCP.fromFd(fd as number);
+            client.send("adopted");
+            expect(adopted.receive()?.toString()).to.equal("adopted");
+
+            for (const socket of [adopted, client, server, sender, receiver]) {
+                socket.disconnect();
+            }
+        });
+
+        it("cannot adopt fds of other kinds of sockets", function () {
+            const server = new SocketServerTCP(getNextTestingPort());
+
+            expect(() => SocketClientTCP.fromFd(server.fd)).to.throw();
+            expect(server.isDestroyed).to.be.false;
+            expect(() => SocketClientTCP.fromFd(badArg())).to.throw();
+
+            server.disconnect();
+        });
+
+        it("can sendTo and receiveFrom datagrams", function () {
+            const pathA = getNextTestingPath();
+            const pathB = getNextTestingPath();
+            const socketA = new SocketUnixDatagram(pathA);
+            const socketB = new SocketUnixDatagram(pathB);
+            expect(socketA.path).to.equal(pathA);
+
+            socketA.sendTo(pathB, "first");
+            expect(socketA.trySendTo(pathB, "second")).to.equal(6);
+
+            const first = socketB.receiveFrom();
+            expect(first?.path).to.equal(pathA);
+            expect(first?.data.toString()).to.equal("first");
+            expect(socketB.receiveFrom()?.data.toString()).to.equal("second");
+
+            socketB.isBlocking = false;
+            expect(socketB.receiveFrom()).to.be.undefined;
+
+            socketA.disconnect();
+            socketB.disconnect();
+        });
+
+        it("cannot sendTo paths no one is bound to", function () {
+            const socket = new SocketUnixDatagram(getNextTestingPath());
+
+            expect(() =>
+                socket.sendTo(getNextTestingPath(), "into the void"),
+            ).to.throw();
+
+            socket.disconnect();
+        });
+
+        it("cannot set path", function () {
+            const server = new SocketServerUnix(getNextTestingPath());
+
+            expect(() => {
+                (server as { path: unknown }).path = badArg();
+            }).to.throw();
+
+            server.disconnect();
+        });
+    },
+);
@@ -16,3 +16,4 @@ export type BadConstructor = {
 };
 
 export const badIPAddress = "192.0.2.0"; // invalid via RFC 5737
+export const badIPv6Address = "100::"; // discarded via RFC 6666